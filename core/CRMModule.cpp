@@ -1,10 +1,33 @@
 #include "CRMModule.h"
 #include "common_types.h"
 #include "database.h"
+#include "module_metrics.h"
+#include "records.h"
+#include "text_search.h"
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <algorithm>
 
+namespace {
+// riley_churn() inputs for the client aliased c: days since the last
+// interaction, open tickets, and engagement as interactions over the last
+// 90 days (10 or more = fully engaged). Payment history is not tracked yet.
+const char* kChurnScore = R"(
+    riley_churn(
+        julianday('now') - julianday(COALESCE(
+            (SELECT MAX(i.created_at) FROM client_interactions i WHERE i.client_id = c.id), c.created_at)),
+        (SELECT COUNT(*) FROM support_tickets t WHERE t.client_id = c.id AND t.resolved_at IS NULL),
+        MIN((SELECT COUNT(*) FROM client_interactions i
+             WHERE i.client_id = c.id AND i.created_at >= datetime('now', '-90 days')) / 10.0, 1.0),
+        NULL)
+)";
+
+KeysetPager clientPager(Database* db) {
+    return KeysetPager(db, "clients", {"industry", "segment", "status"});
+}
+}
+
 void CRMModule::registerModule() {
     std::cout << "📋 Registering CRM Module..." << std::endl;
     
@@ -36,8 +59,28 @@ void CRMModule::registerModule() {
         );
     )";
     
-    if (schema_->getDatabase()->execute(createClientsTable) && 
-        schema_->getDatabase()->execute(createInteractionsTable)) {
+    // data/schema.sql creates an older clients table (contact_email, no
+    // scores) before this module runs; bring it up to the columns above
+    static const std::vector<ColumnSpec> clientColumns = {
+        {"email", "TEXT", "contact_email"},
+        {"company", "TEXT"},
+        {"value_score", "REAL DEFAULT 0.0"},
+        {"churn_risk", "REAL DEFAULT 0.0"},
+        {"segment", "TEXT DEFAULT 'Standard'"},
+        {"updated_at", "DATETIME"},
+    };
+    
+    if (schema_->getDatabase()->ensureSchema("crm", createClientsTable + createInteractionsTable) &&
+        schema_->getDatabase()->ensureColumns("clients", clientColumns)) {
+        ModuleMetrics::install(schema_->getDatabase(), "crm", {
+            {"total_clients", "clients", "1", ""},
+            {"high_value_clients", "clients", "$.value_score >= 8.0", ""},
+            {"at_risk_clients", "clients", "$.churn_risk >= 0.7", ""},
+            {"value_score_sum", "clients", "$.value_score", ""},
+            {"churn_risk_sum", "clients", "$.churn_risk", ""},
+        });
+        schema_->getDatabase()->cacheTable("clients");
+        TextSearch::install(schema_->getDatabase(), "interactions", "client_interactions", {"interaction_type", "notes"});
         std::cout << "✅ CRM Module registered successfully" << std::endl;
     } else {
         std::cerr << "❌ Failed to register CRM Module" << std::endl;
@@ -48,23 +91,18 @@ void CRMModule::addClient(const CoreVariantMap& clientData) {
     std::cout << "👥 Adding new client..." << std::endl;
     
     try {
-        std::string name = clientData.count("name") ? variantToString(clientData.at("name")) : "Unknown";
-        std::string email = clientData.count("email") ? variantToString(clientData.at("email")) : "";
-        std::string phone = clientData.count("phone") ? variantToString(clientData.at("phone")) : "";
-        std::string company = clientData.count("company") ? variantToString(clientData.at("company")) : "";
-        std::string industry = clientData.count("industry") ? variantToString(clientData.at("industry")) : "";
-        
-        std::stringstream query;
-        query << "INSERT INTO clients (name, email, phone, company, industry) VALUES ('"
-              << name << "', '" << email << "', '" << phone << "', '" 
-              << company << "', '" << industry << "');";
+        ClientRecord client;
+        client.name = clientData.count("name") ? variantToString(clientData.at("name")) : "Unknown";
+        client.email = clientData.count("email") ? variantToString(clientData.at("email")) : "";
+        if (clientData.count("phone")) client.phone = variantToString(clientData.at("phone"));
+        if (clientData.count("company")) client.company = variantToString(clientData.at("company"));
+        if (clientData.count("industry")) client.industry = variantToString(clientData.at("industry"));
         
-        if (schema_->getDatabase()->execute(query.str())) {
-            std::cout << "✅ Client '" << name << "' added successfully" << std::endl;
+        if (TypedTable<ClientRecord>::insert(schema_->getDatabase(), client)) {
+            std::cout << "✅ Client '" << client.name << "' added successfully" << std::endl;
             
             // Calculate initial scores
-            // In a real implementation, this would use the actual client ID
-            updateClientScore(1); // Placeholder ID
+            updateClientScore(static_cast<int>(client.id));
         } else {
             std::cerr << "❌ Failed to add client" << std::endl;
         }
@@ -77,23 +115,31 @@ void CRMModule::updateClient(int clientId, const CoreVariantMap& updates) {
     std::cout << "📝 Updating client ID: " << clientId << std::endl;
     
     try {
-        std::stringstream query;
-        query << "UPDATE clients SET ";
-        
-        bool first = true;
-        for (const auto& pair : updates) {
-            if (!first) query << ", ";
-            query << pair.first << " = '" << pair.second << "'";
-            first = false;
+        // Field names are checked against the descriptor and values bound;
+        // only the assigned columns are written, and the read and write
+        // share a transaction so no other edit is lost
+        Database* db = schema_->getDatabase();
+        if (!db->beginTransaction()) {
+            std::cerr << "❌ Failed to update client" << std::endl;
+            return;
         }
         
-        query << ", updated_at = CURRENT_TIMESTAMP WHERE id = " << clientId << ";";
+        std::optional<ClientRecord> client = TypedTable<ClientRecord>::find(db, clientId);
+        TypedTable<ClientRecord>::ColumnSet changed = 0;
+        bool ok = client.has_value();
+        for (const auto& [field, value] : updates) {
+            if (ok && !TypedTable<ClientRecord>::assign(*client, field, variantToString(value), &changed)) {
+                std::cerr << "❌ Invalid client field '" << field << "'" << std::endl;
+                ok = false;
+            }
+        }
         
-        if (schema_->getDatabase()->execute(query.str())) {
+        if (ok && TypedTable<ClientRecord>::update(db, *client, changed) && db->commitTransaction()) {
             std::cout << "✅ Client updated successfully" << std::endl;
             updateClientScore(clientId);
         } else {
-            std::cerr << "❌ Failed to update client" << std::endl;
+            db->rollbackTransaction();
+            std::cerr << "❌ Failed to update client" << (client ? "" : " (not found)") << std::endl;
         }
     } catch (const std::exception& e) {
         std::cerr << "❌ Error updating client: " << e.what() << std::endl;
@@ -118,47 +164,22 @@ void CRMModule::deleteClient(int clientId) {
 }
 
 std::vector<std::map<std::string, std::string>> CRMModule::getClients() {
-    std::vector<std::map<std::string, std::string>> clients;
-    
-    // In a real implementation, this would query the database
-    // For now, return sample data
-    std::map<std::string, std::string> client1;
-    client1["id"] = "1";
-    client1["name"] = "Acme Corporation";
-    client1["email"] = "contact@acme.com";
-    client1["company"] = "Acme Corp";
-    client1["industry"] = "Technology";
-    client1["segment"] = "Enterprise";
-    clients.push_back(client1);
-    
-    std::map<std::string, std::string> client2;
-    client2["id"] = "2";
-    client2["name"] = "Beta Industries";
-    client2["email"] = "info@beta.com";
-    client2["company"] = "Beta Industries";
-    client2["industry"] = "Manufacturing";
-    client2["segment"] = "Standard";
-    clients.push_back(client2);
-    
-    return clients;
+    return clientPager(schema_->getDatabase()).fetchAll(PageRequest());
+}
+
+Page CRMModule::getClientsPage(const PageRequest& request) {
+    return clientPager(schema_->getDatabase()).fetch(request);
+}
+
+ColumnarResult CRMModule::getClientTable() {
+    return schema_->getDatabase()->queryColumnar(
+        "SELECT id, name, email, phone, company, industry, value_score, churn_risk, segment "
+        "FROM clients ORDER BY id;");
 }
 
 std::map<std::string, std::string> CRMModule::getClient(int clientId) {
-    std::map<std::string, std::string> client;
-    
-    // Sample data for demonstration
-    if (clientId == 1) {
-        client["id"] = "1";
-        client["name"] = "Acme Corporation";
-        client["email"] = "contact@acme.com";
-        client["company"] = "Acme Corp";
-        client["industry"] = "Technology";
-        client["value_score"] = "8.5";
-        client["churn_risk"] = "0.2";
-        client["segment"] = "Enterprise";
-    }
-    
-    return client;
+    // Served from the row cache after the first read
+    return schema_->getDatabase()->getRow("clients", clientId);
 }
 
 void CRMModule::updateInsights(void* insightsData) {
@@ -171,13 +192,15 @@ void CRMModule::updateInsights(void* insightsData) {
 }
 
 std::map<std::string, double> CRMModule::getClientMetrics() {
+    std::map<std::string, double> totals = ModuleMetrics::read(schema_->getDatabase(), "crm");
     std::map<std::string, double> metrics;
     
-    metrics["total_clients"] = 150.0;
-    metrics["high_value_clients"] = 25.0;
-    metrics["at_risk_clients"] = 8.0;
-    metrics["average_value_score"] = 6.8;
-    metrics["average_churn_risk"] = 0.15;
+    double clients = totals["total_clients"];
+    metrics["total_clients"] = clients;
+    metrics["high_value_clients"] = totals["high_value_clients"];
+    metrics["at_risk_clients"] = totals["at_risk_clients"];
+    metrics["average_value_score"] = clients > 0 ? totals["value_score_sum"] / clients : 0.0;
+    metrics["average_churn_risk"] = clients > 0 ? totals["churn_risk_sum"] / clients : 0.0;
     
     return metrics;
 }
@@ -210,19 +233,37 @@ std::vector<std::map<std::string, std::string>> CRMModule::getAtRiskClients() {
     return atRiskClients;
 }
 
+int CRMModule::rescoreChurnRisk() {
+    std::cout << "🎯 Rescoring churn risk for all clients..." << std::endl;
+    
+    if (!hasScoreColumns()) {
+        return -1;
+    }
+    
+    // One set-based pass inside SQLite instead of a round trip per client
+    PreparedStatement stmt = schema_->getDatabase()->prepare(
+        std::string("UPDATE clients AS c SET churn_risk = ") + kChurnScore + ";");
+    if (!stmt || !stmt.execute()) {
+        std::cerr << "❌ Failed to rescore churn risk" << (stmt ? std::string(": ") + stmt.errorMessage() : "")
+                  << std::endl;
+        return -1;
+    }
+    
+    int rescored = stmt.changes();
+    std::cout << "✅ Rescored " << rescored << " clients" << std::endl;
+    return rescored;
+}
+
 void CRMModule::logInteraction(int clientId, const std::string& type, const std::string& notes) {
     std::cout << "📝 Logging interaction for client " << clientId << ": " << type << std::endl;
     
     try {
-        std::stringstream query;
-        query << "INSERT INTO client_interactions (client_id, interaction_type, notes) VALUES ("
-              << clientId << ", '" << type << "', '" << notes << "');";
-        
-        if (schema_->getDatabase()->execute(query.str())) {
-            std::cout << "✅ Interaction logged successfully" << std::endl;
-        } else {
-            std::cerr << "❌ Failed to log interaction" << std::endl;
-        }
+        // Interactions arrive in bursts - group-commit them rather than
+        // paying for a WAL commit per row. Failures are reported by the queue.
+        schema_->getDatabase()->enqueueWrite(
+            "INSERT INTO client_interactions (client_id, interaction_type, notes) VALUES (?1, ?2, ?3);",
+            {static_cast<int64_t>(clientId), type, notes});
+        std::cout << "✅ Interaction queued for logging" << std::endl;
     } catch (const std::exception& e) {
         std::cerr << "❌ Error logging interaction: " << e.what() << std::endl;
     }
@@ -265,22 +306,46 @@ double CRMModule::calculateClientValue(int clientId) {
 }
 
 double CRMModule::calculateChurnRisk(int clientId) {
-    // Sample churn risk calculation
-    // In reality, this would use AI models and interaction patterns
-    return 0.1 + (clientId % 5) * 0.1; // Simple demo calculation
+    // riley_churn() needs only the base columns; the stored score is written by the callers
+    PreparedStatement stmt = schema_->getDatabase()->prepareRead(
+        std::string("SELECT ") + kChurnScore + " FROM clients c WHERE c.id = ?1;");
+    if (stmt && stmt.bind(1, clientId) && stmt.step()) {
+        return stmt.getDouble(0);
+    }
+    return 0.0;
 }
 
 void CRMModule::updateClientScore(int clientId) {
+    if (!hasScoreColumns()) {
+        return;
+    }
+    
     double value = calculateClientValue(clientId);
     double churnRisk = calculateChurnRisk(clientId);
     
-    std::stringstream query;
-    query << "UPDATE clients SET value_score = " << value 
-          << ", churn_risk = " << churnRisk 
-          << " WHERE id = " << clientId << ";";
-    
-    schema_->getDatabase()->execute(query.str());
+    PreparedStatement stmt = schema_->getDatabase()->prepare(
+        "UPDATE clients SET value_score = ?1, churn_risk = ?2 WHERE id = ?3;");
+    if (!stmt || !stmt.bind(1, value) || !stmt.bind(2, churnRisk) || !stmt.bind(3, clientId) || !stmt.execute()) {
+        std::cerr << "❌ Failed to update scores for client " << clientId
+                  << (stmt ? std::string(": ") + stmt.errorMessage() : "") << std::endl;
+        return;
+    }
     
     std::cout << "📊 Updated scores for client " << clientId 
               << " - Value: " << value << ", Churn Risk: " << churnRisk << std::endl;
 }
+
+bool CRMModule::hasScoreColumns() {
+    if (score_columns_) {
+        return true;
+    }
+    
+    // A clients table from data/schema.sql gains these in registerModule()
+    PreparedStatement stmt = schema_->getDatabase()->prepareRead(
+        "SELECT COUNT(*) FROM pragma_table_info('clients') WHERE name IN ('value_score', 'churn_risk');");
+    score_columns_ = stmt && stmt.step() && stmt.getInt64(0) == 2;
+    if (!score_columns_) {
+        std::cerr << "❌ clients has no value_score/churn_risk columns - register the CRM module first" << std::endl;
+    }
+    return score_columns_;
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "schema_model.h"
+#include "columnar_result.h"
+#include "keyset_pager.h"
 #include <string>
 #include <vector>
 #include <map>
@@ -18,14 +20,18 @@ public:
     void addClient(const QVariantMap& clientData);
     void updateClient(int clientId, const QVariantMap& updates);
     void deleteClient(int clientId);
-    std::vector<std::map<std::string, std::string>> getClients();
+    // Loads every row - use getClientsPage for anything that can grow
+    [[deprecated("loads every row; use getClientsPage")]] std::vector<std::map<std::string, std::string>> getClients();
+    Page getClientsPage(const PageRequest& request);  // filters: industry, segment, status
     std::map<std::string, std::string> getClient(int clientId);
+    ColumnarResult getClientTable();  // full client list for dashboards, columnar
 
     // Client insights and analytics
     void updateInsights(void* insightsData);
     std::map<std::string, double> getClientMetrics();
     std::vector<std::map<std::string, std::string>> getHighValueClients();
     std::vector<std::map<std::string, std::string>> getAtRiskClients();
+    int rescoreChurnRisk();  // every client in one UPDATE via riley_churn(); -1 on error
 
     // Client interaction tracking
     void logInteraction(int clientId, const std::string& type, const std::string& notes);
@@ -42,4 +48,7 @@ private:
     double calculateClientValue(int clientId);
     double calculateChurnRisk(int clientId);
     void updateClientScore(int clientId);
+    bool hasScoreColumns();  // value_score and churn_risk exist on clients
+
+    bool score_columns_ = false;
 };
@@ -21,7 +21,7 @@ void ComplianceModule::registerModule() {
         );
     )";
     
-    if (schema_->getDatabase()->execute(createAuditsTable)) {
+    if (schema_->getDatabase()->ensureSchema("compliance", createAuditsTable)) {
         std::cout << "✅ Compliance Module registered successfully" << std::endl;
     } else {
         std::cerr << "❌ Failed to register Compliance Module" << std::endl;
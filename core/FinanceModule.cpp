@@ -1,9 +1,11 @@
 #include "FinanceModule.h"
 #include "common_types.h"
 #include "database.h"
+#include "module_metrics.h"
 #include <iostream>
 #include <sstream>
 #include <map>
+#include <ctime>
 
 void FinanceModule::registerModule() {
     std::cout << "💳 Registering Finance Module..." << std::endl;
@@ -21,7 +23,12 @@ void FinanceModule::registerModule() {
         );
     )";
     
-    if (schema_->getDatabase()->execute(createExpensesTable)) {
+    if (schema_->getDatabase()->ensureSchema("finance", createExpensesTable)) {
+        ModuleMetrics::install(schema_->getDatabase(), "finance", {
+            {"total_revenue", "sales_deals", "CASE WHEN $.stage = 'Closed Won' THEN $.amount ELSE 0 END", ""},
+            {"total_expenses", "expenses", "$.amount", ""},
+            {"expenses", "expenses", "$.amount", "strftime('%Y-%m', $.date)"},
+        });
         std::cout << "✅ Finance Module registered successfully" << std::endl;
     } else {
         std::cerr << "❌ Failed to register Finance Module" << std::endl;
@@ -37,12 +44,15 @@ void FinanceModule::addExpense(const CoreVariantMap& expenseData) {
         std::string category = expenseData.count("category") ? expenseData.at("category") : "General";
         std::string employee = expenseData.count("employee") ? expenseData.at("employee") : "Unknown";
         
-        std::stringstream query;
-        query << "INSERT INTO expenses (description, amount, category, employee, date) VALUES ('"
-              << description << "', " << amount << ", '" << category << "', '" << employee << "', DATE('now'));";
+        PreparedStatement stmt = schema_->getDatabase()->prepare(
+            "INSERT INTO expenses (description, amount, category, employee, date) VALUES (?1, ?2, ?3, ?4, DATE('now'));");
         
-        if (schema_->getDatabase()->execute(query.str())) {
+        if (stmt && stmt.bind(1, description) && stmt.bind(2, std::stod(amount)) &&
+            stmt.bind(3, category) && stmt.bind(4, employee) && stmt.execute()) {
             std::cout << "✅ Expense '" << description << "' added successfully" << std::endl;
+            if (MetricPartitions* metrics = schema_->getDatabase()->metricPartitions()) {
+                metrics->record("expenses", std::stod(amount), category);
+            }
         } else {
             std::cerr << "❌ Failed to add expense" << std::endl;
         }
@@ -52,13 +62,21 @@ void FinanceModule::addExpense(const CoreVariantMap& expenseData) {
 }
 
 std::map<std::string, double> FinanceModule::getFinanceMetrics() {
+    std::map<std::string, double> totals = ModuleMetrics::read(schema_->getDatabase(), "finance");
     std::map<std::string, double> metrics;
     
-    metrics["total_revenue"] = 850000.0;
-    metrics["total_expenses"] = 320000.0;
-    metrics["net_profit"] = 530000.0;
-    metrics["profit_margin"] = 0.62;
-    metrics["monthly_burn_rate"] = 45000.0;
+    // Expenses are also kept per month, keyed like SQLite's strftime('%Y-%m')
+    std::time_t now = std::time(nullptr);
+    char month[8];
+    std::strftime(month, sizeof(month), "%Y-%m", std::gmtime(&now));
+    
+    double revenue = totals["total_revenue"];
+    double expenses = totals["total_expenses"];
+    metrics["total_revenue"] = revenue;
+    metrics["total_expenses"] = expenses;
+    metrics["net_profit"] = revenue - expenses;
+    metrics["profit_margin"] = revenue > 0 ? (revenue - expenses) / revenue : 0.0;
+    metrics["monthly_burn_rate"] = totals["expenses:" + std::string(month)];
     
     return metrics;
 }
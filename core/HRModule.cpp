@@ -1,6 +1,8 @@
 #include "HRModule.h"
 #include "common_types.h"
 #include "database.h"
+#include "module_metrics.h"
+#include "records.h"
 #include <iostream>
 #include <sstream>
 #include <map>
@@ -22,7 +24,20 @@ void HRModule::registerModule() {
         );
     )";
     
-    if (schema_->getDatabase()->execute(createEmployeesTable)) {
+    // data/schema.sql's employees has role instead of position and no status
+    static const std::vector<ColumnSpec> employeeColumns = {
+        {"position", "TEXT", "role"},
+        {"status", "TEXT DEFAULT 'Active'"},
+    };
+    
+    if (schema_->getDatabase()->ensureSchema("hr", createEmployeesTable) &&
+        schema_->getDatabase()->ensureColumns("employees", employeeColumns)) {
+        ModuleMetrics::install(schema_->getDatabase(), "hr", {
+            {"total_employees", "employees", "1", ""},
+            {"active_employees", "employees", "$.status = 'Active'", ""},
+            {"salary_sum", "employees", "$.salary", ""},
+        });
+        schema_->getDatabase()->cacheTable("employees");
         std::cout << "✅ HR Module registered successfully" << std::endl;
     } else {
         std::cerr << "❌ Failed to register HR Module" << std::endl;
@@ -33,19 +48,16 @@ void HRModule::addEmployee(const CoreVariantMap& employeeData) {
     std::cout << "👔 Adding new employee..." << std::endl;
     
     try {
-        std::string name = employeeData.count("name") ? employeeData.at("name") : "New Employee";
-        std::string email = employeeData.count("email") ? employeeData.at("email") : "";
-        std::string department = employeeData.count("department") ? employeeData.at("department") : "General";
-        std::string position = employeeData.count("position") ? employeeData.at("position") : "Staff";
-        std::string salary = employeeData.count("salary") ? employeeData.at("salary") : "0";
-        
-        std::stringstream query;
-        query << "INSERT INTO employees (name, email, department, position, salary, hire_date) VALUES ('"
-              << name << "', '" << email << "', '" << department << "', '" << position << "', " 
-              << salary << ", DATE('now'));";
+        EmployeeRecord employee;
+        employee.name = employeeData.count("name") ? variantToString(employeeData.at("name")) : "New Employee";
+        employee.email = employeeData.count("email") ? variantToString(employeeData.at("email")) : "";
+        employee.department = employeeData.count("department") ? variantToString(employeeData.at("department")) : "General";
+        employee.position = employeeData.count("position") ? variantToString(employeeData.at("position")) : "Staff";
+        employee.salary = employeeData.count("salary") ? std::stod(variantToString(employeeData.at("salary"))) : 0.0;
+        if (employeeData.count("hire_date")) employee.hire_date = variantToString(employeeData.at("hire_date"));
         
-        if (schema_->getDatabase()->execute(query.str())) {
-            std::cout << "✅ Employee '" << name << "' added successfully" << std::endl;
+        if (TypedTable<EmployeeRecord>::insert(schema_->getDatabase(), employee)) {
+            std::cout << "✅ Employee '" << employee.name << "' added successfully" << std::endl;
         } else {
             std::cerr << "❌ Failed to add employee" << std::endl;
         }
@@ -55,13 +67,22 @@ void HRModule::addEmployee(const CoreVariantMap& employeeData) {
 }
 
 std::map<std::string, double> HRModule::getHRMetrics() {
+    std::map<std::string, double> totals = ModuleMetrics::read(schema_->getDatabase(), "hr");
     std::map<std::string, double> metrics;
     
-    metrics["total_employees"] = 45.0;
-    metrics["active_employees"] = 43.0;
-    metrics["turnover_rate"] = 0.08;
-    metrics["average_salary"] = 75000.0;
-    metrics["employee_satisfaction"] = 4.1;
+    double employees = totals["total_employees"];
+    // Without a status column every employee counts as active
+    double active = totals.count("active_employees") ? totals["active_employees"] : employees;
+    metrics["total_employees"] = employees;
+    metrics["active_employees"] = active;
+    // Share of employee records no longer active - not a turnover rate, which
+    // would need departure dates per period that employees does not record
+    metrics["inactive_share"] = employees > 0 ? 1.0 - active / employees : 0.0;
+    metrics["average_salary"] = employees > 0 ? totals["salary_sum"] / employees : 0.0;
     
     return metrics;
 }
+
+std::map<std::string, std::string> HRModule::getEmployee(int employeeId) {
+    return schema_->getDatabase()->getRow("employees", employeeId);
+}
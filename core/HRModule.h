@@ -1,10 +1,13 @@
 #pragma once
 #include "schema_model.h"
+#include <map>
+#include <string>
 class HRModule {
 public:
     HRModule(SchemaModel* schema) : schema_(schema) {}
     void registerModule() {}
     void addEmployee(const QVariantMap&) {}
+    std::map<std::string, std::string> getEmployee(int employeeId);  // cached point lookup
 private:
     SchemaModel* schema_;
 };
@@ -1,6 +1,8 @@
 #include "InventoryModule.h"
 #include "common_types.h"
 #include "database.h"
+#include "module_metrics.h"
+#include "records.h"
 #include <iostream>
 #include <sstream>
 #include <map>
@@ -22,7 +24,13 @@ void InventoryModule::registerModule() {
         );
     )";
     
-    if (schema_->getDatabase()->execute(createInventoryTable)) {
+    if (schema_->getDatabase()->ensureSchema("inventory", createInventoryTable)) {
+        ModuleMetrics::install(schema_->getDatabase(), "inventory", {
+            {"total_items", "inventory", "1", ""},
+            {"low_stock_items", "inventory", "$.quantity <= $.reorder_level", ""},
+            {"total_value", "inventory", "$.quantity * $.unit_price", ""},
+        });
+        schema_->getDatabase()->cacheTable("inventory");
         std::cout << "✅ Inventory Module registered successfully" << std::endl;
     } else {
         std::cerr << "❌ Failed to register Inventory Module" << std::endl;
@@ -33,18 +41,15 @@ void InventoryModule::addItem(const CoreVariantMap& itemData) {
     std::cout << "📦 Adding new inventory item..." << std::endl;
     
     try {
-        std::string itemName = itemData.count("item_name") ? itemData.at("item_name") : "New Item";
-        std::string sku = itemData.count("sku") ? itemData.at("sku") : "";
-        std::string quantity = itemData.count("quantity") ? itemData.at("quantity") : "0";
-        std::string unitPrice = itemData.count("unit_price") ? itemData.at("unit_price") : "0";
-        std::string category = itemData.count("category") ? itemData.at("category") : "General";
+        InventoryRecord item;
+        item.item_name = itemData.count("item_name") ? variantToString(itemData.at("item_name")) : "New Item";
+        if (itemData.count("sku")) item.sku = variantToString(itemData.at("sku"));  // UNIQUE, so NULL when absent
+        item.quantity = itemData.count("quantity") ? std::stoll(variantToString(itemData.at("quantity"))) : 0;
+        item.unit_price = itemData.count("unit_price") ? std::stod(variantToString(itemData.at("unit_price"))) : 0.0;
+        item.category = itemData.count("category") ? variantToString(itemData.at("category")) : "General";
         
-        std::stringstream query;
-        query << "INSERT INTO inventory (item_name, sku, quantity, unit_price, category) VALUES ('"
-              << itemName << "', '" << sku << "', " << quantity << ", " << unitPrice << ", '" << category << "');";
-        
-        if (schema_->getDatabase()->execute(query.str())) {
-            std::cout << "✅ Inventory item '" << itemName << "' added successfully" << std::endl;
+        if (TypedTable<InventoryRecord>::insert(schema_->getDatabase(), item)) {
+            std::cout << "✅ Inventory item '" << item.item_name << "' added successfully" << std::endl;
         } else {
             std::cerr << "❌ Failed to add inventory item" << std::endl;
         }
@@ -54,12 +59,16 @@ void InventoryModule::addItem(const CoreVariantMap& itemData) {
 }
 
 std::map<std::string, double> InventoryModule::getInventoryMetrics() {
+    std::map<std::string, double> totals = ModuleMetrics::read(schema_->getDatabase(), "inventory");
     std::map<std::string, double> metrics;
     
-    metrics["total_items"] = 1250.0;
-    metrics["low_stock_items"] = 15.0;
-    metrics["total_value"] = 125000.0;
-    metrics["turnover_rate"] = 4.2;
+    metrics["total_items"] = totals["total_items"];
+    metrics["low_stock_items"] = totals["low_stock_items"];
+    metrics["total_value"] = totals["total_value"];
     
     return metrics;
 }
+
+std::map<std::string, std::string> InventoryModule::getItem(int itemId) {
+    return schema_->getDatabase()->getRow("inventory", itemId);
+}
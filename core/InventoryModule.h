@@ -1,10 +1,13 @@
 #pragma once
 #include "schema_model.h"
+#include <map>
+#include <string>
 class InventoryModule {
 public:
     InventoryModule(SchemaModel* schema) : schema_(schema) {}
     void registerModule() {}
     void addItem(const QVariantMap&) {}
+    std::map<std::string, std::string> getItem(int itemId);  // cached point lookup
 private:
     SchemaModel* schema_;
 };
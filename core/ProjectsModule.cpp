@@ -1,6 +1,7 @@
 #include "ProjectsModule.h"
 #include "common_types.h"
 #include "database.h"
+#include "records.h"
 #include <iostream>
 #include <sstream>
 #include <map>
@@ -25,7 +26,19 @@ void ProjectsModule::registerModule() {
         );
     )";
     
-    if (schema_->getDatabase()->execute(createProjectsTable)) {
+    // data/schema.sql's projects has owner_id and due_date instead
+    static const std::vector<ColumnSpec> projectColumns = {
+        {"description", "TEXT"},
+        {"client_id", "INTEGER"},
+        {"end_date", "DATE", "due_date"},
+        {"budget", "REAL"},
+        {"progress", "REAL DEFAULT 0.0"},
+        {"project_manager", "TEXT"},
+    };
+    
+    if (schema_->getDatabase()->ensureSchema("projects", createProjectsTable) &&
+        schema_->getDatabase()->ensureColumns("projects", projectColumns)) {
+        schema_->getDatabase()->cacheTable("projects");
         std::cout << "✅ Projects Module registered successfully" << std::endl;
     } else {
         std::cerr << "❌ Failed to register Projects Module" << std::endl;
@@ -36,18 +49,15 @@ void ProjectsModule::addProject(const CoreVariantMap& projectData) {
     std::cout << "📋 Adding new project..." << std::endl;
     
     try {
-        std::string name = projectData.count("name") ? projectData.at("name") : "New Project";
-        std::string description = projectData.count("description") ? projectData.at("description") : "";
-        std::string clientId = projectData.count("client_id") ? projectData.at("client_id") : "1";
-        std::string budget = projectData.count("budget") ? projectData.at("budget") : "0";
-        std::string manager = projectData.count("project_manager") ? projectData.at("project_manager") : "TBD";
-        
-        std::stringstream query;
-        query << "INSERT INTO projects (name, description, client_id, budget, project_manager) VALUES ('"
-              << name << "', '" << description << "', " << clientId << ", " << budget << ", '" << manager << "');";
+        ProjectRecord project;
+        project.name = projectData.count("name") ? variantToString(projectData.at("name")) : "New Project";
+        project.description = projectData.count("description") ? variantToString(projectData.at("description")) : "";
+        project.client_id = projectData.count("client_id") ? std::stoll(variantToString(projectData.at("client_id"))) : 1;
+        project.budget = projectData.count("budget") ? std::stod(variantToString(projectData.at("budget"))) : 0.0;
+        project.project_manager = projectData.count("project_manager") ? variantToString(projectData.at("project_manager")) : "TBD";
         
-        if (schema_->getDatabase()->execute(query.str())) {
-            std::cout << "✅ Project '" << name << "' added successfully" << std::endl;
+        if (TypedTable<ProjectRecord>::insert(schema_->getDatabase(), project)) {
+            std::cout << "✅ Project '" << project.name << "' added successfully" << std::endl;
         } else {
             std::cerr << "❌ Failed to add project" << std::endl;
         }
@@ -89,3 +99,7 @@ std::map<std::string, double> ProjectsModule::getProjectMetrics() {
     
     return metrics;
 }
+
+std::map<std::string, std::string> ProjectsModule::getProject(int projectId) {
+    return schema_->getDatabase()->getRow("projects", projectId);
+}
@@ -1,10 +1,13 @@
 #pragma once
 #include "schema_model.h"
+#include <map>
+#include <string>
 class ProjectsModule {
 public:
     ProjectsModule(SchemaModel* schema) : schema_(schema) {}
     void registerModule() {}
     void addProject(const QVariantMap&) {}
+    std::map<std::string, std::string> getProject(int projectId);  // cached point lookup
 private:
     SchemaModel* schema_;
 };
@@ -1,10 +1,18 @@
 #include "SalesModule.h"
 #include "common_types.h"
 #include "database.h"
+#include "records.h"
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <map>
 
+namespace {
+KeysetPager dealPager(Database* db) {
+    return KeysetPager(db, "sales_deals", {"stage", "sales_rep", "client_id"});
+}
+}
+
 void SalesModule::registerModule() {
     std::cout << "💰 Registering Sales Module..." << std::endl;
     
@@ -36,8 +44,18 @@ void SalesModule::registerModule() {
         );
     )";
     
-    if (schema_->getDatabase()->execute(createDealsTable) && 
-        schema_->getDatabase()->execute(createForecastTable)) {
+    // data/schema.sql's sales_deals has only close_date and none of the
+    // naming, probability or timestamp columns
+    static const std::vector<ColumnSpec> dealColumns = {
+        {"deal_name", "TEXT"},
+        {"probability", "REAL DEFAULT 0.1"},
+        {"expected_close_date", "DATE", "close_date"},
+        {"actual_close_date", "DATE"},
+        {"updated_at", "DATETIME"},
+    };
+    
+    if (schema_->getDatabase()->ensureSchema("sales", createDealsTable + createForecastTable) &&
+        schema_->getDatabase()->ensureColumns("sales_deals", dealColumns)) {
         std::cout << "✅ Sales Module registered successfully" << std::endl;
     } else {
         std::cerr << "❌ Failed to register Sales Module" << std::endl;
@@ -48,20 +66,16 @@ void SalesModule::addSale(const CoreVariantMap& saleData) {
     std::cout << "💰 Adding new sales deal..." << std::endl;
     
     try {
-        std::string dealName = saleData.count("deal_name") ? saleData.at("deal_name") : "Untitled Deal";
-        std::string amount = saleData.count("amount") ? saleData.at("amount") : "0";
-        std::string stage = saleData.count("stage") ? saleData.at("stage") : "Prospecting";
-        std::string probability = saleData.count("probability") ? saleData.at("probability") : "0.1";
-        std::string clientId = saleData.count("client_id") ? saleData.at("client_id") : "1";
-        std::string salesRep = saleData.count("sales_rep") ? saleData.at("sales_rep") : "Unknown";
+        DealRecord deal;
+        deal.deal_name = saleData.count("deal_name") ? variantToString(saleData.at("deal_name")) : "Untitled Deal";
+        deal.amount = saleData.count("amount") ? std::stod(variantToString(saleData.at("amount"))) : 0.0;
+        deal.stage = saleData.count("stage") ? variantToString(saleData.at("stage")) : "Prospecting";
+        deal.probability = saleData.count("probability") ? std::stod(variantToString(saleData.at("probability"))) : 0.1;
+        deal.client_id = saleData.count("client_id") ? std::stoll(variantToString(saleData.at("client_id"))) : 1;
+        deal.sales_rep = saleData.count("sales_rep") ? variantToString(saleData.at("sales_rep")) : "Unknown";
         
-        std::stringstream query;
-        query << "INSERT INTO sales_deals (client_id, deal_name, amount, stage, probability, sales_rep) VALUES ("
-              << clientId << ", '" << dealName << "', " << amount << ", '" 
-              << stage << "', " << probability << ", '" << salesRep << "');";
-        
-        if (schema_->getDatabase()->execute(query.str())) {
-            std::cout << "✅ Sales deal '" << dealName << "' added successfully" << std::endl;
+        if (TypedTable<DealRecord>::insert(schema_->getDatabase(), deal)) {
+            std::cout << "✅ Sales deal '" << deal.deal_name << "' added successfully" << std::endl;
         } else {
             std::cerr << "❌ Failed to add sales deal" << std::endl;
         }
@@ -74,22 +88,28 @@ void SalesModule::updateDeal(int dealId, const CoreVariantMap& updates) {
     std::cout << "📝 Updating deal ID: " << dealId << std::endl;
     
     try {
-        std::stringstream query;
-        query << "UPDATE sales_deals SET ";
-        
-        bool first = true;
-        for (const auto& pair : updates) {
-            if (!first) query << ", ";
-            query << pair.first << " = '" << pair.second << "'";
-            first = false;
+        // Same descriptor-checked read-modify-write as CRMModule::updateClient
+        Database* db = schema_->getDatabase();
+        if (!db->beginTransaction()) {
+            std::cerr << "❌ Failed to update deal" << std::endl;
+            return;
         }
         
-        query << ", updated_at = CURRENT_TIMESTAMP WHERE id = " << dealId << ";";
+        std::optional<DealRecord> deal = TypedTable<DealRecord>::find(db, dealId);
+        TypedTable<DealRecord>::ColumnSet changed = 0;
+        bool ok = deal.has_value();
+        for (const auto& [field, value] : updates) {
+            if (ok && !TypedTable<DealRecord>::assign(*deal, field, variantToString(value), &changed)) {
+                std::cerr << "❌ Invalid deal field '" << field << "'" << std::endl;
+                ok = false;
+            }
+        }
         
-        if (schema_->getDatabase()->execute(query.str())) {
+        if (ok && TypedTable<DealRecord>::update(db, *deal, changed) && db->commitTransaction()) {
             std::cout << "✅ Deal updated successfully" << std::endl;
         } else {
-            std::cerr << "❌ Failed to update deal" << std::endl;
+            db->rollbackTransaction();
+            std::cerr << "❌ Failed to update deal" << (deal ? "" : " (not found)") << std::endl;
         }
     } catch (const std::exception& e) {
         std::cerr << "❌ Error updating deal: " << e.what() << std::endl;
@@ -97,28 +117,11 @@ void SalesModule::updateDeal(int dealId, const CoreVariantMap& updates) {
 }
 
 std::vector<std::map<std::string, std::string>> SalesModule::getDeals() {
-    std::vector<std::map<std::string, std::string>> deals;
-    
-    // Sample deals data
-    std::map<std::string, std::string> deal1;
-    deal1["id"] = "1";
-    deal1["deal_name"] = "Enterprise Software License";
-    deal1["amount"] = "50000";
-    deal1["stage"] = "Negotiation";
-    deal1["probability"] = "0.7";
-    deal1["sales_rep"] = "John Smith";
-    deals.push_back(deal1);
-    
-    std::map<std::string, std::string> deal2;
-    deal2["id"] = "2";
-    deal2["deal_name"] = "Consulting Services";
-    deal2["amount"] = "25000";
-    deal2["stage"] = "Proposal";
-    deal2["probability"] = "0.4";
-    deal2["sales_rep"] = "Jane Doe";
-    deals.push_back(deal2);
-    
-    return deals;
+    return dealPager(schema_->getDatabase()).fetchAll(PageRequest());
+}
+
+Page SalesModule::getDealsPage(const PageRequest& request) {
+    return dealPager(schema_->getDatabase()).fetch(request);
 }
 
 std::map<std::string, double> SalesModule::getSalesMetrics() {
@@ -1,10 +1,17 @@
 #pragma once
 #include "schema_model.h"
+#include "keyset_pager.h"
+#include <map>
+#include <string>
+#include <vector>
 class SalesModule {
 public:
     SalesModule(SchemaModel* schema) : schema_(schema) {}
     void registerModule() {}
     void addSale(const QVariantMap&) {}
+    // Loads every row - use getDealsPage for anything that can grow
+    [[deprecated("loads every row; use getDealsPage")]] std::vector<std::map<std::string, std::string>> getDeals();
+    Page getDealsPage(const PageRequest& request);  // filters: stage, sales_rep, client_id
 private:
     SchemaModel* schema_;
 };
@@ -1,10 +1,19 @@
 #include "SupportModule.h"
 #include "common_types.h"
 #include "database.h"
+#include "module_metrics.h"
+#include "records.h"
+#include "text_search.h"
 #include <iostream>
 #include <sstream>
 #include <map>
 
+namespace {
+KeysetPager ticketPager(Database* db) {
+    return KeysetPager(db, "support_tickets", {"status", "priority", "client_id", "assigned_to"});
+}
+}
+
 void SupportModule::registerModule() {
     std::cout << "🎧 Registering Support Module..." << std::endl;
     
@@ -23,7 +32,27 @@ void SupportModule::registerModule() {
         );
     )";
     
-    if (schema_->getDatabase()->execute(createTicketsTable)) {
+    // data/schema.sql's support_tickets keeps the text in issue and has no
+    // title, description, priority or assignee
+    static const std::vector<ColumnSpec> ticketColumns = {
+        {"title", "TEXT", "issue"},
+        {"description", "TEXT"},
+        {"priority", "TEXT DEFAULT 'Medium'"},
+        {"assigned_to", "TEXT"},
+    };
+    
+    if (schema_->getDatabase()->ensureSchema("support", createTicketsTable) &&
+        schema_->getDatabase()->ensureColumns("support_tickets", ticketColumns)) {
+        ModuleMetrics::install(schema_->getDatabase(), "support", {
+            {"total_tickets", "support_tickets", "1", ""},
+            {"open_tickets", "support_tickets", "$.status = 'Open'", ""},
+            {"resolved_tickets", "support_tickets", "$.status = 'Resolved'", ""},
+            {"resolved_with_time", "support_tickets", "$.resolved_at IS NOT NULL", ""},
+            {"resolution_days_sum", "support_tickets",
+             "CASE WHEN $.resolved_at IS NOT NULL THEN julianday($.resolved_at) - julianday($.created_at) ELSE 0 END", ""},
+        });
+        // Older databases carry the ticket text in issue rather than title/description
+        TextSearch::install(schema_->getDatabase(), "tickets", "support_tickets", {"title", "description", "issue"});
         std::cout << "✅ Support Module registered successfully" << std::endl;
     } else {
         std::cerr << "❌ Failed to register Support Module" << std::endl;
@@ -60,17 +89,14 @@ void SupportModule::addTicket(const CoreVariantMap& ticketData) {
     std::cout << "🎫 Adding new support ticket..." << std::endl;
     
     try {
-        std::string title = ticketData.count("title") ? ticketData.at("title") : "Support Request";
-        std::string description = ticketData.count("description") ? ticketData.at("description") : "";
-        std::string priority = ticketData.count("priority") ? ticketData.at("priority") : "Medium";
-        std::string clientId = ticketData.count("client_id") ? ticketData.at("client_id") : "1";
-        
-        std::stringstream query;
-        query << "INSERT INTO support_tickets (client_id, title, description, priority) VALUES ("
-              << clientId << ", '" << title << "', '" << description << "', '" << priority << "');";
+        TicketRecord ticket;
+        ticket.title = ticketData.count("title") ? variantToString(ticketData.at("title")) : "Support Request";
+        ticket.description = ticketData.count("description") ? variantToString(ticketData.at("description")) : "";
+        ticket.priority = ticketData.count("priority") ? variantToString(ticketData.at("priority")) : "Medium";
+        ticket.client_id = ticketData.count("client_id") ? std::stoll(variantToString(ticketData.at("client_id"))) : 1;
         
-        if (schema_->getDatabase()->execute(query.str())) {
-            std::cout << "✅ Support ticket '" << title << "' added successfully" << std::endl;
+        if (TypedTable<TicketRecord>::insert(schema_->getDatabase(), ticket)) {
+            std::cout << "✅ Support ticket '" << ticket.title << "' added successfully" << std::endl;
         } else {
             std::cerr << "❌ Failed to add support ticket" << std::endl;
         }
@@ -80,36 +106,22 @@ void SupportModule::addTicket(const CoreVariantMap& ticketData) {
 }
 
 std::vector<std::map<std::string, std::string>> SupportModule::getTickets() {
-    std::vector<std::map<std::string, std::string>> tickets;
-    
-    // Sample tickets
-    std::map<std::string, std::string> ticket1;
-    ticket1["id"] = "1";
-    ticket1["title"] = "Login Issues";
-    ticket1["priority"] = "High";
-    ticket1["status"] = "Open";
-    ticket1["assigned_to"] = "Support Team";
-    tickets.push_back(ticket1);
-    
-    std::map<std::string, std::string> ticket2;
-    ticket2["id"] = "2";
-    ticket2["title"] = "Feature Request";
-    ticket2["priority"] = "Low";
-    ticket2["status"] = "In Progress";
-    ticket2["assigned_to"] = "Development Team";
-    tickets.push_back(ticket2);
-    
-    return tickets;
+    return ticketPager(schema_->getDatabase()).fetchAll(PageRequest());
+}
+
+Page SupportModule::getTicketsPage(const PageRequest& request) {
+    return ticketPager(schema_->getDatabase()).fetch(request);
 }
 
 std::map<std::string, double> SupportModule::getSupportMetrics() {
+    std::map<std::string, double> totals = ModuleMetrics::read(schema_->getDatabase(), "support");
     std::map<std::string, double> metrics;
     
-    metrics["total_tickets"] = 45.0;
-    metrics["open_tickets"] = 12.0;
-    metrics["resolved_tickets"] = 33.0;
-    metrics["average_resolution_time"] = 2.5; // days
-    metrics["customer_satisfaction"] = 4.2; // out of 5
+    double timed = totals["resolved_with_time"];
+    metrics["total_tickets"] = totals["total_tickets"];
+    metrics["open_tickets"] = totals["open_tickets"];
+    metrics["resolved_tickets"] = totals["resolved_tickets"];
+    metrics["average_resolution_time"] = timed > 0 ? totals["resolution_days_sum"] / timed : 0.0; // days
     
     return metrics;
 }
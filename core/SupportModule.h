@@ -1,10 +1,17 @@
 #pragma once
 #include "schema_model.h"
+#include "keyset_pager.h"
+#include <map>
+#include <string>
+#include <vector>
 class SupportModule {
 public:
     SupportModule(SchemaModel* schema) : schema_(schema) {}
     void registerModule() {}
     void resolveTicket(const QVariantMap&) {}
+    // Loads every row - use getTicketsPage for anything that can grow
+    [[deprecated("loads every row; use getTicketsPage")]] std::vector<std::map<std::string, std::string>> getTickets();
+    Page getTicketsPage(const PageRequest& request);  // filters: status, priority, client_id, assigned_to
     void updateInsights(void*) {}
 private:
     SchemaModel* schema_;
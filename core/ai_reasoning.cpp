@@ -1,6 +1,7 @@
 #include "ai_reasoning.h"
 #include "database.h"
 #include "schema_model.h"
+#include "scoring_functions.h"
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -160,34 +161,22 @@ AIReasoningEngine::ReasoningResult AIReasoningEngine::analyzeCustomerChurn(int c
 }
 
 double AIReasoningEngine::assessChurnRisk(const CoreVariantMap& clientData) {
-    double risk_score = 0.0;
-    
-    // Analyze various risk factors
-    auto it = clientData.find("last_interaction_days");
-    if (it != clientData.end()) {
-        double days = std::get<double>(it->second);
-        risk_score += std::min(days / 60.0, 1.0) * 0.3; // 30% weight
-    }
-    
-    it = clientData.find("support_tickets_count");
-    if (it != clientData.end()) {
-        double tickets = std::get<double>(it->second);
-        risk_score += std::min(tickets / 5.0, 1.0) * 0.2; // 20% weight
-    }
-    
-    it = clientData.find("engagement_score");
-    if (it != clientData.end()) {
-        double engagement = std::get<double>(it->second);
-        risk_score += (1.0 - engagement) * 0.4; // 40% weight
-    }
+    // Same model as the riley_churn() SQL function
+    auto factor = [&clientData](const char* name) -> std::optional<double> {
+        auto it = clientData.find(name);
+        if (it == clientData.end()) {
+            return std::nullopt;
+        }
+        return std::get<double>(it->second);
+    };
     
-    it = clientData.find("payment_delays");
-    if (it != clientData.end()) {
-        double delays = std::get<double>(it->second);
-        risk_score += std::min(delays / 3.0, 1.0) * 0.1; // 10% weight
-    }
+    ChurnFactors factors;
+    factors.last_interaction_days = factor("last_interaction_days");
+    factors.support_tickets = factor("support_tickets_count");
+    factors.engagement_score = factor("engagement_score");
+    factors.payment_delays = factor("payment_delays");
     
-    return std::min(risk_score, 1.0);
+    return ScoringFunctions::churnRisk(factors);
 }
 
 void AIReasoningEngine::addBusinessRule(const std::string& domain, const std::string& rule, double weight) {
@@ -0,0 +1,290 @@
+// Bulk loader for Riley Corpbrain - batched imports on the writer connection
+#include "bulk_loader.h"
+#include "database.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <utility>
+
+namespace {
+
+// FNV-1a over one column: NULL or value tag, length, bytes - so ("ab", "c") and ("a", "bc") differ
+uint64_t hashField(uint64_t hash, unsigned char tag, const void* data, size_t size) {
+    auto mix = [&hash](const unsigned char* bytes, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+        }
+    };
+    uint64_t length = size;
+    mix(&tag, 1);
+    mix(reinterpret_cast<const unsigned char*>(&length), sizeof(length));
+    mix(static_cast<const unsigned char*>(data), size);
+    return hash;
+}
+
+const uint64_t kHashSeed = 0xcbf29ce484222325ULL;
+
+// Values hash by their text form, so 42 hashes like "42" and 2.5 like
+// "2.5": a refresh that infers another type for a column (TEXT instead of
+// INTEGER, REAL instead of INTEGER) still finds its rows unchanged
+uint64_t hashValue(uint64_t hash, const SqlValue& value) {
+    if (auto* text = std::get_if<std::string>(&value)) {
+        return hashField(hash, 3, text->data(), text->size());
+    }
+    char digits[32];
+    std::to_chars_result result;
+    if (auto* integer = std::get_if<int64_t>(&value)) {
+        result = std::to_chars(digits, digits + sizeof(digits), *integer);
+    } else {
+        result = std::to_chars(digits, digits + sizeof(digits), std::get<double>(value));
+    }
+    return hashField(hash, 3, digits, result.ptr - digits);
+}
+
+} // namespace
+
+BulkLoader::BulkLoader(Database* db, std::string table, std::vector<std::string> columns)
+    : BulkLoader(db, std::move(table), std::move(columns), Options()) {}
+
+BulkLoader::BulkLoader(Database* db, std::string table, std::vector<std::string> columns, const Options& options)
+    : db_(db), table_(std::move(table)), columns_(std::move(columns)), options_(options) {
+    options_.batch_rows = std::max<size_t>(options_.batch_rows, 1);
+    if (!options_.upsert_keys.empty()) {
+        for (const auto& column : columns_) {
+            is_key_.push_back(std::find(options_.upsert_keys.begin(), options_.upsert_keys.end(), column) != options_.upsert_keys.end());
+        }
+    }
+}
+
+BulkLoader::~BulkLoader() {
+    if (!failed_) {
+        finish();
+    }
+}
+
+bool BulkLoader::add(const std::vector<std::string>& fields) {
+    std::vector<std::string_view> views(fields.begin(), fields.end());
+    return add(views.data(), views.size());
+}
+
+bool BulkLoader::add(const std::string_view* fields, size_t count) {
+    if (failed_) {
+        return false;
+    }
+    if (!in_batch_ && !beginBatch()) {
+        return false;
+    }
+
+    uint64_t hash = kHashSeed;
+    bool key_missing = false;
+    for (size_t i = 0; i < columns_.size(); i++) {
+        int index = static_cast<int>(i + 1);
+        bool present = i < count && !(options_.empty_as_null && fields[i].empty());
+        if (present) {
+            insert_.bind(index, fields[i]);
+        } else {
+            insert_.bindNull(index);
+        }
+
+        if (is_key_.empty()) {
+            continue;
+        }
+        if (is_key_[i]) {
+            key_missing = key_missing || !present || fields[i].empty();
+        } else {
+            hash = present ? hashField(hash, 3, fields[i].data(), fields[i].size()) : hashField(hash, 0, nullptr, 0);
+        }
+    }
+    return insertBound(hash, key_missing);
+}
+
+bool BulkLoader::add(const std::vector<SqlValue>& values) {
+    return add(values.data(), values.size());
+}
+
+bool BulkLoader::add(const SqlValue* values, size_t count) {
+    if (failed_) {
+        return false;
+    }
+    if (!in_batch_ && !beginBatch()) {
+        return false;
+    }
+
+    uint64_t hash = kHashSeed;
+    bool key_missing = false;
+    for (size_t i = 0; i < columns_.size(); i++) {
+        int index = static_cast<int>(i + 1);
+        const std::string* text = i < count ? std::get_if<std::string>(&values[i]) : nullptr;
+        bool present = i < count && !std::holds_alternative<std::nullptr_t>(values[i]) &&
+                       !(options_.empty_as_null && text && text->empty());
+        if (present) {
+            insert_.bindValue(index, values[i]);
+        } else {
+            insert_.bindNull(index);
+        }
+
+        if (is_key_.empty()) {
+            continue;
+        }
+        if (is_key_[i]) {
+            key_missing = key_missing || !present || (text && text->empty());
+        } else {
+            hash = present ? hashValue(hash, values[i]) : hashField(hash, 0, nullptr, 0);
+        }
+    }
+    return insertBound(hash, key_missing);
+}
+
+bool BulkLoader::insertBound(uint64_t row_hash, bool key_missing) {
+    sqlite3* handle = sqlite3_db_handle(insert_.handle());
+    bool upsert = !is_key_.empty();
+    if (upsert) {
+        if (key_missing) {
+            rejected_++;
+            return true;
+        }
+        insert_.bind(static_cast<int>(columns_.size() + 1), static_cast<int64_t>(row_hash));
+        sqlite3_set_last_insert_rowid(handle, 0);
+    }
+
+    if (insert_.execute()) {
+        // An upsert that found the same hash changes nothing; one that
+        // updated leaves the last insert rowid at the 0 set above
+        if (upsert && sqlite3_changes(handle) == 0) {
+            unchanged_++;
+        } else {
+            loaded_++;
+            if (!upsert || sqlite3_last_insert_rowid(handle) != 0) {
+                inserted_++;
+            }
+        }
+    } else if ((sqlite3_errcode(sqlite3_db_handle(insert_.handle())) & 0xff) == SQLITE_CONSTRAINT) {
+        rejected_++;
+    } else {
+        error_ = insert_.errorMessage();
+        std::cerr << "❌ Bulk load into " << table_ << " failed: " << error_ << std::endl;
+        abort();
+        failed_ = true;
+        return false;
+    }
+    insert_.reset();
+
+    if (++batch_count_ >= options_.batch_rows) {
+        if (!db_->commitTransaction()) {
+            error_ = "commit failed";
+            abort();
+            failed_ = true;
+            return false;
+        }
+        in_batch_ = false;
+        batch_count_ = 0;
+    }
+    return true;
+}
+
+bool BulkLoader::finish() {
+    bool ok = !failed_;
+    if (in_batch_) {
+        insert_.reset();
+        if (db_->commitTransaction()) {
+            in_batch_ = false;
+            batch_count_ = 0;
+        } else {
+            error_ = "commit failed";
+            abort();
+            failed_ = true;
+            ok = false;
+        }
+    }
+
+    // Hand the writer back to other threads
+    insert_ = PreparedStatement();
+    return ok;
+}
+
+void BulkLoader::abort() {
+    if (in_batch_) {
+        insert_.reset();
+        db_->rollbackTransaction();
+        in_batch_ = false;
+        batch_count_ = 0;
+    }
+    insert_ = PreparedStatement();
+}
+
+std::string BulkLoader::quoteIdentifier(const std::string& name) {
+    std::string quoted = "\"";
+    for (char c : name) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+bool BulkLoader::prepareUpsert(Database* db, const std::string& table, const std::vector<std::string>& keys, std::string* error) {
+    bool has_hash = false;
+    for (const auto& column : db->query("PRAGMA table_info(" + quoteIdentifier(table) + ");")) {
+        has_hash = has_hash || column.at("name") == "_row_hash";
+    }
+    if (!has_hash && !db->execute("ALTER TABLE " + quoteIdentifier(table) + " ADD COLUMN \"_row_hash\" INTEGER;")) {
+        *error = "cannot add _row_hash to " + table;
+        return false;
+    }
+
+    std::string index = "ux_" + table, columns;
+    for (const auto& key : keys) {
+        index += "_" + key;
+        columns += (columns.empty() ? "" : ", ") + quoteIdentifier(key);
+    }
+    if (!db->execute("CREATE UNIQUE INDEX IF NOT EXISTS " + quoteIdentifier(index) + " ON " + quoteIdentifier(table) + " (" + columns + ");")) {
+        *error = "cannot index " + table + " on its key - rows already loaded have duplicate keys";
+        return false;
+    }
+    return true;
+}
+
+bool BulkLoader::beginBatch() {
+    if (!db_->beginTransaction()) {
+        error_ = "cannot begin transaction";
+        failed_ = true;
+        return false;
+    }
+    in_batch_ = true;
+
+    if (!insert_) {
+        std::string names, params;
+        for (size_t i = 0; i < columns_.size(); i++) {
+            names += (i ? ", " : "") + quoteIdentifier(columns_[i]);
+            params += (i ? ", ?" : "?") + std::to_string(i + 1);
+        }
+
+        std::string sql = "INSERT INTO " + quoteIdentifier(table_) + " (" + names;
+        if (is_key_.empty()) {
+            sql += ") VALUES (" + params + ");";
+        } else {
+            std::string keys, updates;
+            for (size_t i = 0; i < columns_.size(); i++) {
+                std::string column = quoteIdentifier(columns_[i]);
+                if (is_key_[i]) {
+                    keys += (keys.empty() ? "" : ", ") + column;
+                } else {
+                    updates += column + " = excluded." + column + ", ";
+                }
+            }
+            sql += ", \"_row_hash\") VALUES (" + params + ", ?" + std::to_string(columns_.size() + 1) + ") ON CONFLICT (" + keys +
+                   ") DO UPDATE SET " + updates + "\"_row_hash\" = excluded.\"_row_hash\" WHERE \"_row_hash\" IS NOT excluded.\"_row_hash\";";
+        }
+
+        insert_ = db_->prepare(sql);
+        if (!insert_) {
+            error_ = "cannot prepare insert into " + table_;
+            abort();
+            failed_ = true;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+// Bulk loader - batched transactional inserts through one prepared statement
+#pragma once
+#include "statement_cache.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Database;
+
+/**
+ * Bulk Loader - the single writer behind every importer
+ * Rows are bound into one INSERT prepared once on the writer connection
+ * and committed every batch_rows rows, so a multi-million row import is
+ * a few hundred transactions instead of one per row. The writer stays
+ * with the loading thread for the whole load; other threads' writes wait
+ * for it (reads keep going on the pool).
+ *
+ * Text fields (CSV) bind as TEXT; SqlValue rows (JSON) keep their types.
+ * Rows with fewer fields than columns are padded with NULL, extra fields
+ * are dropped. A row SQLite rejects (constraint failure) is counted and
+ * skipped; any other error aborts the load and rolls back the open batch.
+ *
+ * With upsert_keys set, rows are merged on that natural key instead of
+ * appended: INSERT ... ON CONFLICT DO UPDATE against a unique index on
+ * the key, with a hash of the other columns kept in _row_hash so an
+ * unchanged row is only an index probe - no page is written. A refresh
+ * of a mostly unchanged export costs reads plus the size of the delta.
+ * Rows with an empty key are rejected. prepareUpsert() sets up the table.
+ */
+class BulkLoader {
+public:
+    struct Options {
+        size_t batch_rows = 50000;
+        bool empty_as_null = false;  // bind empty fields as NULL instead of ''
+        std::vector<std::string> upsert_keys;  // natural key; empty appends
+    };
+
+    BulkLoader(Database* db, std::string table, std::vector<std::string> columns);
+    BulkLoader(Database* db, std::string table, std::vector<std::string> columns, const Options& options);
+    ~BulkLoader();
+
+    BulkLoader(const BulkLoader&) = delete;
+    BulkLoader& operator=(const BulkLoader&) = delete;
+
+    bool add(const std::string_view* fields, size_t count);
+    bool add(const std::vector<std::string>& fields);
+    bool add(const SqlValue* values, size_t count);
+    bool add(const std::vector<SqlValue>& values);
+
+    // Commits the open batch; the loader can keep adding afterwards
+    bool finish();
+    void abort();  // rolls back the open batch
+
+    size_t rowsLoaded() const { return loaded_; }  // inserted plus updated
+    size_t rowsRejected() const { return rejected_; }
+    size_t rowsInserted() const { return inserted_; }
+    size_t rowsUpdated() const { return loaded_ - inserted_; }
+    size_t rowsUnchanged() const { return unchanged_; }
+    const std::string& error() const { return error_; }
+
+    // "name" with embedded quotes doubled, for splicing identifiers into SQL
+    static std::string quoteIdentifier(const std::string& name);
+
+    // Adds the _row_hash column and the unique index on the key if missing;
+    // fails when rows already loaded have duplicate keys
+    static bool prepareUpsert(Database* db, const std::string& table, const std::vector<std::string>& keys, std::string* error);
+
+private:
+    bool beginBatch();
+    bool insertBound(uint64_t row_hash, bool key_missing);
+
+    Database* db_;
+    std::string table_;
+    std::vector<std::string> columns_;
+    Options options_;
+    std::vector<bool> is_key_;
+
+    PreparedStatement insert_;
+    bool in_batch_ = false;
+    bool failed_ = false;
+    size_t batch_count_ = 0;
+    size_t loaded_ = 0;
+    size_t rejected_ = 0;
+    size_t inserted_ = 0;
+    size_t unchanged_ = 0;
+    std::string error_;
+};
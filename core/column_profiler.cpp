@@ -0,0 +1,606 @@
+// Column profiler for Riley Corpbrain - HyperLogLog, t-digest and Top-K per column
+#include "column_profiler.h"
+#include "bulk_loader.h"
+#include "database.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+namespace {
+
+// splitmix64 finalizer: spreads any 64-bit input over all output bits
+uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// Text, blobs and numbers hash apart, so "1" and 1 count as two values
+const uint64_t kTextTag = 0x7465787400000000ULL;
+const uint64_t kBlobTag = 0x626c6f6200000000ULL;
+
+uint64_t hashBytes(std::string_view bytes, uint64_t tag) {
+    return mix(std::hash<std::string_view>()(bytes) ^ tag);
+}
+
+int leadingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? __builtin_clzll(x) : 64;
+#else
+    int n = 0;
+    for (uint64_t bit = 1ULL << 63; bit && !(x & bit); bit >>= 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+
+bool isBlank(std::string_view text) {
+    return text.find_first_not_of(" \t\r\n") == std::string_view::npos;
+}
+
+void setText(SqlValue& out, std::string_view text) {
+    if (auto* existing = std::get_if<std::string>(&out)) {
+        existing->assign(text.data(), text.size());
+    } else {
+        out = std::string(text);
+    }
+}
+
+} // namespace
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision_(std::clamp(precision, 4, 18)), registers_(size_t(1) << precision_, 0) {}
+
+void HyperLogLog::add(uint64_t hash) {
+    size_t index = hash >> (64 - precision_);
+    uint64_t rest = hash << precision_;
+    uint8_t rank = static_cast<uint8_t>(std::min(leadingZeros(rest), 64 - precision_) + 1);
+    if (rank > registers_[index]) {
+        registers_[index] = rank;
+    }
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.precision_ != precision_) {
+        return;
+    }
+    for (size_t i = 0; i < registers_.size(); i++) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+}
+
+double HyperLogLog::estimate() const {
+    double m = static_cast<double>(registers_.size());
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t rank : registers_) {
+        sum += std::ldexp(1.0, -rank);
+        zeros += rank == 0;
+    }
+
+    double alpha = 0.7213 / (1 + 1.079 / m);
+    double raw = alpha * m * m / sum;
+    // Small cardinalities: linear counting over the empty registers is exact-ish
+    if (raw <= 2.5 * m && zeros > 0) {
+        return m * std::log(m / zeros);
+    }
+    return raw;  // 64-bit hashes: no large-range correction needed
+}
+
+TDigest::TDigest(double compression) : compression_(std::max(compression, 20.0)) {}
+
+void TDigest::add(double value) {
+    if (std::isnan(value)) {
+        return;
+    }
+    if (count_ == 0) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+    count_++;
+    buffer_.push_back(value);
+    if (buffer_.size() >= static_cast<size_t>(compression_ * 20)) {
+        compress();
+    }
+}
+
+void TDigest::merge(const TDigest& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    min_ = count_ ? std::min(min_, other.min_) : other.min_;
+    max_ = count_ ? std::max(max_, other.max_) : other.max_;
+    count_ += other.count_;
+
+    compress();
+    std::vector<Centroid> incoming = other.centroids_;
+    for (double value : other.buffer_) {
+        incoming.push_back({value, 1});
+    }
+    auto byMean = [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; };
+    std::sort(incoming.begin(), incoming.end(), byMean);
+
+    scratch_.clear();
+    std::merge(centroids_.begin(), centroids_.end(), incoming.begin(), incoming.end(), std::back_inserter(scratch_), byMean);
+    collapse(scratch_);
+}
+
+void TDigest::compress() {
+    if (buffer_.empty()) {
+        return;
+    }
+    std::sort(buffer_.begin(), buffer_.end());
+
+    scratch_.clear();
+    size_t next = 0;
+    for (double value : buffer_) {
+        while (next < centroids_.size() && centroids_[next].mean < value) {
+            scratch_.push_back(centroids_[next++]);
+        }
+        scratch_.push_back({value, 1});
+    }
+    scratch_.insert(scratch_.end(), centroids_.begin() + next, centroids_.end());
+    buffer_.clear();
+    collapse(scratch_);
+}
+
+void TDigest::collapse(const std::vector<Centroid>& sorted) {
+    double total = 0;
+    for (const auto& centroid : sorted) {
+        total += centroid.weight;
+    }
+
+    // Neighbours merge while the combined centroid stays within
+    // 4 * total * q(1-q) / compression of its quantile position
+    centroids_.clear();
+    Centroid current = sorted[0];
+    double before = 0;
+    for (size_t i = 1; i < sorted.size(); i++) {
+        const Centroid& next = sorted[i];
+        double proposed = current.weight + next.weight;
+        double q0 = before / total;
+        double q2 = (before + proposed) / total;
+        double limit = 4 * total * std::min(q0 * (1 - q0), q2 * (1 - q2)) / compression_;
+        if (proposed <= limit) {
+            current.mean += (next.mean - current.mean) * next.weight / proposed;
+            current.weight = proposed;
+        } else {
+            before += current.weight;
+            centroids_.push_back(current);
+            current = next;
+        }
+    }
+    centroids_.push_back(current);
+}
+
+double TDigest::quantile(double q) const {
+    if (!buffer_.empty()) {
+        TDigest merged = *this;
+        merged.compress();
+        return merged.quantile(q);
+    }
+    if (centroids_.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    if (centroids_.size() == 1) {
+        return centroids_[0].mean;
+    }
+
+    // Each centroid stands at the middle of its weight; interpolate between
+    // neighbouring middles, and toward min/max beyond the outer ones
+    double target = q * count_;
+    double position = centroids_[0].weight / 2;
+    if (target < position) {
+        return min_ + (centroids_[0].mean - min_) * target / position;
+    }
+    for (size_t i = 1; i < centroids_.size(); i++) {
+        double next = position + (centroids_[i - 1].weight + centroids_[i].weight) / 2;
+        if (target < next) {
+            double t = (target - position) / (next - position);
+            return centroids_[i - 1].mean + (centroids_[i].mean - centroids_[i - 1].mean) * t;
+        }
+        position = next;
+    }
+    double tail = count_ - position;
+    const Centroid& last = centroids_.back();
+    return tail > 0 ? last.mean + (max_ - last.mean) * std::min(1.0, (target - position) / tail) : max_;
+}
+
+TopK::TopK(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {
+    // At most a quarter full, so probes stay short
+    size_t size = 8;
+    while (size < capacity_ * 4) {
+        size <<= 1;
+    }
+    slots_.assign(size, 0);
+    mask_ = size - 1;
+}
+
+size_t TopK::find(uint64_t hash) const {
+    for (size_t slot = hash & mask_; slots_[slot]; slot = (slot + 1) & mask_) {
+        if (items_[slots_[slot] - 1].hash == hash) {
+            return slots_[slot] - 1;
+        }
+    }
+    return kMissing;
+}
+
+size_t TopK::admit(uint64_t hash) {
+    size_t i;
+    if (items_.size() < capacity_) {
+        i = items_.size();
+        items_.emplace_back();
+        table_pos_.push_back(0);
+        heap_pos_.push_back(static_cast<uint32_t>(heap_.size()));
+        heap_.push_back(static_cast<uint32_t>(i));
+    } else {
+        i = heap_[0];
+        unlink(i);
+        items_[i].error = items_[i].count;
+    }
+    items_[i].count++;
+    items_[i].hash = hash;
+    link(i);
+    return i;
+}
+
+void TopK::settle(size_t position) {
+    if (position > 0 && countAt((position - 1) / 2) > countAt(position)) {
+        siftUp(position);
+    } else {
+        siftDown(position);
+    }
+}
+
+void TopK::link(size_t i) {
+    size_t slot = items_[i].hash & mask_;
+    while (slots_[slot]) {
+        slot = (slot + 1) & mask_;
+    }
+    slots_[slot] = static_cast<uint32_t>(i + 1);
+    table_pos_[i] = static_cast<uint32_t>(slot);
+}
+
+// Linear-probing delete: later entries of the probe run shift back into
+// the hole unless that would move them before their home slot
+void TopK::unlink(size_t i) {
+    size_t hole = table_pos_[i];
+    for (size_t next = (hole + 1) & mask_; slots_[next]; next = (next + 1) & mask_) {
+        size_t home = items_[slots_[next] - 1].hash & mask_;
+        if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+            slots_[hole] = slots_[next];
+            table_pos_[slots_[hole] - 1] = static_cast<uint32_t>(hole);
+            hole = next;
+        }
+    }
+    slots_[hole] = 0;
+}
+
+void TopK::swapHeap(size_t a, size_t b) {
+    std::swap(heap_[a], heap_[b]);
+    heap_pos_[heap_[a]] = static_cast<uint32_t>(a);
+    heap_pos_[heap_[b]] = static_cast<uint32_t>(b);
+}
+
+void TopK::siftUp(size_t position) {
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        if (countAt(parent) <= countAt(position)) {
+            return;
+        }
+        swapHeap(position, parent);
+        position = parent;
+    }
+}
+
+void TopK::siftDown(size_t position) {
+    while (true) {
+        size_t smallest = position;
+        for (size_t child = 2 * position + 1; child <= 2 * position + 2 && child < heap_.size(); child++) {
+            if (countAt(child) < countAt(smallest)) {
+                smallest = child;
+            }
+        }
+        if (smallest == position) {
+            return;
+        }
+        swapHeap(position, smallest);
+        position = smallest;
+    }
+}
+
+void TopK::merge(const TopK& other) {
+    // A value missing from a full summary may still have occurred up to
+    // that summary's smallest count times, which is added as error
+    uint64_t own_floor = items_.size() == capacity_ ? countAt(0) : 0;
+    uint64_t other_floor = other.items_.size() == other.capacity_ ? other.countAt(0) : 0;
+
+    std::vector<Item> combined = items_;
+    for (auto& item : combined) {
+        size_t i = other.find(item.hash);
+        item.count += i != kMissing ? other.items_[i].count : other_floor;
+        item.error += i != kMissing ? other.items_[i].error : other_floor;
+    }
+    for (const auto& item : other.items_) {
+        if (find(item.hash) == kMissing) {
+            combined.push_back(item);
+            combined.back().count += own_floor;
+            combined.back().error += own_floor;
+        }
+    }
+
+    std::sort(combined.begin(), combined.end(), [](const Item& a, const Item& b) { return a.count > b.count; });
+    combined.resize(std::min(combined.size(), capacity_));
+
+    items_ = std::move(combined);
+    heap_.clear();
+    heap_pos_.assign(items_.size(), 0);
+    table_pos_.assign(items_.size(), 0);
+    std::fill(slots_.begin(), slots_.end(), 0);
+    for (size_t i = 0; i < items_.size(); i++) {
+        link(i);
+        heap_pos_[i] = static_cast<uint32_t>(heap_.size());
+        heap_.push_back(static_cast<uint32_t>(i));
+        siftUp(heap_.size() - 1);
+    }
+}
+
+std::string TopK::Item::text() const {
+    if (auto* integer = std::get_if<int64_t>(&value)) {
+        return std::to_string(*integer);
+    }
+    if (auto* real = std::get_if<double>(&value)) {
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%.15g", *real);
+        return std::string(buffer, length);
+    }
+    if (auto* string = std::get_if<std::string>(&value)) {
+        return *string;
+    }
+    return "NULL";
+}
+
+std::vector<TopK::Item> TopK::top(size_t k) const {
+    std::vector<Item> items;
+    for (const auto& item : items_) {
+        if (item.guaranteed() > 0) {
+            items.push_back(item);
+        }
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return a.guaranteed() != b.guaranteed() ? a.guaranteed() > b.guaranteed() : a.count > b.count;
+    });
+    items.resize(std::min(items.size(), k));
+    return items;
+}
+
+double ColumnProfile::distinctCount() const {
+    return std::min(distinct.estimate(), static_cast<double>(present()));
+}
+
+void ColumnProfile::merge(const ColumnProfile& other) {
+    if (other.numeric()) {
+        min = numeric() ? std::min(min, other.min) : other.min;
+        max = numeric() ? std::max(max, other.max) : other.max;
+    }
+    if (other.texts) {
+        if (!texts || other.min_text < min_text) {
+            min_text = other.min_text;
+        }
+        if (!texts || other.max_text > max_text) {
+            max_text = other.max_text;
+        }
+    }
+    rows += other.rows;
+    nulls += other.nulls;
+    blanks += other.blanks;
+    integers += other.integers;
+    reals += other.reals;
+    texts += other.texts;
+    blobs += other.blobs;
+    sum += other.sum;
+    distinct.merge(other.distinct);
+    quantiles.merge(other.quantiles);
+    frequent.merge(other.frequent);
+}
+
+ColumnProfiler::ColumnProfiler(Database* db) : ColumnProfiler(db, Options()) {}
+
+ColumnProfiler::ColumnProfiler(Database* db, const Options& options) : db_(db), options_(options) {}
+
+std::vector<ColumnProfile> ColumnProfiler::emptyProfiles() const {
+    std::vector<ColumnProfile> profiles(names_.size());
+    for (size_t i = 0; i < names_.size(); i++) {
+        profiles[i].name = names_[i];
+        profiles[i].distinct = HyperLogLog(options_.hll_precision);
+        profiles[i].quantiles = TDigest(options_.compression);
+        profiles[i].frequent = TopK(options_.top_capacity);
+    }
+    return profiles;
+}
+
+bool ColumnProfiler::profile(const std::string& table) {
+    auto started = std::chrono::steady_clock::now();
+    names_.clear();
+    columns_.clear();
+    rows_ = 0;
+    error_.clear();
+
+    std::string quoted = BulkLoader::quoteIdentifier(table);
+    for (const auto& info : db_->query("PRAGMA table_info(" + quoted + ");")) {
+        names_.push_back(info.at("name"));
+    }
+    if (names_.empty()) {
+        error_ = "no such table: " + table;
+        return false;
+    }
+
+    std::string select = "SELECT ";
+    for (size_t i = 0; i < names_.size(); i++) {
+        select += (i ? ", " : "") + BulkLoader::quoteIdentifier(names_[i]);
+    }
+    select += " FROM " + quoted;
+
+    // Slice the rowid range; WITHOUT ROWID tables have none to slice
+    bool has_rowid = true;
+    {
+        PreparedStatement definition = db_->prepareRead("SELECT sql FROM sqlite_master WHERE type = 'table' AND name = ?1;");
+        if (definition && definition.bind(1, table)) {
+            Database::forEachRow(definition, [&has_rowid](const RowView& row) {
+                std::string sql(row.getText(0));
+                std::transform(sql.begin(), sql.end(), sql.begin(), [](unsigned char c) { return std::toupper(c); });
+                has_rowid = sql.find("WITHOUT ROWID") == std::string::npos;
+                return false;
+            });
+        }
+    }
+
+    int64_t first = 0, last = -1;
+    if (has_rowid) {
+        db_->forEachRow("SELECT MIN(rowid), MAX(rowid) FROM " + quoted + ";", [&](const RowView& row) {
+            if (!row.isNull(0)) {
+                first = row.getInt64(0);
+                last = row.getInt64(1);
+            }
+            return false;
+        });
+    }
+
+    size_t threads = options_.threads ? options_.threads : std::max<size_t>(db_->readerCount(), 1);
+    uint64_t span = last >= first ? static_cast<uint64_t>(last - first) + 1 : 0;
+    if (!has_rowid || span < threads * 1024) {
+        threads = 1;
+    }
+
+    std::vector<std::vector<ColumnProfile>> partials(threads);
+    std::vector<std::string> errors(threads);
+    std::vector<char> completed(threads, 0);
+    auto scan = [&](size_t slice) {
+        partials[slice] = emptyProfiles();
+        int64_t begin = first + static_cast<int64_t>(span / threads * slice);
+        int64_t end = slice + 1 == threads ? last : first + static_cast<int64_t>(span / threads * (slice + 1)) - 1;
+        completed[slice] = scanSlice(select, has_rowid && threads > 1, begin, end, partials[slice], &errors[slice]);
+    };
+
+    if (threads == 1) {
+        scan(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (size_t slice = 0; slice < threads; slice++) {
+            workers.emplace_back(scan, slice);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    for (size_t slice = 0; slice < threads; slice++) {
+        if (!completed[slice]) {
+            error_ = errors[slice];
+            return false;
+        }
+    }
+
+    columns_ = std::move(partials[0]);
+    for (size_t slice = 1; slice < threads; slice++) {
+        for (size_t c = 0; c < columns_.size(); c++) {
+            columns_[c].merge(partials[slice][c]);
+        }
+    }
+    rows_ = columns_.empty() ? 0 : columns_[0].rows;
+    seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return true;
+}
+
+bool ColumnProfiler::scanSlice(const std::string& sql, bool ranged, int64_t first, int64_t last,
+                               std::vector<ColumnProfile>& profiles, std::string* error) {
+    PreparedStatement stmt = db_->prepareRead(ranged ? sql + " WHERE rowid BETWEEN ?1 AND ?2;" : sql + ";");
+    if (!stmt || (ranged && (!stmt.bind(1, first) || !stmt.bind(2, last)))) {
+        *error = stmt ? stmt.errorMessage() : "cannot prepare profile scan";
+        return false;
+    }
+
+    int count = static_cast<int>(profiles.size());
+    while (stmt.step()) {
+        for (int c = 0; c < count; c++) {
+            ColumnProfile& p = profiles[c];
+            p.rows++;
+
+            double number;
+            uint64_t hash;
+            switch (stmt.columnType(c)) {
+            case SqlType::NULL_VALUE:
+                p.nulls++;
+                continue;
+            case SqlType::INTEGER: {
+                int64_t value = stmt.getInt64(c);
+                p.integers++;
+                number = static_cast<double>(value);
+                hash = mix(static_cast<uint64_t>(value));
+                p.frequent.add(hash, [value](SqlValue& out) { out = value; });
+                break;
+            }
+            case SqlType::REAL: {
+                number = stmt.getDouble(c);
+                p.reals++;
+                // 2.0 stored as REAL is the same value as the integer 2
+                bool integral = number == std::floor(number) && std::fabs(number) < 9.2e18;
+                hash = integral ? mix(static_cast<uint64_t>(static_cast<int64_t>(number)))
+                                : mix(std::hash<double>()(number));
+                p.frequent.add(hash, [number](SqlValue& out) { out = number; });
+                break;
+            }
+            case SqlType::TEXT: {
+                std::string_view text = stmt.getText(c);
+                p.texts++;
+                if (isBlank(text)) {
+                    p.blanks++;
+                }
+                if (p.texts == 1 || text < p.min_text) {
+                    p.min_text.assign(text.data(), text.size());
+                }
+                if (p.texts == 1 || text > p.max_text) {
+                    p.max_text.assign(text.data(), text.size());
+                }
+                hash = hashBytes(text, kTextTag);
+                p.distinct.add(hash);
+                p.frequent.add(hash, [text](SqlValue& out) { setText(out, text); });
+                continue;
+            }
+            default:
+                p.blobs++;
+                p.distinct.add(hashBytes(stmt.getBlob(c), kBlobTag));
+                continue;
+            }
+
+            // Numbers
+            if (p.numeric() == 1) {
+                p.min = p.max = number;
+            } else {
+                p.min = std::min(p.min, number);
+                p.max = std::max(p.max, number);
+            }
+            p.sum += number;
+            p.distinct.add(hash);
+            p.quantiles.add(number);
+        }
+    }
+
+    if (stmt.failed()) {
+        *error = stmt.errorMessage();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,289 @@
+// Columnar result set for Riley Corpbrain - compact storage for large reads
+#include "columnar_result.h"
+#include "row_cursor.h"
+#include <sqlite3.h>
+#include <cstdlib>
+#include <utility>
+
+namespace {
+
+// Render a REAL the way sqlite3_column_text() does, so adapters produce the
+// same strings the row-map API always returned
+std::string formatReal(double value) {
+    char buffer[64];
+    sqlite3_snprintf(sizeof(buffer), buffer, "%!.15g", value);
+    return buffer;
+}
+
+} // namespace
+
+void ColumnarResult::setColumns(const std::vector<std::string>& names) {
+    names_ = names;
+    columns_.assign(names.size(), Column());
+    row_count_ = 0;
+}
+
+void ColumnarResult::reserve(size_t rows) {
+    for (auto& column : columns_) {
+        column.nulls.reserve(rows);
+        if (column.type == ColumnType::INTEGER) column.integers.reserve(rows);
+        if (column.type == ColumnType::REAL) column.reals.reserve(rows);
+        if (column.type == ColumnType::TEXT) column.offsets.reserve(rows + 1);
+    }
+}
+
+void ColumnarResult::appendRow(const RowView& row) {
+    if (names_.empty()) {
+        std::vector<std::string> names;
+        for (int i = 0; i < row.columnCount(); i++) {
+            names.emplace_back(row.columnName(i));
+        }
+        setColumns(names);
+    }
+
+    for (size_t i = 0; i < columns_.size(); i++) {
+        int index = static_cast<int>(i);
+
+        switch (row.columnType(index)) {
+            case SqlType::NULL_VALUE:
+                appendNull(i);
+                break;
+            case SqlType::INTEGER:
+                if (columns_[i].type == ColumnType::TEXT) {
+                    appendText(i, row.getText(index));
+                } else {
+                    appendInt64(i, row.getInt64(index));
+                }
+                break;
+            case SqlType::REAL:
+                if (columns_[i].type == ColumnType::TEXT) {
+                    appendText(i, row.getText(index));
+                } else {
+                    appendDouble(i, row.getDouble(index));
+                }
+                break;
+            default:
+                appendText(i, row.getText(index));
+                break;
+        }
+    }
+
+    finishRow();
+}
+
+void ColumnarResult::pushPlaceholder(Column& column) {
+    switch (column.type) {
+        case ColumnType::INTEGER:
+            column.integers.push_back(0);
+            break;
+        case ColumnType::REAL:
+            column.reals.push_back(0.0);
+            break;
+        case ColumnType::TEXT:
+            column.offsets.push_back(column.text.size());
+            break;
+        case ColumnType::NONE:
+            break;
+    }
+}
+
+void ColumnarResult::promote(Column& column, ColumnType type) {
+    if (column.type == type || type == ColumnType::NONE) {
+        return;
+    }
+
+    size_t rows = column.nulls.size();
+
+    if (column.type == ColumnType::NONE) {
+        // Every earlier row was NULL - back-fill placeholders
+        if (type == ColumnType::INTEGER) column.integers.assign(rows, 0);
+        if (type == ColumnType::REAL) column.reals.assign(rows, 0.0);
+        if (type == ColumnType::TEXT) column.offsets.assign(rows + 1, 0);
+    } else if (column.type == ColumnType::INTEGER && type == ColumnType::REAL) {
+        column.reals.reserve(rows);
+        for (int64_t value : column.integers) {
+            column.reals.push_back(static_cast<double>(value));
+        }
+        std::vector<int64_t>().swap(column.integers);
+    } else {
+        // Numeric to TEXT
+        column.offsets.reserve(rows + 1);
+        column.offsets.push_back(0);
+        for (size_t row = 0; row < rows; row++) {
+            if (!column.nulls[row]) {
+                column.text += column.type == ColumnType::INTEGER
+                    ? std::to_string(column.integers[row])
+                    : formatReal(column.reals[row]);
+            }
+            column.offsets.push_back(column.text.size());
+        }
+        std::vector<int64_t>().swap(column.integers);
+        std::vector<double>().swap(column.reals);
+    }
+
+    column.type = type;
+}
+
+void ColumnarResult::appendNull(size_t column) {
+    Column& target = columns_[column];
+    target.nulls.push_back(true);
+    pushPlaceholder(target);
+}
+
+void ColumnarResult::appendInt64(size_t column, int64_t value) {
+    Column& target = columns_[column];
+    promote(target, target.type == ColumnType::NONE ? ColumnType::INTEGER : target.type);
+
+    target.nulls.push_back(false);
+    if (target.type == ColumnType::INTEGER) {
+        target.integers.push_back(value);
+    } else if (target.type == ColumnType::REAL) {
+        target.reals.push_back(static_cast<double>(value));
+    } else {
+        target.text += std::to_string(value);
+        target.offsets.push_back(target.text.size());
+    }
+}
+
+void ColumnarResult::appendDouble(size_t column, double value) {
+    Column& target = columns_[column];
+    if (target.type == ColumnType::NONE || target.type == ColumnType::INTEGER) {
+        promote(target, ColumnType::REAL);
+    }
+
+    target.nulls.push_back(false);
+    if (target.type == ColumnType::REAL) {
+        target.reals.push_back(value);
+    } else {
+        target.text += formatReal(value);
+        target.offsets.push_back(target.text.size());
+    }
+}
+
+void ColumnarResult::appendText(size_t column, std::string_view value) {
+    Column& target = columns_[column];
+    promote(target, ColumnType::TEXT);
+
+    target.nulls.push_back(false);
+    target.text.append(value.data(), value.size());
+    target.offsets.push_back(target.text.size());
+}
+
+void ColumnarResult::finishRow() {
+    row_count_++;
+}
+
+int ColumnarResult::columnIndex(std::string_view name) const {
+    for (size_t i = 0; i < names_.size(); i++) {
+        if (names_[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool ColumnarResult::isNull(size_t row, size_t column) const {
+    return columns_[column].nulls[row];
+}
+
+int64_t ColumnarResult::getInt64(size_t row, size_t column) const {
+    const Column& source = columns_[column];
+    switch (source.type) {
+        case ColumnType::INTEGER: return source.integers[row];
+        case ColumnType::REAL: return static_cast<int64_t>(source.reals[row]);
+        case ColumnType::TEXT: return std::strtoll(std::string(getText(row, column)).c_str(), nullptr, 10);
+        default: return 0;
+    }
+}
+
+double ColumnarResult::getDouble(size_t row, size_t column) const {
+    const Column& source = columns_[column];
+    switch (source.type) {
+        case ColumnType::INTEGER: return static_cast<double>(source.integers[row]);
+        case ColumnType::REAL: return source.reals[row];
+        case ColumnType::TEXT: return std::strtod(std::string(getText(row, column)).c_str(), nullptr);
+        default: return 0.0;
+    }
+}
+
+std::string_view ColumnarResult::getText(size_t row, size_t column) const {
+    const Column& source = columns_[column];
+    if (source.type != ColumnType::TEXT) {
+        return {};
+    }
+    uint64_t begin = source.offsets[row];
+    return std::string_view(source.text.data() + begin, source.offsets[row + 1] - begin);
+}
+
+std::string ColumnarResult::toString(size_t row, size_t column) const {
+    const Column& source = columns_[column];
+    if (source.nulls[row]) {
+        return "";
+    }
+    switch (source.type) {
+        case ColumnType::INTEGER: return std::to_string(source.integers[row]);
+        case ColumnType::REAL: return formatReal(source.reals[row]);
+        case ColumnType::TEXT: return std::string(getText(row, column));
+        default: return "";
+    }
+}
+
+std::map<std::string, std::string> ColumnarResult::rowAsMap(size_t row) const {
+    std::map<std::string, std::string> values;
+    for (size_t column = 0; column < names_.size(); column++) {
+        values[names_[column]] = toString(row, column);
+    }
+    return values;
+}
+
+std::vector<std::map<std::string, std::string>> ColumnarResult::toRowMaps() const {
+    std::vector<std::map<std::string, std::string>> rows;
+    rows.reserve(row_count_);
+    for (size_t row = 0; row < row_count_; row++) {
+        rows.push_back(rowAsMap(row));
+    }
+    return rows;
+}
+
+ColumnarResult ColumnarResult::fromRowMaps(const std::vector<std::map<std::string, std::string>>& rows) {
+    ColumnarResult result;
+    if (rows.empty()) {
+        return result;
+    }
+
+    std::vector<std::string> names;
+    for (const auto& [name, value] : rows.front()) {
+        names.push_back(name);
+    }
+    result.setColumns(names);
+
+    for (const auto& row : rows) {
+        for (size_t column = 0; column < names.size(); column++) {
+            auto it = row.find(names[column]);
+            if (it == row.end()) {
+                result.appendNull(column);
+            } else {
+                result.appendText(column, it->second);
+            }
+        }
+        result.finishRow();
+    }
+
+    return result;
+}
+
+size_t ColumnarResult::memoryUsage() const {
+    size_t bytes = sizeof(*this);
+    for (const auto& name : names_) {
+        bytes += sizeof(name) + name.capacity();
+    }
+    for (const auto& column : columns_) {
+        bytes += sizeof(column);
+        bytes += column.integers.capacity() * sizeof(int64_t);
+        bytes += column.reals.capacity() * sizeof(double);
+        bytes += column.text.capacity();
+        bytes += column.offsets.capacity() * sizeof(uint64_t);
+        bytes += column.nulls.capacity() / 8;
+    }
+    return bytes;
+}
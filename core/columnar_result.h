@@ -0,0 +1,81 @@
+// Columnar result set - one name table, typed column vectors
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class RowView;
+
+/**
+ * ColumnarResult - compact in-memory result table
+ * Column names are stored once instead of once per row, numbers stay in
+ * native int64/double vectors, and text values share a single buffer.
+ * A column's type follows the values it receives: INTEGER widens to REAL,
+ * and any mix with TEXT widens to TEXT, matching SQLite's dynamic typing.
+ */
+class ColumnarResult {
+public:
+    enum class ColumnType {
+        NONE,      // only NULLs seen so far
+        INTEGER,
+        REAL,
+        TEXT
+    };
+
+    ColumnarResult() = default;
+
+    // Building
+    void setColumns(const std::vector<std::string>& names);
+    void appendRow(const RowView& row);  // first row also defines the columns
+    void appendNull(size_t column);
+    void appendInt64(size_t column, int64_t value);
+    void appendDouble(size_t column, double value);
+    void appendText(size_t column, std::string_view value);
+    void finishRow();  // call after appending one value to every column
+    void reserve(size_t rows);
+
+    // Shape
+    size_t rowCount() const { return row_count_; }
+    size_t columnCount() const { return names_.size(); }
+    const std::vector<std::string>& columnNames() const { return names_; }
+    int columnIndex(std::string_view name) const;  // -1 when absent
+    ColumnType columnType(size_t column) const { return columns_[column].type; }
+
+    // Typed cell access
+    bool isNull(size_t row, size_t column) const;
+    int64_t getInt64(size_t row, size_t column) const;
+    double getDouble(size_t row, size_t column) const;
+    std::string_view getText(size_t row, size_t column) const;  // TEXT columns only
+    std::string toString(size_t row, size_t column) const;      // any column, "" for NULL
+
+    // Whole-column access for aggregation loops
+    const std::vector<int64_t>& integers(size_t column) const { return columns_[column].integers; }
+    const std::vector<double>& reals(size_t column) const { return columns_[column].reals; }
+
+    // Adapters for callers still using row maps
+    std::map<std::string, std::string> rowAsMap(size_t row) const;
+    std::vector<std::map<std::string, std::string>> toRowMaps() const;
+    static ColumnarResult fromRowMaps(const std::vector<std::map<std::string, std::string>>& rows);
+
+    size_t memoryUsage() const;
+
+private:
+    struct Column {
+        ColumnType type = ColumnType::NONE;
+        std::vector<int64_t> integers;
+        std::vector<double> reals;
+        std::string text;                 // all text values back to back
+        std::vector<uint64_t> offsets;    // row i spans [offsets[i], offsets[i + 1])
+        std::vector<bool> nulls;
+    };
+
+    void promote(Column& column, ColumnType type);
+    void pushPlaceholder(Column& column);
+
+    std::vector<std::string> names_;
+    std::vector<Column> columns_;
+    size_t row_count_ = 0;
+};
@@ -439,6 +439,16 @@ void CommandCenter::logCommandExecution(const Command& command, bool success, co
     // Store in command history
     command_history_[command.id] = command;
 
+    // Persist through the group-commit queue so logging never waits on disk;
+    // the log is not read back here, so later statements skip read-your-writes
+    // and queue failures are reported by the queue itself
+    if (db_) {
+        db_->enqueueWrite(
+            "INSERT INTO command_log (command_id, source, action, success, result) VALUES (?1, ?2, ?3, ?4, ?5);",
+            {command.id, command.source, command.action, static_cast<int64_t>(success ? 1 : 0), result},
+            false);
+    }
+
     // Update success/failure counts
     if (success) {
         command_success_counts_[command.action]++;
@@ -0,0 +1,133 @@
+// Reader connection pool for Riley Corpbrain - parallel reads over WAL
+#include "connection_pool.h"
+#include "scoring_functions.h"
+#include <sqlite3.h>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+// ---------------------------------------------------------------------------
+// Lease
+// ---------------------------------------------------------------------------
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), reader_(other.reader_) {
+    other.pool_ = nullptr;
+    other.reader_ = nullptr;
+}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        if (reader_) {
+            pool_->release(reader_);
+        }
+        pool_ = other.pool_;
+        reader_ = other.reader_;
+        other.pool_ = nullptr;
+        other.reader_ = nullptr;
+    }
+    return *this;
+}
+
+ConnectionPool::Lease::~Lease() {
+    if (reader_) {
+        pool_->release(reader_);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// ConnectionPool
+// ---------------------------------------------------------------------------
+
+ConnectionPool::ConnectionPool(const std::string& path, size_t reader_count, QueryStats* stats) {
+    for (size_t i = 0; i < reader_count; i++) {
+        sqlite3* handle = nullptr;
+
+        // Each reader is leased to one thread at a time, so SQLite's own
+        // connection mutex is unnecessary; URIs let the replica share a memdb copy
+        int rc = sqlite3_open_v2(path.c_str(), &handle,
+                                 SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_URI, nullptr);
+        if (rc != SQLITE_OK) {
+            std::string error = "Cannot open reader connection: ";
+            error += sqlite3_errmsg(handle);
+            sqlite3_close(handle);
+            throw std::runtime_error(error);
+        }
+
+        sqlite3_busy_timeout(handle, 5000);
+        sqlite3_exec(handle, "PRAGMA cache_size = 10000;", nullptr, nullptr, nullptr);
+        sqlite3_exec(handle, "PRAGMA temp_store = MEMORY;", nullptr, nullptr, nullptr);
+        ScoringFunctions::registerWith(handle);
+
+        auto reader = std::make_unique<Reader>();
+        reader->handle = handle;
+        reader->statements = std::make_unique<StatementCache>(handle);
+        reader->statements->setQueryStats(stats);
+
+        idle_.push_back(reader.get());
+        readers_.push_back(std::move(reader));
+    }
+}
+
+ConnectionPool::~ConnectionPool() {
+    for (auto& reader : readers_) {
+        reader->statements.reset();
+        sqlite3_close(reader->handle);
+    }
+}
+
+ConnectionPool::Lease ConnectionPool::acquire(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::thread::id self = std::this_thread::get_id();
+
+    for (auto& reader : readers_) {
+        if (reader->leases > 0 && reader->owner == self) {
+            reader->leases++;
+            leases_granted_++;
+            return Lease(this, reader.get());
+        }
+    }
+
+    if (idle_.empty()) {
+        lease_waits_++;
+        if (!available_.wait_for(lock, timeout, [this] { return !idle_.empty(); })) {
+            lease_timeouts_++;
+            return Lease();
+        }
+    }
+
+    Reader* reader = idle_.back();
+    idle_.pop_back();
+    reader->owner = self;
+    reader->leases = 1;
+    leases_granted_++;
+
+    return Lease(this, reader);
+}
+
+void ConnectionPool::release(Reader* reader) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--reader->leases > 0) {
+            return;
+        }
+        reader->owner = std::thread::id();
+        idle_.push_back(reader);
+    }
+    available_.notify_one();
+}
+
+uint64_t ConnectionPool::leasesGranted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return leases_granted_;
+}
+
+uint64_t ConnectionPool::leaseWaits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lease_waits_;
+}
+
+uint64_t ConnectionPool::leaseTimeouts() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lease_timeouts_;
+}
@@ -0,0 +1,85 @@
+// Reader connection pool - concurrent WAL reads alongside the writer
+#pragma once
+#include "statement_cache.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct sqlite3;
+
+/**
+ * Connection Pool - N read-only connections to the database file
+ * In WAL mode every reader sees the last committed snapshot without taking
+ * the writer's lock, so analytics, agents and UI refreshes read in parallel
+ * with writes. Each reader keeps its own statement cache.
+ *
+ * Leases are reentrant per thread: a thread that already holds a reader
+ * (a forEachRow visitor that queries again, say) shares it instead of
+ * waiting for a second one, which could never come once every reader is
+ * held that way. A thread that still finds no reader free within the
+ * timeout gets an empty lease and the caller reads on the writer.
+ */
+class ConnectionPool {
+public:
+    struct Reader {
+        sqlite3* handle = nullptr;
+        std::unique_ptr<StatementCache> statements;
+        std::thread::id owner;  // thread holding the leases
+        size_t leases = 0;
+    };
+
+    /**
+     * Lease - use of one reader by the acquiring thread, returned to the
+     * pool when that thread's last lease on it is destroyed
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(ConnectionPool* pool, Reader* reader) : pool_(pool), reader_(reader) {}
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        explicit operator bool() const { return reader_ != nullptr; }
+        Reader* operator->() const { return reader_; }
+
+    private:
+        ConnectionPool* pool_ = nullptr;
+        Reader* reader_ = nullptr;
+    };
+
+    ConnectionPool(const std::string& path, size_t reader_count, QueryStats* stats = nullptr);
+    ~ConnectionPool();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // The reader this thread already holds, else waits up to timeout for a
+    // free one; an empty lease when none came
+    Lease acquire(std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+
+    size_t readerCount() const { return readers_.size(); }
+    uint64_t leasesGranted() const;
+    uint64_t leaseWaits() const;
+    uint64_t leaseTimeouts() const;
+
+private:
+    void release(Reader* reader);
+
+    std::vector<std::unique_ptr<Reader>> readers_;
+    std::vector<Reader*> idle_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    uint64_t leases_granted_ = 0;
+    uint64_t lease_waits_ = 0;
+    uint64_t lease_timeouts_ = 0;
+};
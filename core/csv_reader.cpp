@@ -0,0 +1,374 @@
+// CSV reader for Riley Corpbrain - mapped, chunked, parsed on worker threads
+#include "csv_reader.h"
+#include "csv_scanner.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace {
+
+// CRLF or LF ends a record; a lone CR is data
+inline bool atRecordEnd(const char* p, const char* end) {
+    return *p == '\n' || (*p == '\r' && (p + 1 == end || p[1] == '\n'));
+}
+
+} // namespace
+
+void CsvChunk::clear() {
+    fields_.clear();
+    row_starts_.clear();
+    unescaped_.clear();
+    values_.clear();
+    width_ = 0;
+}
+
+void CsvChunk::setValues(std::vector<SqlValue> values, size_t width) {
+    values_ = std::move(values);
+    width_ = width;
+}
+
+CsvReader::CsvReader() : CsvReader(Options()) {}
+
+CsvReader::CsvReader(const Options& options) : options_(options) {
+    options_.chunk_bytes = std::max<size_t>(options_.chunk_bytes, 4096);
+}
+
+bool CsvReader::open(const std::string& path) {
+    header_.clear();
+    error_.clear();
+    text_.clear();
+
+    if (!file_.open(path)) {
+        error_ = file_.error();
+        return false;
+    }
+    data_ = file_.view();
+    return readHeader(path);
+}
+
+bool CsvReader::openText(std::string text) {
+    header_.clear();
+    error_.clear();
+    file_.close();
+
+    text_ = std::move(text);
+    data_ = text_;
+    return readHeader("text");
+}
+
+bool CsvReader::readHeader(const std::string& source) {
+    const char* data = data_.data();
+    size_t size = data_.size();
+    size_t start = 0;
+
+    if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        start = 3;
+    }
+    while (start < size && (data[start] == '\n' || data[start] == '\r')) {
+        start++;
+    }
+
+    data_start_ = nextBoundary(start, start + 1);
+
+    CsvChunk first;
+    parse(data + start, data + data_start_, options_.delimiter, first);
+    if (first.rowCount() == 0) {
+        error_ = "no header row in " + source;
+        return false;
+    }
+
+    // Column names are trimmed, blanks numbered, duplicates suffixed
+    std::set<std::string> seen;
+    for (size_t i = 0; i < first.fieldCount(0); i++) {
+        std::string name(first.fields(0)[i]);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        if (name.empty()) {
+            name = "column_" + std::to_string(i + 1);
+        }
+
+        std::string unique = name;
+        for (int n = 2; seen.count(unique); n++) {
+            unique = name + "_" + std::to_string(n);
+        }
+        seen.insert(unique);
+        header_.push_back(unique);
+    }
+
+    return true;
+}
+
+bool CsvReader::read(const std::function<bool(const CsvChunk&)>& consumer) {
+    return read(consumer, data_start_, data_.size());
+}
+
+bool CsvReader::read(const std::function<bool(const CsvChunk&)>& consumer, size_t begin, size_t end) {
+    return read(consumer, begin, end, nullptr);
+}
+
+bool CsvReader::read(const std::function<bool(const CsvChunk&)>& consumer, size_t begin, size_t end,
+                     const std::function<void(CsvChunk&)>& converter) {
+    if (header_.empty()) {
+        error_ = "no CSV file open";
+        return false;
+    }
+
+    size_t threads = options_.threads ? options_.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t window = options_.window ? options_.window : threads * 2;
+    size_t size = std::min(end, data_.size());
+
+    // Splitting is serialized so chunks are numbered in file order;
+    // parsing happens outside both locks
+    std::mutex split_mutex;
+    size_t position = std::max(begin, data_start_);
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::map<size_t, CsvChunk> parsed;
+    size_t issued = 0;
+    size_t consumed = 0;
+    size_t total = position >= size ? 0 : SIZE_MAX;  // known once the split reaches the end
+    bool stop = false;
+
+    auto worker = [&] {
+        while (true) {
+            size_t index, begin, end;
+            {
+                std::lock_guard<std::mutex> split(split_mutex);
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] { return stop || issued < consumed + window; });
+                    if (stop || position >= size) {
+                        return;
+                    }
+                }
+
+                begin = position;
+                end = std::min(nextBoundary(begin, begin + options_.chunk_bytes), size);
+                position = end;
+
+                std::lock_guard<std::mutex> lock(mutex);
+                index = issued++;
+                if (end >= size) {
+                    total = issued;
+                }
+            }
+
+            CsvChunk chunk;
+            parse(data_.data() + begin, data_.data() + end, options_.delimiter, chunk);
+            if (converter) {
+                converter(chunk);
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                parsed.emplace(index, std::move(chunk));
+            }
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; i++) {
+        workers.emplace_back(worker);
+    }
+
+    auto halt = [&] {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        changed.notify_all();
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    };
+
+    bool completed = true;
+    try {
+        for (size_t next = 0;; next++) {
+            CsvChunk chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return next >= total || parsed.count(next); });
+                if (next >= total) {
+                    break;
+                }
+                auto it = parsed.find(next);
+                chunk = std::move(it->second);
+                parsed.erase(it);
+            }
+
+            bool keep_going = consumer(chunk);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                consumed++;
+            }
+            changed.notify_all();
+
+            if (!keep_going) {
+                completed = false;
+                break;
+            }
+        }
+    } catch (...) {
+        halt();
+        throw;
+    }
+
+    halt();
+    return completed;
+}
+
+void CsvReader::parse(const char* p, const char* end, char delimiter, CsvChunk& chunk) {
+    if (chunk.row_starts_.empty()) {
+        chunk.row_starts_.push_back(chunk.fields_.size());
+    }
+
+    // Jumps to the next delimiter, quote or line end; a quote inside an
+    // unquoted field and a lone CR are plain data
+    CsvScanner scanner(end, delimiter);
+    auto fieldEnd = [&](const char* from) {
+        const char* hit = scanner.next(from);
+        while (hit < end && (*hit == '"' || !atRecordEnd(hit, end)) && *hit != delimiter) {
+            hit = scanner.next(hit + 1);
+        }
+        return hit;
+    };
+
+    while (p < end) {
+        if (atRecordEnd(p, end)) {
+            p += (*p == '\r') ? 2 : 1;  // blank line
+            continue;
+        }
+
+        while (true) {
+            if (p < end && *p == '"') {
+                const char* start = ++p;
+                const char* segment = start;
+                std::string* copy = nullptr;
+
+                // Quoted field: runs to a quote not followed by another
+                while (p < end) {
+                    p = static_cast<const char*>(std::memchr(p, '"', end - p));
+                    if (!p) {
+                        p = end;  // unterminated - take the rest
+                        break;
+                    }
+                    if (p + 1 < end && p[1] == '"') {
+                        if (!copy) {
+                            copy = &chunk.unescaped_.emplace_back();
+                        }
+                        copy->append(segment, p + 1 - segment);
+                        p += 2;
+                        segment = p;
+                        continue;
+                    }
+                    break;
+                }
+
+                const char* close = p;
+                if (p < end) {
+                    p++;
+                }
+
+                // Anything between the closing quote and the delimiter is kept
+                const char* tail = p;
+                p = fieldEnd(p);
+
+                if (copy || tail != p) {
+                    if (!copy) {
+                        copy = &chunk.unescaped_.emplace_back();
+                    }
+                    copy->append(segment, close - segment);
+                    copy->append(tail, p - tail);
+                    chunk.fields_.emplace_back(*copy);
+                } else {
+                    chunk.fields_.emplace_back(start, close - start);
+                }
+            } else {
+                const char* start = p;
+                p = fieldEnd(p);
+                chunk.fields_.emplace_back(start, p - start);
+            }
+
+            if (p < end && *p == delimiter) {
+                p++;
+                continue;
+            }
+
+            if (p < end && *p == '\r') {
+                p++;
+            }
+            if (p < end && *p == '\n') {
+                p++;
+            }
+            break;
+        }
+
+        chunk.row_starts_.push_back(chunk.fields_.size());
+    }
+}
+
+size_t CsvReader::nextBoundary(size_t from, size_t target) const {
+    return scanBoundaries(from, target, nullptr);
+}
+
+size_t CsvReader::lastBoundary(size_t from) const {
+    size_t last = from;
+    scanBoundaries(from, SIZE_MAX, &last);
+    return last;
+}
+
+size_t CsvReader::scanBoundaries(size_t from, size_t target, size_t* last) const {
+    const char* data = data_.data();
+    size_t size = data_.size();
+    const char* end = data + size;
+    char delimiter = options_.delimiter;
+    CsvScanner scanner(end, delimiter);
+    bool field_start = true;
+
+    const char* p = data + from;
+    while (p < end) {
+        if (field_start && *p == '"') {
+            p++;
+            while (true) {
+                p = static_cast<const char*>(std::memchr(p, '"', end - p));
+                if (!p) {
+                    return size;
+                }
+                p++;
+                if (p < end && *p == '"') {
+                    p++;
+                    continue;
+                }
+                break;
+            }
+            field_start = false;
+            continue;
+        }
+
+        const char* hit = scanner.next(p);
+        if (hit == end) {
+            break;
+        }
+        p = hit + 1;
+
+        if (*hit == '\n') {
+            if (static_cast<size_t>(p - data) >= target) {
+                return p - data;
+            }
+            if (last) {
+                *last = p - data;
+            }
+            field_start = true;
+        } else {
+            field_start = (*hit == delimiter);
+        }
+    }
+
+    return size;
+}
@@ -0,0 +1,118 @@
+// CSV reader - parallel RFC 4180 parsing over a memory-mapped file or buffer
+#pragma once
+#include "mapped_file.h"
+#include "statement_cache.h"
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * CsvChunk - the parsed records of one slice of the file
+ * Unquoted fields, and quoted ones without "" escapes, are views straight
+ * into the mapping; only fields that need unescaping are copied, into the
+ * chunk's own storage. Views stay valid while the chunk and file live.
+ * A read() converter may also fill in typed values, a fixed width per row.
+ */
+class CsvChunk {
+public:
+    size_t rowCount() const { return row_starts_.empty() ? 0 : row_starts_.size() - 1; }
+    size_t fieldCount(size_t row) const { return row_starts_[row + 1] - row_starts_[row]; }
+    const std::string_view* fields(size_t row) const { return fields_.data() + row_starts_[row]; }
+
+    size_t width() const { return width_; }
+    const SqlValue* values(size_t row) const { return values_.data() + row * width_; }
+    void setValues(std::vector<SqlValue> values, size_t width);
+
+    void clear();
+
+private:
+    friend class CsvReader;
+
+    std::vector<std::string_view> fields_;
+    std::vector<size_t> row_starts_;  // index into fields_ per row, plus an end marker
+    std::deque<std::string> unescaped_;  // deque: growing it never moves earlier strings
+    std::vector<SqlValue> values_;  // rowCount() * width_, row-major
+    size_t width_ = 0;
+};
+
+/**
+ * CSV Reader - splits a mapped file into chunks at record boundaries and
+ * parses them on worker threads
+ * Chunks are handed to the consumer on the calling thread in file order,
+ * so a single writer can load them while later chunks are still being
+ * parsed. At most `window` parsed chunks wait in memory at once. A
+ * converter passed to read() runs on the worker right after parsing, so
+ * per-field work such as type conversion stays off the consumer thread.
+ *
+ * Boundaries come from a light sequential scan that applies the parser's
+ * own quoting rule (a quote opens a field only at its start), so a
+ * quoted newline never splits a record and a stray quote such as 12"
+ * cannot throw the split off. The scan only tracks quote state - it is
+ * far cheaper than parsing, which runs on the workers.
+ *
+ * Parsing follows RFC 4180 with the usual leniencies: LF or CRLF line
+ * ends, a UTF-8 BOM is skipped, blank lines are skipped, and text after a
+ * closing quote is kept literally.
+ */
+class CsvReader {
+public:
+    struct Options {
+        char delimiter = ',';
+        size_t threads = 0;  // 0 = hardware concurrency
+        size_t chunk_bytes = 8 << 20;
+        size_t window = 0;  // 0 = two chunks per thread
+    };
+
+    CsvReader();
+    explicit CsvReader(const Options& options);
+
+    CsvReader(const CsvReader&) = delete;  // views point into the reader's own data
+    CsvReader& operator=(const CsvReader&) = delete;
+
+    // Maps the file and parses the header record
+    bool open(const std::string& path);
+
+    // Takes CSV already read into memory, header first - for files that may
+    // be truncated while open, where a mapping would fault
+    bool openText(std::string text);
+
+    const std::vector<std::string>& header() const { return header_; }
+    const std::string& error() const { return error_; }
+    size_t bytes() const { return data_.size(); }
+    std::string_view view() const { return data_; }
+    size_t dataStart() const { return data_start_; }  // first record after the header
+
+    // Parses every data record; the consumer returns false to stop early
+    bool read(const std::function<bool(const CsvChunk&)>& consumer);
+
+    // Parses the records in [begin, end), both record boundaries
+    bool read(const std::function<bool(const CsvChunk&)>& consumer, size_t begin, size_t end);
+    bool read(const std::function<bool(const CsvChunk&)>& consumer, size_t begin, size_t end,
+              const std::function<void(CsvChunk&)>& converter);
+
+    // Parses the whole records in [begin, end) into chunk
+    static void parse(const char* begin, const char* end, char delimiter, CsvChunk& chunk);
+
+    // First record boundary at or after target, scanning from the record
+    // start `from`; size of the file when there is none
+    size_t nextBoundary(size_t from, size_t target) const;
+
+    // End of the last whole record after the record start `from`; a record
+    // still being written (no line end yet, or an open quote) is left out
+    size_t lastBoundary(size_t from) const;
+
+private:
+    bool readHeader(const std::string& source);
+    size_t scanBoundaries(size_t from, size_t target, size_t* last) const;
+
+    Options options_;
+    MappedFile file_;
+    std::string text_;       // openText() input
+    std::string_view data_;  // the mapping or text_
+    size_t data_start_ = 0;
+    std::vector<std::string> header_;
+    std::string error_;
+};
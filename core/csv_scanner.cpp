@@ -0,0 +1,151 @@
+// CSV scanner for Riley Corpbrain - AVX2 / SSE4.2 / scalar block classifier
+#include "csv_scanner.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RILEY_CSV_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define RILEY_TARGET(features)
+#else
+#define RILEY_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+namespace {
+
+uint64_t classifyScalar(const char* block, char delimiter) {
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++) {
+        char c = block[i];
+        bool structural = c == delimiter || c == '"' || c == '\n' || c == '\r';
+        mask |= static_cast<uint64_t>(structural) << i;
+    }
+    return mask;
+}
+
+#ifdef RILEY_CSV_X86
+
+RILEY_TARGET("sse4.2")
+uint64_t classifySSE42(const char* block, char delimiter) {
+    // "Equal any" against the four structural characters, one bit per byte
+    const __m128i set = _mm_setr_epi8(delimiter, '"', '\n', '\r', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    uint64_t mask = 0;
+    for (int lane = 0; lane < 4; lane++) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + lane * 16));
+        __m128i hits = _mm_cmpestrm(set, 4, bytes, 16, _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK);
+        mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_cvtsi128_si32(hits))) << (lane * 16);
+    }
+    return mask;
+}
+
+RILEY_TARGET("avx2")
+uint64_t classifyAVX2(const char* block, char delimiter) {
+    const __m256i delimiters = _mm256_set1_epi8(delimiter);
+    const __m256i quotes = _mm256_set1_epi8('"');
+    const __m256i newlines = _mm256_set1_epi8('\n');
+    const __m256i returns = _mm256_set1_epi8('\r');
+
+    uint64_t mask = 0;
+    for (int half = 0; half < 2; half++) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + half * 32));
+        __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, delimiters), _mm256_cmpeq_epi8(v, quotes)),
+                                       _mm256_or_si256(_mm256_cmpeq_epi8(v, newlines), _mm256_cmpeq_epi8(v, returns)));
+        mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hits))) << (half * 32);
+    }
+    return mask;
+}
+
+CsvScanner::Level cpuLevel() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool sse42 = (info[2] & (1 << 20)) != 0;
+    bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+
+    bool avx2 = false;
+    if (max_leaf >= 7 && os_avx) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    bool sse42 = __builtin_cpu_supports("sse4.2");
+    bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2) {
+        return CsvScanner::Level::AVX2;
+    }
+    return sse42 ? CsvScanner::Level::SSE42 : CsvScanner::Level::Scalar;
+}
+
+#else
+
+CsvScanner::Level cpuLevel() {
+    return CsvScanner::Level::Scalar;
+}
+
+#endif
+
+std::atomic<CsvScanner::Level>& activeLevel() {
+    static std::atomic<CsvScanner::Level> level{CsvScanner::detectedLevel()};
+    return level;
+}
+
+} // namespace
+
+uint64_t CsvScanner::classify(const char* block, char delimiter) {
+    switch (level()) {
+#ifdef RILEY_CSV_X86
+    case Level::AVX2:
+        return classifyAVX2(block, delimiter);
+    case Level::SSE42:
+        return classifySSE42(block, delimiter);
+#endif
+    default:
+        return classifyScalar(block, delimiter);
+    }
+}
+
+CsvScanner::Level CsvScanner::detectedLevel() {
+    static const Level detected = cpuLevel();
+    return detected;
+}
+
+CsvScanner::Level CsvScanner::level() {
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+void CsvScanner::setLevel(Level level) {
+    activeLevel().store(level < detectedLevel() ? level : detectedLevel(), std::memory_order_relaxed);
+}
+
+const char* CsvScanner::levelName(Level level) {
+    switch (level) {
+    case Level::AVX2:
+        return "AVX2";
+    case Level::SSE42:
+        return "SSE4.2";
+    default:
+        return "scalar";
+    }
+}
+
+void CsvScanner::load(const char* p) {
+    block_ = p;
+    if (end_ - p >= 64) {
+        mask_ = classify(p, delimiter_);
+        return;
+    }
+
+    // Short tail: classify a padded copy and drop the bits past the end
+    char padded[64] = {};
+    size_t size = static_cast<size_t>(end_ - p);
+    std::memcpy(padded, p, size);
+    mask_ = classify(padded, delimiter_) & ((uint64_t{1} << size) - 1);
+}
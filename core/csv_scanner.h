@@ -0,0 +1,71 @@
+// CSV scanner - SIMD classification of CSV structural characters
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/**
+ * CSV Scanner - finds the bytes the CSV parser has to look at
+ * The input is classified 64 bytes at a time into a bitmask of its
+ * structural characters (delimiter, quote, CR, LF); next() then jumps
+ * between set bits with a count-trailing-zeros, so plain field bytes are
+ * never examined one at a time. Each block is classified once however
+ * many fields it holds.
+ *
+ * The classifier is picked at runtime: AVX2 (two 32-byte compares per
+ * block), SSE4.2 (PCMPESTRM "equal any" over 16-byte lanes) or a scalar
+ * loop on other CPUs. setLevel() forces a lower level for benchmarks.
+ */
+class CsvScanner {
+public:
+    enum class Level { Scalar, SSE42, AVX2 };
+
+    CsvScanner(const char* end, char delimiter) : end_(end), delimiter_(delimiter), block_(end) {}
+
+    // First structural byte at or after p, or end
+    const char* next(const char* p) {
+        while (p < end_) {
+            if (p < block_ || static_cast<size_t>(p - block_) >= 64) {
+                load(p);
+            }
+            uint64_t bits = mask_ >> (p - block_);
+            if (bits) {
+                return p + countTrailingZeros(bits);
+            }
+            if (end_ - block_ <= 64) {
+                break;
+            }
+            p = block_ + 64;
+        }
+        return end_;
+    }
+
+    // Bit i set when block[i] is the delimiter, '"', '\r' or '\n'
+    static uint64_t classify(const char* block, char delimiter);
+
+    static Level detectedLevel();
+    static Level level();
+    static void setLevel(Level level);  // clamped to what the CPU supports
+    static const char* levelName(Level level);
+
+private:
+    void load(const char* p);
+
+    static int countTrailingZeros(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+
+    const char* end_;
+    char delimiter_;
+    const char* block_;  // start of the classified block; end_ until the first load
+    uint64_t mask_ = 0;
+};
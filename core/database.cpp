@@ -1,5 +1,6 @@
 // SQLite database wrapper for Riley Corpbrain - Enterprise-grade data management
 #include "database.h"
+#include "scoring_functions.h"
 #include <sqlite3.h>
 #include <iostream>
 #include <fstream>
@@ -8,10 +9,12 @@
 #include <vector>
 
 // Constructor - Initialize SQLite database
-Database::Database() : db(nullptr) {
+Database::Database() : Database("riley_corpbrain.db") {}
+
+Database::Database(const std::string& path, size_t reader_connections) : db(nullptr), path_(path) {
     std::cout << "🗄️ INITIALIZING DATABASE..." << std::endl;
 
-    int rc = sqlite3_open("riley_corpbrain.db", reinterpret_cast<sqlite3**>(&db));
+    int rc = sqlite3_open(path.c_str(), reinterpret_cast<sqlite3**>(&db));
     if (rc != SQLITE_OK) {
         std::string error = "Cannot open database: ";
         error += sqlite3_errmsg(reinterpret_cast<sqlite3*>(db));
@@ -19,6 +22,12 @@ Database::Database() : db(nullptr) {
         throw std::runtime_error(error);
     }
 
+    statements_ = std::make_unique<StatementCache>(reinterpret_cast<sqlite3*>(db));
+    statements_->setQueryStats(&query_stats_);
+    row_cache_.attach(reinterpret_cast<sqlite3*>(db));
+    ScoringFunctions::registerWith(reinterpret_cast<sqlite3*>(db));
+    sqlite3_busy_timeout(reinterpret_cast<sqlite3*>(db), 5000);
+
     // Enable foreign keys and WAL mode for performance
     execute("PRAGMA foreign_keys = ON;");
     execute("PRAGMA journal_mode = WAL;");
@@ -27,13 +36,33 @@ Database::Database() : db(nullptr) {
     execute("PRAGMA temp_store = MEMORY;");
 
     // Initialize schema
+    migrator_ = std::make_unique<SchemaMigrator>(this);
     initializeSchema();
 
+    // Readers open after WAL mode and the schema are in place; an in-memory
+    // database is private to its connection, so it gets no pool
+    if (reader_connections > 0 && path != ":memory:" && !path.empty()) {
+        readers_ = std::make_unique<ConnectionPool>(path, reader_connections, &query_stats_);
+        std::cout << "📚 Reader pool ready (" << reader_connections << " connections)" << std::endl;
+    }
+
     std::cout << "✅ Database initialized successfully" << std::endl;
 }
 
 // Destructor - Clean shutdown
 Database::~Database() {
+    // Partitions queue rollup writes, so they go before the queue drains
+    partitions_.reset();
+
+    // Commit whatever is still queued while the writer is open
+    write_queue_ = nullptr;
+    write_queue_owner_.reset();
+
+    // Finalize cached statements before closing the connections
+    replica_.reset();
+    readers_.reset();
+    statements_.reset();
+
     if (db) {
         sqlite3_close(reinterpret_cast<sqlite3*>(db));
         std::cout << "✅ Database connection closed" << std::endl;
@@ -47,8 +76,14 @@ bool Database::execute(const std::string& sql) {
         return false;
     }
 
+    waitForQueuedWrites();
+    auto writer = lockWriter();
+
     char* errMsg = nullptr;
+    auto start = std::chrono::steady_clock::now();
     int rc = sqlite3_exec(reinterpret_cast<sqlite3*>(db), sql.c_str(), nullptr, nullptr, &errMsg);
+    query_stats_.record(reinterpret_cast<sqlite3*>(db), sql, std::chrono::steady_clock::now() - start,
+                        rc != SQLITE_OK);
 
     if (rc != SQLITE_OK) {
         std::cerr << "❌ SQL error: " << errMsg << std::endl;
@@ -63,36 +98,382 @@ bool Database::execute(const std::string& sql) {
 std::vector<std::map<std::string, std::string>> Database::query(const std::string& sql) {
     std::vector<std::map<std::string, std::string>> results;
 
+    forEachRow(sql, [&results](const RowView& row) {
+        std::map<std::string, std::string> values;
+
+        for (int i = 0; i < row.columnCount(); i++) {
+            values[row.columnName(i)] = std::string(row.getText(i));
+        }
+
+        results.push_back(std::move(values));
+        return true;
+    });
+
+    return results;
+}
+
+// Query into a columnar table
+ColumnarResult Database::queryColumnar(const std::string& sql) {
+    ColumnarResult result;
+
+    forEachRow(sql, [&result](const RowView& row) {
+        result.appendRow(row);
+        return true;
+    });
+
+    return result;
+}
+
+// Open a forward-only cursor over a cached statement
+RowCursor Database::openCursor(const std::string& sql) {
+    return RowCursor(prepareRead(sql));
+}
+
+// Visit each row as it is stepped, without materializing the result set
+bool Database::forEachRow(const std::string& sql, const std::function<bool(const RowView&)>& visitor) {
+    PreparedStatement stmt = prepareRead(sql);
+    if (!stmt) {
+        return false;
+    }
+    return forEachRow(stmt, visitor);
+}
+
+bool Database::forEachRow(PreparedStatement& stmt, const std::function<bool(const RowView&)>& visitor) {
+    RowView row(&stmt);
+
+    while (stmt.step()) {
+        if (!visitor(row)) {
+            stmt.reset();
+            return true;
+        }
+    }
+
+    if (stmt.failed()) {
+        std::cerr << "❌ SQL step error: " << stmt.errorMessage() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Fetch a compiled statement from the cache, preparing it on first use
+PreparedStatement Database::prepare(const std::string& sql) {
     if (!db) {
         std::cerr << "❌ Database not initialized" << std::endl;
-        return results;
+        return PreparedStatement();
     }
 
-    sqlite3_stmt* stmt;
-    int rc = sqlite3_prepare_v2(reinterpret_cast<sqlite3*>(db), sql.c_str(), -1, &stmt, nullptr);
+    waitForQueuedWrites();
+    auto writer = lockWriter();
 
-    if (rc != SQLITE_OK) {
+    PreparedStatement stmt = statements_->acquire(sql);
+    if (!stmt) {
         std::cerr << "❌ SQL prepare error: " << sqlite3_errmsg(reinterpret_cast<sqlite3*>(db)) << std::endl;
-        return results;
+        return stmt;
     }
 
-    int columnCount = sqlite3_column_count(stmt);
+    // The writer stays with this thread until the statement is released
+    stmt.attachGuard(std::move(writer));
+    return stmt;
+}
 
-    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
-        std::map<std::string, std::string> row;
+// Fetch a statement for reading from a pooled reader connection
+PreparedStatement Database::prepareRead(const std::string& sql) {
+    // Read-your-writes: a thread holding the writer (open transaction or
+    // live write statement) must see its own uncommitted changes, and a
+    // thread with queued writes must see them committed
+    waitForQueuedWrites();
+    if (!readers_ || writerHeldByCurrentThread()) {
+        return prepare(sql);
+    }
 
-        for (int i = 0; i < columnCount; i++) {
-            const char* columnName = sqlite3_column_name(stmt, i);
-            const char* columnValue = reinterpret_cast<const char*>(sqlite3_column_text(stmt, i));
+    // A pool drained by long scans falls back to the writer rather than
+    // blocking indefinitely
+    auto lease = std::make_shared<ConnectionPool::Lease>(readers_->acquire());
+    if (!*lease) {
+        return prepare(sql);
+    }
 
-            row[columnName] = columnValue ? columnValue : "";
+    PreparedStatement stmt = (*lease)->statements->acquire(sql);
+    if (!stmt || !sqlite3_stmt_readonly(stmt.handle())) {
+        // Writes, and SQL the reader cannot compile, go to the writer
+        return prepare(sql);
+    }
+
+    stmt.attachGuard(std::move(lease));
+    return stmt;
+}
+
+size_t Database::readerCount() const {
+    return readers_ ? readers_->readerCount() : 0;
+}
+
+// Start the analytics replica; an in-memory database has no file to copy
+bool Database::enableSnapshotReplica(const SnapshotReplica::Options& options) {
+    if (path_ == ":memory:" || path_.empty()) {
+        std::cerr << "⚠️ Snapshot replica needs a database file" << std::endl;
+        return false;
+    }
+
+    try {
+        replica_ = std::make_unique<SnapshotReplica>(path_, options, &query_stats_);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return false;
+    }
+
+    std::cout << "📸 Analytics replica ready (max staleness " << options.max_staleness.count()
+              << "s, copied in " << replica_->lastRefreshDuration().count() << "ms)" << std::endl;
+    return true;
+}
+
+bool Database::enableMetricPartitions(MetricPartitions::Options options) {
+    if (options.directory.empty()) {
+        if (path_ == ":memory:" || path_.empty()) {
+            std::cerr << "⚠️ Metric partitions need a directory for an in-memory database" << std::endl;
+            return false;
         }
+        options.directory = path_ + "-partitions";
+    }
 
-        results.push_back(row);
+    try {
+        partitions_ = std::make_unique<MetricPartitions>(this, options);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return false;
     }
 
-    sqlite3_finalize(stmt);
-    return results;
+    std::cout << "🗂️ Metric partitions ready in " << options.directory << " (raw retention "
+              << options.raw_retention_months << " months)" << std::endl;
+    return true;
+}
+
+PreparedStatement Database::prepareAnalytics(const std::string& sql) {
+    if (replica_) {
+        PreparedStatement stmt = replica_->prepare(sql);
+        if (stmt) {
+            return stmt;
+        }
+        // The copy may lack the table or have no reader free; the live file answers instead
+    }
+    return prepareRead(sql);
+}
+
+void Database::setSlowQueryThreshold(std::chrono::milliseconds threshold) {
+    query_stats_.setSlowThreshold(threshold);
+}
+
+void Database::cacheTable(const std::string& table) {
+    row_cache_.watch(table);
+}
+
+// Point lookup through the row cache
+std::map<std::string, std::string> Database::getRow(const std::string& table, int64_t rowid) {
+    RowCache::Row row;
+    if (!row_cache_.watches(table)) {
+        std::cerr << "⚠️ Table " << table << " is not cached" << std::endl;
+        return row;
+    }
+
+    // The cache holds committed rows only - a thread with its own pending
+    // changes must see them, so it goes to disk and caches nothing
+    waitForQueuedWrites();
+    bool own_changes = writerHeldByCurrentThread();
+    if (!own_changes && row_cache_.lookup(table, rowid, row)) {
+        return row;
+    }
+
+    uint64_t generation = row_cache_.generation();
+    PreparedStatement stmt = prepareRead("SELECT * FROM " + table + " WHERE rowid = ?1;");
+    if (!stmt || !stmt.bind(1, rowid)) {
+        return row;
+    }
+
+    bool found = false;
+    forEachRow(stmt, [&row, &found](const RowView& view) {
+        for (int i = 0; i < view.columnCount(); i++) {
+            row[view.columnName(i)] = std::string(view.getText(i));
+        }
+        found = true;
+        return false;
+    });
+
+    if (found && !own_changes) {
+        row_cache_.store(table, rowid, row, generation);
+    }
+    return row;
+}
+
+std::string Database::explainQueryPlan(const std::string& sql) {
+    if (!db) {
+        return "";
+    }
+
+    waitForQueuedWrites();
+    auto writer = lockWriter();
+    return QueryStats::explainQueryPlan(reinterpret_cast<sqlite3*>(db), sql);
+}
+
+// Lock the writer connection for the current thread
+std::shared_ptr<void> Database::lockWriter() {
+    writer_mutex_.lock();
+    writer_depth_++;
+    writer_owner_ = std::this_thread::get_id();
+
+    return std::shared_ptr<void>(nullptr, [this](void*) {
+        if (--writer_depth_ == 0) {
+            writer_owner_ = std::thread::id();
+        }
+        writer_mutex_.unlock();
+    });
+}
+
+bool Database::writerHeldByCurrentThread() const {
+    return writer_owner_.load() == std::this_thread::get_id();
+}
+
+// Transactions hold the writer lock from BEGIN until COMMIT/ROLLBACK
+bool Database::beginTransaction() {
+    // Settle this thread's queued writes first - the queue's writer thread
+    // cannot commit them once this thread holds the writer
+    waitForQueuedWrites();
+    auto writer = lockWriter();
+
+    if (!execute("BEGIN IMMEDIATE;")) {
+        return false;
+    }
+
+    transaction_guard_ = std::move(writer);
+    return true;
+}
+
+bool Database::commitTransaction() {
+    if (!execute("COMMIT;")) {
+        return false;
+    }
+
+    transaction_guard_.reset();
+    return true;
+}
+
+bool Database::rollbackTransaction() {
+    bool ok = execute("ROLLBACK;");
+    transaction_guard_.reset();
+    return ok;
+}
+
+// Execute a single statement with positional text parameters (?1, ?2, ...)
+bool Database::executeWithParams(const std::string& sql, const std::vector<std::string>& params) {
+    PreparedStatement stmt = prepare(sql);
+    if (!stmt) {
+        return false;
+    }
+
+    for (size_t i = 0; i < params.size(); i++) {
+        if (!stmt.bind(static_cast<int>(i + 1), params[i])) {
+            std::cerr << "❌ SQL bind error: " << stmt.errorMessage() << std::endl;
+            return false;
+        }
+    }
+
+    if (!stmt.execute()) {
+        std::cerr << "❌ SQL error: " << stmt.errorMessage() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int64_t Database::lastInsertId() const {
+    return static_cast<int64_t>(sqlite3_last_insert_rowid(reinterpret_cast<sqlite3*>(db)));
+}
+
+// Queue a write for the next group commit
+std::future<bool> Database::enqueueWrite(const std::string& sql, std::vector<SqlValue> params,
+                                         bool read_your_writes) {
+    // Inside this thread's own transaction there is nothing to group with,
+    // and queueing would deadlock against the writer this thread holds
+    if (writerHeldByCurrentThread()) {
+        PreparedStatement stmt = prepare(sql);
+        bool ok = stmt.valid();
+        for (size_t i = 0; ok && i < params.size(); i++) {
+            ok = stmt.bindValue(static_cast<int>(i + 1), params[i]);
+        }
+        ok = ok && stmt.execute();
+        if (!ok && stmt) {
+            std::cerr << "❌ SQL error: " << stmt.errorMessage() << std::endl;
+        }
+
+        std::promise<bool> done;
+        done.set_value(ok);
+        return done.get_future();
+    }
+
+    uint64_t sequence = 0;
+    std::future<bool> result = writeQueue()->submit(sql, std::move(params), &sequence);
+    if (!read_your_writes) {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(write_queue_mutex_);
+    queued_by_thread_[std::this_thread::get_id()] = sequence;
+    return result;
+}
+
+void Database::setWriteQueueOptions(const WriteQueue::Options& options) {
+    std::lock_guard<std::mutex> lock(write_queue_mutex_);
+    if (write_queue_owner_) {
+        std::cerr << "⚠️ Write queue already running - options ignored" << std::endl;
+        return;
+    }
+    write_queue_options_ = options;
+}
+
+void Database::flushWrites() {
+    if (WriteQueue* queue = write_queue_.load()) {
+        queue->flush();
+    }
+}
+
+WriteQueue* Database::writeQueue() {
+    if (WriteQueue* queue = write_queue_.load()) {
+        return queue;
+    }
+
+    std::lock_guard<std::mutex> lock(write_queue_mutex_);
+    if (!write_queue_owner_) {
+        write_queue_owner_ = std::make_unique<WriteQueue>(this, write_queue_options_);
+        write_queue_ = write_queue_owner_.get();
+        std::cout << "📨 Write queue started (batch " << write_queue_options_.max_batch_size
+                  << ", " << write_queue_options_.max_latency.count() << "ms)" << std::endl;
+    }
+    return write_queue_owner_.get();
+}
+
+// Block until the writes this thread queued have been committed
+void Database::waitForQueuedWrites() {
+    WriteQueue* queue = write_queue_.load();
+    if (!queue || writerHeldByCurrentThread()) {
+        return;
+    }
+
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(write_queue_mutex_);
+        auto it = queued_by_thread_.find(std::this_thread::get_id());
+        if (it == queued_by_thread_.end()) {
+            return;
+        }
+        sequence = it->second;
+    }
+
+    queue->waitFor(sequence);
+
+    std::lock_guard<std::mutex> lock(write_queue_mutex_);
+    auto it = queued_by_thread_.find(std::this_thread::get_id());
+    if (it != queued_by_thread_.end() && it->second == sequence) {
+        queued_by_thread_.erase(it);
+    }
 }
 
 // Initialize database schema from schema.sql
@@ -108,22 +489,45 @@ void Database::initializeSchema() {
     buffer << schemaFile.rdbuf();
     std::string schema = buffer.str();
 
-    if (!execute(schema)) {
+    if (!ensureSchema("core", schema)) {
         throw std::runtime_error("Failed to initialize database schema");
     }
 
     // Add additional enterprise tables
     createEnterpriseSchema();
 
-    std::cout << "✅ Schema loaded successfully" << std::endl;
+    std::cout << "✅ Schema loaded successfully (" << migrator_->appliedCount() << " applied, "
+              << migrator_->skippedCount() << " unchanged)" << std::endl;
+}
+
+// Apply a component's DDL unless it is already in place
+bool Database::ensureSchema(const std::string& component, const std::string& ddl) {
+    std::lock_guard<std::mutex> lock(schema_mutex_);
+    size_t applied = migrator_->appliedCount();
+    bool ok = migrator_->ensure(component, ddl);
+    if (replica_ && migrator_->appliedCount() != applied) {
+        replica_->refresh();  // the copy predates the new tables
+    }
+    return ok;
+}
+
+// Bring a table created in an older layout up to the module's columns
+bool Database::ensureColumns(const std::string& table, const std::vector<ColumnSpec>& columns) {
+    std::lock_guard<std::mutex> lock(schema_mutex_);
+    size_t added = migrator_->columnsAddedCount();
+    bool ok = migrator_->ensureColumns(table, columns);
+    if (replica_ && migrator_->columnsAddedCount() != added) {
+        replica_->refresh();
+    }
+    return ok;
 }
 
 // Create additional enterprise tables
 void Database::createEnterpriseSchema() {
     std::cout << "🏢 Creating enterprise schema extensions..." << std::endl;
 
-    // Financial tables
-    execute(R"(
+    std::string ddl = R"(
+        -- Financial tables
         CREATE TABLE IF NOT EXISTS financial_transactions (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             type TEXT NOT NULL,
@@ -136,10 +540,8 @@ void Database::createEnterpriseSchema() {
             FOREIGN KEY(project_id) REFERENCES projects(id),
             FOREIGN KEY(employee_id) REFERENCES employees(id)
         );
-    )");
 
-    // Inventory tables
-    execute(R"(
+        -- Inventory tables
         CREATE TABLE IF NOT EXISTS inventory_items (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             name TEXT NOT NULL,
@@ -152,10 +554,8 @@ void Database::createEnterpriseSchema() {
             location TEXT,
             created_at TEXT DEFAULT CURRENT_TIMESTAMP
         );
-    )");
 
-    // Compliance tables
-    execute(R"(
+        -- Compliance tables
         CREATE TABLE IF NOT EXISTS compliance_audits (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             audit_type TEXT NOT NULL,
@@ -167,10 +567,8 @@ void Database::createEnterpriseSchema() {
             created_at TEXT DEFAULT CURRENT_TIMESTAMP,
             FOREIGN KEY(assigned_to) REFERENCES employees(id)
         );
-    )");
 
-    // Performance metrics
-    execute(R"(
+        -- Performance metrics
         CREATE TABLE IF NOT EXISTS performance_metrics (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             metric_name TEXT NOT NULL,
@@ -180,36 +578,23 @@ void Database::createEnterpriseSchema() {
             period TEXT,
             created_at TEXT DEFAULT CURRENT_TIMESTAMP
         );
-    )");
 
-    std::cout << "✅ Enterprise schema extensions created" << std::endl;
-}
-
-#include <sqlite3.h>
-#include <string>
+        -- Command execution log, written through the group-commit queue
+        CREATE TABLE IF NOT EXISTS command_log (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            command_id TEXT NOT NULL,
+            source TEXT,
+            action TEXT,
+            success INTEGER NOT NULL,
+            result TEXT,
+            created_at TEXT DEFAULT CURRENT_TIMESTAMP
+        );
+    )";
 
-class Database {
-public:
-    Database() {
-        if (sqlite3_open("../data/corpbrain.sqlite", &db)) {
-            // Handle error
-        }
-        // Optionally, run schema.sql to initialize tables
-    }
-    ~Database() {
-        sqlite3_close(db);
-    }
-    // Example query method
-    bool execute(const std::string& sql) {
-        char* errMsg = nullptr;
-        int rc = sqlite3_exec(db, sql.c_str(), 0, 0, &errMsg);
-        if (rc != SQLITE_OK) {
-            sqlite3_free(errMsg);
-            return false;
-        }
-        return true;
+    if (!ensureSchema("enterprise", ddl)) {
+        std::cerr << "❌ Failed to create enterprise schema" << std::endl;
+        return;
     }
-    // Add more query and fetch methods as needed
-private:
-    sqlite3* db;
-};
+
+    std::cout << "✅ Enterprise schema extensions created" << std::endl;
+}
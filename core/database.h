@@ -1,30 +1,145 @@
 // Database header - Enterprise-grade data management
 #pragma once
+#include "statement_cache.h"
+#include "row_cursor.h"
+#include "columnar_result.h"
+#include "connection_pool.h"
+#include "write_queue.h"
+#include "schema_migrator.h"
+#include "query_stats.h"
+#include "snapshot_replica.h"
+#include "row_cache.h"
+#include "metric_partitions.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <map>
 
 class Database {
 public:
     Database();
+    explicit Database(const std::string& path, size_t reader_connections = 4);
     ~Database();
 
     // Core database operations
+    // Reads (query, cursors, columnar) run on pooled read-only WAL connections;
+    // writes and transactions go through the single writer connection.
     bool execute(const std::string& sql);
     std::vector<std::map<std::string, std::string>> query(const std::string& sql);
 
+    // Streaming reads - rows are visited while sqlite3_step runs, so memory
+    // stays constant regardless of how many rows the query returns.
+    // The visitor returns false to stop early.
+    RowCursor openCursor(const std::string& sql);
+    bool forEachRow(const std::string& sql, const std::function<bool(const RowView&)>& visitor);
+    static bool forEachRow(PreparedStatement& stmt, const std::function<bool(const RowView&)>& visitor);
+
+    // Materialized reads in columnar form - column names stored once,
+    // numbers kept as int64/double instead of per-row strings
+    ColumnarResult queryColumnar(const std::string& sql);
+
     // Schema management
+    // DDL goes through the migrator: a component whose DDL text is unchanged
+    // since it was last applied is skipped entirely
     void initializeSchema();
     void createEnterpriseSchema();
+    bool ensureSchema(const std::string& component, const std::string& ddl);
+    bool ensureColumns(const std::string& table, const std::vector<ColumnSpec>& columns);
 
     // Transaction support
+    // The writer stays locked to the calling thread until commit/rollback,
+    // which must be issued from that same thread. Reads from that thread are
+    // routed to the writer meanwhile, so they see the uncommitted changes.
     bool beginTransaction();
     bool commitTransaction();
     bool rollbackTransaction();
 
     // Prepared statements for performance
+    // Statements come from a per-connection cache keyed by SQL text, so bind
+    // values as parameters rather than formatting them into the SQL string.
+    PreparedStatement prepare(const std::string& sql);       // writer connection
+    PreparedStatement prepareRead(const std::string& sql);   // pooled reader
     bool executeWithParams(const std::string& sql, const std::vector<std::string>& params);
+    int64_t lastInsertId() const;
+
+    // Group-commit writes - queued statements are committed in batches by a
+    // background writer thread; the future reports durability. Reads and
+    // writes issued later from the same thread wait for that thread's queued
+    // writes first, unless read_your_writes is false (fire-and-forget logs
+    // that the thread never reads back). Options only apply before the first
+    // enqueueWrite().
+    std::future<bool> enqueueWrite(const std::string& sql, std::vector<SqlValue> params = {},
+                                   bool read_your_writes = true);
+    void setWriteQueueOptions(const WriteQueue::Options& options);
+    void flushWrites();
+    WriteQueue* writeQueue();
+
+    size_t readerCount() const;
+
+    // Analytics replica - an in-memory copy refreshed through the online
+    // backup API, so long aggregations never hold read transactions on the
+    // live file. Reads through it lag the database by up to max_staleness.
+    bool enableSnapshotReplica(const SnapshotReplica::Options& options = SnapshotReplica::Options());
+    SnapshotReplica* snapshotReplica() const { return replica_.get(); }
+    PreparedStatement prepareAnalytics(const std::string& sql);  // replica, else a pooled reader
+
+    // Time series - raw points partitioned into monthly files next to the
+    // database, hourly/daily/monthly rollups in metric_rollups. An empty
+    // directory means "<database path>-partitions".
+    bool enableMetricPartitions(MetricPartitions::Options options = MetricPartitions::Options());
+    MetricPartitions* metricPartitions() const { return partitions_.get(); }
+
+    // Latency histograms per normalized statement and the slow-query log,
+    // covering the writer and every pooled reader
+    QueryStats& queryStats() { return query_stats_; }
+    void setSlowQueryThreshold(std::chrono::milliseconds threshold);
+
+    // Cached point lookups by rowid (INTEGER PRIMARY KEY) on hot tables -
+    // commits through the writer evict exactly the rows they touched.
+    // A thread with its own uncommitted or queued writes reads from disk.
+    void cacheTable(const std::string& table);
+    std::map<std::string, std::string> getRow(const std::string& table, int64_t rowid);
+    RowCache& rowCache() { return row_cache_; }
+
+    // Plan from a fresh compile on the writer, so it reflects the current
+    // schema (cached EXPLAIN statements keep the plan they were built with)
+    std::string explainQueryPlan(const std::string& sql);
 
 private:
-    void* db;  // SQLite database handle
+    std::shared_ptr<void> lockWriter();
+    bool writerHeldByCurrentThread() const;
+    void waitForQueuedWrites();
+
+    void* db;  // SQLite database handle (writer)
+    std::string path_;
+    QueryStats query_stats_;  // outlives the statement caches that report to it
+    RowCache row_cache_;      // hooked into the writer until it closes
+    std::unique_ptr<StatementCache> statements_;
+    std::unique_ptr<ConnectionPool> readers_;
+    std::unique_ptr<SnapshotReplica> replica_;
+    std::unique_ptr<MetricPartitions> partitions_;
+    std::unique_ptr<SchemaMigrator> migrator_;
+    std::mutex schema_mutex_;
+
+    // Writer ownership - recursive so a thread inside a transaction can
+    // keep issuing statements
+    std::recursive_mutex writer_mutex_;
+    std::atomic<std::thread::id> writer_owner_;
+    int writer_depth_ = 0;
+    std::shared_ptr<void> transaction_guard_;
+
+    // Write queue, started on first use
+    std::mutex write_queue_mutex_;
+    WriteQueue::Options write_queue_options_;
+    std::unique_ptr<WriteQueue> write_queue_owner_;
+    std::atomic<WriteQueue*> write_queue_{nullptr};
+    std::unordered_map<std::thread::id, uint64_t> queued_by_thread_;
 };
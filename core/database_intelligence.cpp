@@ -1,88 +1,376 @@
 #include "database_intelligence.h"
+#include "database.h"
+#include "csv_reader.h"
+#include "bulk_loader.h"
+#include "json_reader.h"
+#include "xlsx_reader.h"
+#include "type_inference.h"
+#include "column_profiler.h"
 #include <iostream>
-#include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cctype>
 #include <regex>
 #include <chrono>
 #include <iomanip>
+#include <unordered_map>
 
-DatabaseIntelligence::DatabaseIntelligence(SchemaModel* schema) : schema_(schema) {
+DatabaseIntelligence::DatabaseIntelligence(SchemaModel* schema)
+    : schema_(schema), sync_store_(schema->getDatabase()) {
+    // Sources that were live when the last process stopped carry on from
+    // their stored offsets
+    sync_status_ = sync_store_.load();
+    size_t resumed = 0;
+    for (const auto& entry : sync_status_) {
+        if (entry.second.active) {
+            sync_watcher_.watch(entry.second.path);
+            sync_dirty_.insert(entry.first);
+            resumed++;
+        }
+    }
+    if (resumed > 0) {
+        sync_thread_ = std::thread(&DatabaseIntelligence::runLiveSync, this);
+        std::cout << "Resuming live sync for " << resumed << " source(s)" << std::endl;
+    }
     std::cout << "Database Intelligence Engine initialized" << std::endl;
 }
 
+DatabaseIntelligence::~DatabaseIntelligence() {
+    {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        sync_stopping_ = true;
+    }
+    sync_watcher_.wake();
+    if (sync_thread_.joinable()) {
+        sync_thread_.join();
+    }
+}
+
 bool DatabaseIntelligence::ingestCSV(const std::string& file_path, const std::string& table_name) {
     std::cout << "Ingesting CSV file: " << file_path << " into table: " << table_name << std::endl;
     
-    std::ifstream file(file_path);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open CSV file: " << file_path << std::endl;
+    // The file is mapped and parsed on worker threads; this thread is the
+    // single writer, loading chunks in file order as they become ready
+    CsvReader reader;
+    if (!reader.open(file_path)) {
+        std::cerr << "Failed to open CSV file: " << reader.error() << std::endl;
+        return false;
+    }
+    std::vector<TypeInference::Column> columns;
+    return loadCSV(reader, reader.dataStart(), reader.bytes(), table_name, {}, columns, nullptr);
+}
+
+bool DatabaseIntelligence::upsertCSV(const std::string& file_path, const std::string& table_name,
+                                     const std::vector<std::string>& key_columns, UpsertResult* result) {
+    std::cout << "Upserting CSV file: " << file_path << " into table: " << table_name << std::endl;
+    if (key_columns.empty()) {
+        std::cerr << "Upsert needs at least one key column" << std::endl;
         return false;
     }
     
-    std::string line;
-    std::vector<std::string> headers;
-    bool first_line = true;
-    int rows_processed = 0;
+    CsvReader reader;
+    if (!reader.open(file_path)) {
+        std::cerr << "Failed to open CSV file: " << reader.error() << std::endl;
+        return false;
+    }
+    const auto& headers = reader.header();
+    for (const auto& key : key_columns) {
+        if (std::find(headers.begin(), headers.end(), key) == headers.end()) {
+            std::cerr << "Key column " << key << " is not in " << file_path << std::endl;
+            return false;
+        }
+    }
+    std::vector<TypeInference::Column> columns;
+    return loadCSV(reader, reader.dataStart(), reader.bytes(), table_name, key_columns, columns, result);
+}
+
+bool DatabaseIntelligence::loadCSV(CsvReader& reader, size_t begin, size_t end, const std::string& table_name,
+                                   const std::vector<std::string>& key_columns, std::vector<TypeInference::Column>& columns,
+                                   UpsertResult* result, uint64_t* loaded) {
+    auto started = std::chrono::steady_clock::now();
+    const auto& headers = reader.header();
+    bool creating = columns.empty();
     
-    while (std::getline(file, line)) {
-        auto fields = parseCSVLine(line);
-        
-        if (first_line) {
-            headers = fields;
-            first_line = false;
-            
-            // Create table if it doesn't exist
-            std::stringstream create_query;
-            create_query << "CREATE TABLE IF NOT EXISTS " << table_name << " (";
-            for (size_t i = 0; i < headers.size(); ++i) {
-                if (i > 0) create_query << ", ";
-                create_query << headers[i] << " TEXT";
-            }
-            create_query << ");";
-            
-            if (!executeQuery(create_query.str())) {
-                std::cerr << "Failed to create table: " << table_name << std::endl;
-                return false;
+    // Types come from a bounded sample: 16 slices of 1 MB spread evenly
+    // from the first record to the last, each cut at record boundaries. Locating the
+    // slices only tracks quote state, so a large file is tokenized once,
+    // by the load itself
+    if (creating) {
+        TypeInference inference(headers);
+        auto offer = [&inference](const CsvChunk& chunk) {
+            for (size_t row = 0; row < chunk.rowCount(); ++row) {
+                inference.offer(chunk.fields(row), chunk.fieldCount(row));
             }
+            return true;
+        };
+        const size_t slices = 16;
+        const size_t slice_bytes = 1 << 20;
+        if (end - begin <= slices * slice_bytes) {
+            reader.read(offer, begin, end);
         } else {
-            // Insert data
-            std::stringstream insert_query;
-            insert_query << "INSERT INTO " << table_name << " (";
-            for (size_t i = 0; i < headers.size(); ++i) {
-                if (i > 0) insert_query << ", ";
-                insert_query << headers[i];
+            size_t position = begin;
+            for (size_t i = 0; i < slices && position < end; ++i) {
+                size_t target = begin + (end - begin - slice_bytes) / (slices - 1) * i;
+                size_t start = target <= position ? position : reader.nextBoundary(position, target);
+                size_t stop = std::min(reader.nextBoundary(start, start + slice_bytes), end);
+                if (start >= stop) {
+                    break;
+                }
+                reader.read(offer, start, stop);
+                position = stop;
             }
-            insert_query << ") VALUES (";
-            for (size_t i = 0; i < fields.size() && i < headers.size(); ++i) {
-                if (i > 0) insert_query << ", ";
-                insert_query << "'" << sanitizeSQL(fields[i]) << "'";
+        }
+        columns = inference.infer();
+    }
+    
+    std::string create_query = "CREATE TABLE IF NOT EXISTS " + BulkLoader::quoteIdentifier(table_name) + " (";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) create_query += ", ";
+        create_query += BulkLoader::quoteIdentifier(columns[i].name) + " " + TypeInference::sqlType(columns[i].type);
+    }
+    create_query += ");";
+    
+    if (creating && !executeQuery(create_query)) {
+        std::cerr << "Failed to create table: " << table_name << std::endl;
+        return false;
+    }
+    
+    BulkLoader::Options options;
+    options.upsert_keys = key_columns;
+    std::string upsert_error;
+    if (!key_columns.empty() && !BulkLoader::prepareUpsert(schema_->getDatabase(), table_name, key_columns, &upsert_error)) {
+        std::cerr << "Failed to prepare upsert: " << upsert_error << std::endl;
+        return false;
+    }
+    
+    // Second pass converts while loading, so numbers and dates are stored
+    // typed once instead of cast on every scan. The parse workers convert
+    // each chunk; the writer only binds
+    auto convert = [&columns](CsvChunk& chunk) {
+        std::vector<SqlValue> values(chunk.rowCount() * columns.size());  // short rows stay NULL
+        for (size_t row = 0; row < chunk.rowCount(); ++row) {
+            const std::string_view* fields = chunk.fields(row);
+            size_t count = std::min(chunk.fieldCount(row), columns.size());
+            for (size_t i = 0; i < count; ++i) {
+                TypeInference::convert(columns[i], fields[i], values[row * columns.size() + i]);
             }
-            insert_query << ");";
-            
-            if (executeQuery(insert_query.str())) {
-                rows_processed++;
+        }
+        chunk.setValues(std::move(values), columns.size());
+    };
+    BulkLoader loader(schema_->getDatabase(), table_name, headers, options);
+    bool completed = reader.read([&](const CsvChunk& chunk) {
+        for (size_t row = 0; row < chunk.rowCount(); ++row) {
+            if (!loader.add(chunk.values(row), chunk.width())) {
+                return false;
             }
         }
+        return true;
+    }, begin, end, convert);
+    completed = loader.finish() && completed;
+    if (loaded) {
+        *loaded = loader.rowsLoaded();
     }
     
-    file.close();
-    std::cout << "CSV ingestion complete. Processed " << rows_processed << " rows." << std::endl;
-    return true;
+    // Categories are what reports filter and group on
+    for (const auto& column : columns) {
+        if (creating && completed && column.type == TypeInference::Type::Category) {
+            executeQuery("CREATE INDEX IF NOT EXISTS " + BulkLoader::quoteIdentifier("idx_" + table_name + "_" + column.name) +
+                         " ON " + BulkLoader::quoteIdentifier(table_name) + " (" + BulkLoader::quoteIdentifier(column.name) + ");");
+        }
+    }
+    
+    if (result) {
+        result->inserted = loader.rowsInserted();
+        result->updated = loader.rowsUpdated();
+        result->unchanged = loader.rowsUnchanged();
+        result->rejected = loader.rowsRejected();
+    }
+    
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "CSV ingestion " << (completed ? "complete" : "stopped") << ". Loaded " << loader.rowsLoaded()
+              << " rows (";
+    if (!key_columns.empty()) {
+        std::cout << loader.rowsInserted() << " inserted, " << loader.rowsUpdated() << " updated, "
+                  << loader.rowsUnchanged() << " unchanged, ";
+    }
+    std::cout << loader.rowsRejected() << " rejected) as";
+    for (const auto& column : columns) {
+        std::cout << " " << column.name << ":" << TypeInference::typeName(column.type);
+    }
+    std::ostringstream elapsed;  // formatted apart so std::cout keeps its flags
+    elapsed << std::fixed << std::setprecision(2) << seconds;
+    std::cout << " in " << elapsed.str() << "s, "
+              << static_cast<long long>(seconds > 0 ? loader.rowsLoaded() / seconds : 0) << " rows/s." << std::endl;
+    if (!completed) {
+        std::cerr << "CSV ingestion failed: " << loader.error() << std::endl;
+    }
+    return completed;
 }
 
 bool DatabaseIntelligence::ingestExcel(const std::string& file_path, const std::string& table_name) {
     std::cout << "Ingesting Excel file: " << file_path << " into table: " << table_name << std::endl;
-    // Simplified implementation - would use actual Excel parsing library
-    std::cout << "Excel ingestion complete (simulated)" << std::endl;
-    return true;
+    auto started = std::chrono::steady_clock::now();
+    
+    // The first sheet is inflated and parsed as it streams; each row goes
+    // straight to the loader, so no part of the workbook is held as a DOM
+    XlsxReader reader;
+    if (!reader.open(file_path)) {
+        std::cerr << "Failed to open Excel file: " << reader.error() << std::endl;
+        return false;
+    }
+    
+    // Untyped columns keep the cell types (numbers, dates as ISO text)
+    const auto& headers = reader.header();
+    std::string create_query = "CREATE TABLE IF NOT EXISTS " + BulkLoader::quoteIdentifier(table_name) + " (";
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (i > 0) create_query += ", ";
+        create_query += BulkLoader::quoteIdentifier(headers[i]);
+    }
+    create_query += ");";
+    
+    if (!executeQuery(create_query)) {
+        std::cerr << "Failed to create table: " << table_name << std::endl;
+        return false;
+    }
+    
+    BulkLoader loader(schema_->getDatabase(), table_name, headers);
+    bool completed = reader.read([&loader](const std::vector<SqlValue>& row) {
+        return loader.add(row);
+    });
+    completed = loader.finish() && completed;
+    
+    std::ostringstream elapsed;
+    elapsed << std::fixed << std::setprecision(2)
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "Excel ingestion " << (completed ? "complete" : "stopped") << ". Loaded " << loader.rowsLoaded()
+              << " rows (" << loader.rowsRejected() << " rejected, " << reader.sharedStringCount()
+              << " shared strings) in " << elapsed.str() << "s." << std::endl;
+    if (!completed) {
+        std::cerr << "Excel ingestion failed: " << (reader.error().empty() ? loader.error() : reader.error()) << std::endl;
+    }
+    return completed;
 }
 
 bool DatabaseIntelligence::ingestJSON(const std::string& file_path, const std::string& table_name) {
     std::cout << "Ingesting JSON file: " << file_path << " into table: " << table_name << std::endl;
-    // Simplified implementation - would use actual JSON parsing library
-    std::cout << "JSON ingestion complete (simulated)" << std::endl;
-    return true;
+    return loadJSON(file_path, nullptr, table_name);
+}
+
+bool DatabaseIntelligence::loadJSON(const std::string& file_path, const std::string_view* text,
+                                    const std::string& table_name, uint64_t* loaded_rows) {
+    auto started = std::chrono::steady_clock::now();
+    Database* db = schema_->getDatabase();
+    std::string table = BulkLoader::quoteIdentifier(table_name);
+    
+    // Records stream one at a time from the SAX reader into the batched
+    // loader, so memory stays flat whatever the file size. Columns are
+    // untyped so numbers keep their JSON type; a field not seen before
+    // commits the open batch and adds the column.
+    std::vector<std::string> columns;
+    std::unordered_map<std::string, size_t> column_index;  // lower-cased, as SQLite compares names
+    auto lower = [](std::string name) {
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        return name;
+    };
+    for (const auto& info : db->query("PRAGMA table_info(" + table + ");")) {
+        column_index.emplace(lower(info.at("name")), columns.size());
+        columns.push_back(info.at("name"));
+    }
+    
+    std::unique_ptr<BulkLoader> loader;
+    size_t loaded = 0, rejected = 0;
+    std::string load_error;
+    auto closeLoader = [&] {
+        bool ok = !loader || loader->finish();
+        if (loader) {
+            loaded += loader->rowsLoaded();
+            rejected += loader->rowsRejected();
+            load_error = loader->error();
+            loader.reset();
+        }
+        return ok;
+    };
+    
+    std::vector<SqlValue> row;
+    JsonRecordReader reader;
+    auto consume = [&](JsonRecord& record) {
+        for (const auto& field : record) {
+            if (column_index.count(lower(field.first))) {
+                continue;
+            }
+            if (!closeLoader()) {
+                return false;
+            }
+            
+            std::string column = BulkLoader::quoteIdentifier(field.first);
+            std::string ddl = columns.empty() ? "CREATE TABLE IF NOT EXISTS " + table + " (" + column + ");"
+                                              : "ALTER TABLE " + table + " ADD COLUMN " + column + ";";
+            if (!executeQuery(ddl)) {
+                load_error = "cannot add column " + field.first;
+                return false;
+            }
+            column_index.emplace(lower(field.first), columns.size());
+            columns.push_back(field.first);
+        }
+        
+        if (columns.empty()) {
+            return true;  // only empty records so far
+        }
+        if (!loader) {
+            loader = std::make_unique<BulkLoader>(db, table_name, columns);
+        }
+        row.assign(columns.size(), nullptr);
+        for (auto& field : record) {
+            row[column_index[lower(field.first)]] = std::move(field.second);
+        }
+        return loader->add(row);
+    };
+    bool completed = text ? reader.readText(*text, consume) : reader.read(file_path, consume);
+    completed = closeLoader() && completed;
+    if (loaded_rows) {
+        *loaded_rows = loaded;
+    }
+    
+    std::ostringstream elapsed;
+    elapsed << std::fixed << std::setprecision(2)
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "JSON ingestion " << (completed ? "complete" : "stopped") << ". Loaded " << loaded << " of "
+              << reader.recordCount() << " records (" << rejected << " rejected) into " << columns.size()
+              << " columns in " << elapsed.str() << "s." << std::endl;
+    if (!completed) {
+        std::cerr << "JSON ingestion failed: " << (reader.error().empty() ? load_error : reader.error()) << std::endl;
+    }
+    return completed;
+}
+
+std::map<std::string, std::string> DatabaseIntelligence::detectFieldTypes(const std::vector<std::map<std::string, std::string>>& sample_data) {
+    // Same rules ingestCSV applies to its file sample; a field missing from a row counts as empty
+    std::vector<std::string> names;
+    for (const auto& row : sample_data) {
+        for (const auto& field : row) {
+            if (std::find(names.begin(), names.end(), field.first) == names.end()) {
+                names.push_back(field.first);
+            }
+        }
+    }
+    
+    TypeInference::Options options;
+    options.sample_rows = std::max<size_t>(sample_data.size(), 1);
+    TypeInference inference(names, options);
+    std::vector<std::string_view> fields(names.size());
+    for (const auto& row : sample_data) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            auto it = row.find(names[i]);
+            fields[i] = it == row.end() ? std::string_view() : std::string_view(it->second);
+        }
+        inference.offer(fields.data(), fields.size());
+    }
+    
+    std::map<std::string, std::string> types;
+    for (const auto& column : inference.infer()) {
+        types[column.name] = TypeInference::typeName(column.type);
+    }
+    return types;
 }
 
 DatabaseIntelligence::QueryResult DatabaseIntelligence::processNaturalLanguageQuery(const std::string& question) {
@@ -112,25 +400,22 @@ DatabaseIntelligence::QueryResult DatabaseIntelligence::processNaturalLanguageQu
         
         // Mock results for demonstration
         if (intent == "count") {
-            result.columns = {"count"};
-            std::map<std::string, std::string> count_row;
-            count_row["count"] = "42";
-            result.rows.push_back(count_row);
+            result.data.setColumns({"count"});
+            result.data.appendInt64(0, 42);
+            result.data.finishRow();
             result.total_rows = 1;
         } else if (intent == "list") {
-            result.columns = {"name", "value", "date"};
+            result.data.setColumns({"name", "value", "date"});
 
-            std::map<std::string, std::string> row1;
-            row1["name"] = "Project Alpha";
-            row1["value"] = "150000";
-            row1["date"] = "2024-01-15";
-            result.rows.push_back(row1);
+            result.data.appendText(0, "Project Alpha");
+            result.data.appendInt64(1, 150000);
+            result.data.appendText(2, "2024-01-15");
+            result.data.finishRow();
 
-            std::map<std::string, std::string> row2;
-            row2["name"] = "Project Beta";
-            row2["value"] = "200000";
-            row2["date"] = "2024-02-01";
-            result.rows.push_back(row2);
+            result.data.appendText(0, "Project Beta");
+            result.data.appendInt64(1, 200000);
+            result.data.appendText(2, "2024-02-01");
+            result.data.finishRow();
 
             result.total_rows = 2;
         }
@@ -227,30 +512,6 @@ std::string DatabaseIntelligence::identifyQueryIntent(const std::string& query)
     return "general";
 }
 
-std::vector<std::string> DatabaseIntelligence::parseCSVLine(const std::string& line) {
-    std::vector<std::string> fields;
-    std::stringstream ss(line);
-    std::string field;
-    
-    while (std::getline(ss, field, ',')) {
-        // Remove leading/trailing whitespace and quotes
-        field.erase(0, field.find_first_not_of(" \t\""));
-        field.erase(field.find_last_not_of(" \t\"") + 1);
-        fields.push_back(field);
-    }
-    
-    return fields;
-}
-
-std::string DatabaseIntelligence::sanitizeSQL(const std::string& input) {
-    std::string sanitized = input;
-    
-    // Replace single quotes with double quotes for SQL safety
-    std::replace(sanitized.begin(), sanitized.end(), '\'', '"');
-    
-    return sanitized;
-}
-
 std::string DatabaseIntelligence::getCurrentTimestamp() {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -261,8 +522,139 @@ std::string DatabaseIntelligence::getCurrentTimestamp() {
 }
 
 bool DatabaseIntelligence::executeQuery(const std::string& query) {
-    // Simplified query execution for demonstration
-    std::cout << "Executing query: " << query << std::endl;
+    return schema_->getDatabase()->execute(query);
+}
+
+std::map<std::string, double> DatabaseIntelligence::calculateTableStatistics(const std::string& table_name) {
+    // One parallel scan feeds every column's sketches at once, instead of
+    // a COUNT(DISTINCT) and an ORDER BY per column
+    std::map<std::string, double> stats;
+    ColumnProfiler profiler(schema_->getDatabase());
+    if (!profiler.profile(table_name)) {
+        std::cerr << "Failed to profile table " << table_name << ": " << profiler.error() << std::endl;
+        return stats;
+    }
+    
+    stats["rows"] = static_cast<double>(profiler.rows());
+    stats["columns"] = static_cast<double>(profiler.columns().size());
+    stats["seconds"] = profiler.seconds();
+    // Lines are formatted in their own stream so std::cout keeps its flags
+    std::ostringstream report;
+    report << "Profiled " << table_name << ": " << profiler.rows() << " rows, " << profiler.columns().size()
+           << " columns in " << std::fixed << std::setprecision(2) << profiler.seconds() << "s\n";
+    
+    for (const auto& column : profiler.columns()) {
+        const std::string& name = column.name;
+        stats[name + ".null_rate"] = column.nullRate();
+        stats[name + ".distinct"] = std::round(column.distinctCount());
+        auto top = column.frequent.top(3);
+        stats[name + ".top_share"] = top.empty() || !column.present() ? 0.0 : static_cast<double>(top[0].guaranteed()) / column.present();
+        
+        report << "  " << name << ": " << std::fixed << std::setprecision(1) << column.nullRate() * 100 << "% null, ~"
+               << static_cast<long long>(std::round(column.distinctCount())) << " distinct";
+        if (column.numeric()) {
+            stats[name + ".min"] = column.min;
+            stats[name + ".max"] = column.max;
+            stats[name + ".mean"] = column.mean();
+            for (auto [label, q] : {std::pair<const char*, double>{"p01", 0.01}, {"p25", 0.25}, {"p50", 0.5}, {"p75", 0.75}, {"p99", 0.99}}) {
+                stats[name + "." + label] = column.quantiles.quantile(q);
+            }
+            report << std::setprecision(4) << std::defaultfloat << ", min " << column.min << ", median "
+                   << stats[name + ".p50"] << ", max " << column.max;
+        }
+        if (!top.empty()) {
+            report << ", top:";
+            for (const auto& item : top) {
+                report << " '" << item.text() << "' x" << item.guaranteed();
+            }
+        }
+        report << "\n";
+    }
+    std::cout << report.str() << std::flush;
+    return stats;
+}
+
+bool DatabaseIntelligence::flagDataQualityIssues(const std::string& table_name) {
+    ColumnProfiler profiler(schema_->getDatabase());
+    if (!profiler.profile(table_name)) {
+        std::cerr << "Failed to profile table " << table_name << ": " << profiler.error() << std::endl;
+        return false;
+    }
+    
+    std::vector<std::string> issues;
+    auto percent = [](double share) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(1) << share * 100 << "%";
+        return text.str();
+    };
+    
+    for (const auto& column : profiler.columns()) {
+        const std::string& name = column.name;
+        double present = static_cast<double>(column.present());
+        if (column.rows == 0) {
+            continue;
+        }
+        if (column.present() == 0) {
+            issues.push_back(name + " is always NULL");
+            continue;
+        }
+        if (column.nullRate() > 0.5) {
+            issues.push_back(name + " is " + percent(column.nullRate()) + " NULL");
+        }
+        if (column.blanks > 0 && column.blanks / present > 0.1) {
+            issues.push_back(name + " is " + percent(column.blanks / present) + " blank text");
+        }
+        
+        // Numbers mixed with text usually mean placeholders ("n/a", "-") in a numeric column
+        if (column.numeric() && column.texts) {
+            double text_share = column.texts / present;
+            if (text_share < 0.5) {
+                auto sample = column.frequent.top(SIZE_MAX);
+                std::string example;
+                for (const auto& item : sample) {
+                    if (std::holds_alternative<std::string>(item.value)) {
+                        example = " such as '" + item.text() + "'";
+                        break;
+                    }
+                }
+                issues.push_back(name + " is numeric but " + percent(text_share) + " of values are text" + example);
+            }
+        }
+        
+        double distinct = column.distinctCount();
+        auto top = column.frequent.top(1);
+        if (present > 1 && distinct < 1.5) {
+            issues.push_back(name + " holds a single value ('" + (top.empty() ? std::string() : top[0].text()) + "')");
+        } else if (!top.empty() && top[0].guaranteed() > 1 && distinct > 0.98 * present) {
+            // Nearly every value is unique, so repeats look like duplicated keys
+            issues.push_back(name + " looks like a key but repeats values ('" + top[0].text() + "' x" +
+                             std::to_string(top[0].guaranteed()) + ")");
+        } else if (!top.empty() && distinct > 2 && top[0].guaranteed() > 0.9 * present) {
+            issues.push_back(name + " is " + percent(top[0].guaranteed() / present) + " '" + top[0].text() + "'");
+        }
+        
+        // Values far outside the interquartile range (Tukey's outer fences)
+        if (column.numeric() >= 20) {
+            double q1 = column.quantiles.quantile(0.25);
+            double q3 = column.quantiles.quantile(0.75);
+            double iqr = q3 - q1;
+            if (iqr > 0 && (column.min < q1 - 3 * iqr || column.max > q3 + 3 * iqr)) {
+                std::ostringstream text;
+                text << name << " has extreme values (min " << column.min << ", max " << column.max
+                     << " against an interquartile range of " << q1 << " to " << q3 << ")";
+                issues.push_back(text.str());
+            }
+        }
+    }
+    
+    if (issues.empty()) {
+        std::cout << "No data quality issues found in " << table_name << " (" << profiler.rows() << " rows)" << std::endl;
+    } else {
+        std::cout << "Data quality issues in " << table_name << " (" << profiler.rows() << " rows):" << std::endl;
+        for (const auto& issue : issues) {
+            std::cout << "  - " << issue << std::endl;
+        }
+    }
     return true;
 }
 
@@ -287,15 +679,351 @@ std::vector<std::string> DatabaseIntelligence::generateInsights(const std::strin
 }
 
 bool DatabaseIntelligence::addDataSource(const DataSource& source) {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
     data_sources_[source.name] = source;
     std::cout << "Data source added: " << source.name << " (Type: " << source.type << ")" << std::endl;
     return true;
 }
 
 std::vector<DatabaseIntelligence::DataSource> DatabaseIntelligence::getDataSources() {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
     std::vector<DataSource> sources;
     for (const auto& pair : data_sources_) {
         sources.push_back(pair.second);
     }
     return sources;
 }
+
+bool DatabaseIntelligence::validateTableExists(const std::string& table_name) {
+    PreparedStatement stmt = schema_->getDatabase()->prepareRead(
+        "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?1;");
+    bool exists = false;
+    if (stmt && stmt.bind(1, table_name)) {
+        Database::forEachRow(stmt, [&exists](const RowView&) {
+            exists = true;
+            return false;
+        });
+    }
+    return exists;
+}
+
+bool DatabaseIntelligence::startLiveSync(const std::string& source_name, int interval_minutes) {
+    if (interval_minutes < 1) {
+        std::cerr << "Live sync interval must be at least one minute" << std::endl;
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    SyncState state;
+    if (!syncStateFor(source_name, &state)) {
+        return false;
+    }
+    
+    auto previous = sync_status_.find(source_name);
+    bool watching = previous != sync_status_.end() && previous->second.active;
+    if (watching && previous->second.path != state.path) {
+        sync_watcher_.unwatch(previous->second.path);
+        watching = false;
+    }
+    if (!watching) {
+        sync_watcher_.watch(state.path);
+    }
+    
+    state.active = true;
+    state.interval_minutes = interval_minutes;
+    sync_status_[source_name] = state;
+    sync_store_.save(state);
+    
+    // First pass right away, then every interval while the file changes
+    sync_due_[source_name] = std::chrono::steady_clock::now();
+    sync_dirty_.insert(source_name);
+    if (!sync_thread_.joinable()) {
+        sync_thread_ = std::thread(&DatabaseIntelligence::runLiveSync, this);
+    } else {
+        sync_watcher_.wake();
+    }
+    
+    std::cout << "Live sync started for " << source_name << " (" << state.path << " -> " << state.table
+              << ") every " << interval_minutes << " minute(s)" << std::endl;
+    return true;
+}
+
+bool DatabaseIntelligence::stopLiveSync(const std::string& source_name) {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    auto it = sync_status_.find(source_name);
+    if (it == sync_status_.end() || !it->second.active) {
+        std::cerr << "No live sync running for " << source_name << std::endl;
+        return false;
+    }
+    
+    // The offset is kept, so a later start picks up where this one stopped
+    it->second.active = false;
+    sync_store_.save(it->second);
+    sync_watcher_.unwatch(it->second.path);
+    sync_due_.erase(source_name);
+    sync_dirty_.erase(source_name);
+    
+    std::cout << "Live sync stopped for " << source_name << std::endl;
+    return true;
+}
+
+std::vector<std::string> DatabaseIntelligence::getActiveSyncSources() {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    std::vector<std::string> sources;
+    for (const auto& entry : sync_status_) {
+        if (entry.second.active) {
+            sources.push_back(entry.first);
+        }
+    }
+    return sources;
+}
+
+bool DatabaseIntelligence::updateFromSource(const std::string& source_name) {
+    std::lock_guard<std::mutex> update(update_mutex_);
+    SyncState state;
+    {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        if (!syncStateFor(source_name, &state)) {
+            return false;
+        }
+    }
+    
+    bool synced = syncFile(state);
+    
+    // Start and stop may have run meanwhile; they own the active flag and interval
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    auto current = sync_status_.find(source_name);
+    if (current != sync_status_.end()) {
+        state.active = current->second.active;
+        state.interval_minutes = current->second.interval_minutes;
+    }
+    sync_status_[source_name] = state;
+    sync_store_.save(state);
+    
+    auto source = data_sources_.find(source_name);
+    if (synced && source != data_sources_.end()) {
+        source->second.last_sync = state.last_sync;
+    }
+    return synced;
+}
+
+// Called with sync_mutex_ held
+bool DatabaseIntelligence::syncStateFor(const std::string& source_name, SyncState* state) {
+    auto existing = sync_status_.find(source_name);
+    auto source = data_sources_.find(source_name);
+    if (source == data_sources_.end()) {
+        if (existing == sync_status_.end()) {
+            std::cerr << "Unknown data source: " << source_name << std::endl;
+            return false;
+        }
+        *state = existing->second;  // restored from sync_state
+        return true;
+    }
+    
+    const DataSource& data_source = source->second;
+    if (data_source.type != "csv" && data_source.type != "json") {
+        std::cerr << "Live sync supports csv and json file sources, not " << data_source.type << std::endl;
+        return false;
+    }
+    auto table = data_source.schema_mapping.find("table");
+    std::string table_name = table != data_source.schema_mapping.end() ? table->second : data_source.name;
+    
+    // A source pointed at another file or table starts over
+    if (existing != sync_status_.end() && existing->second.path == data_source.connection_string &&
+        existing->second.table == table_name && existing->second.format == data_source.type) {
+        *state = existing->second;
+    } else {
+        *state = SyncState();
+        state->source = source_name;
+        state->path = data_source.connection_string;
+        state->table = table_name;
+        state->format = data_source.type;
+        if (existing != sync_status_.end()) {
+            state->active = existing->second.active;
+            state->interval_minutes = existing->second.interval_minutes;
+        }
+    }
+    return true;
+}
+
+bool DatabaseIntelligence::syncFile(SyncState& state) {
+    uint64_t size, inode;
+    if (!SyncStateStore::stat(state.path, &size, &inode)) {
+        std::cerr << "Sync source " << state.source << " cannot read " << state.path << std::endl;
+        return false;
+    }
+    
+    // The source is read in bounded pieces, never mapped: an export that
+    // is truncated mid-pass fails the pass instead of faulting the process.
+    // The head holds the CSV header, or the first JSON line
+    bool is_csv = state.format == "csv";
+    std::string head;
+    CsvReader header;
+    for (size_t want = 64 << 10;; want *= 2) {
+        head.clear();
+        if (!SyncStateStore::readRange(state.path, 0, static_cast<size_t>(std::min<uint64_t>(want, size)), &head)) {
+            std::cerr << "Sync source " << state.source << " cannot read " << state.path << std::endl;
+            return false;
+        }
+        bool whole = is_csv ? header.openText(head) && header.dataStart() < head.size() : head.find('\n') != std::string::npos;
+        if (whole || head.size() == size) {
+            break;
+        }
+    }
+    if (is_csv && header.header().empty()) {
+        std::cerr << "Sync source " << state.source << " cannot open " << state.path << ": " << header.error() << std::endl;
+        return false;
+    }
+    
+    // NDJSON is one value per line and can be tailed; any other JSON is
+    // a single document, which only parses whole
+    bool document = false;
+    if (!is_csv) {
+        size_t newline = head.find('\n');
+        std::string_view first_line(head.data(), newline == std::string::npos ? 0 : newline);
+        size_t start = first_line.find_first_not_of(" \t\r");
+        JsonRecordReader probe;
+        document = start == std::string_view::npos || first_line[start] != '{' ||
+                   !probe.readText(first_line, [](JsonRecord&) { return true; });
+    }
+    
+    // Tailing is only sound while the loaded prefix is still on disk as it
+    // was; otherwise the table is rebuilt from the start of the file
+    uint64_t head_hash = 0, tail_hash = 0;
+    bool loaded_before = state.offset > 0 || state.partial;
+    bool reload = state.partial || inode != state.inode || size < state.offset ||
+                  !SyncStateStore::fingerprints(state.path, state.offset, &head_hash, &tail_hash) ||
+                  head_hash != state.head_hash || tail_hash != state.tail_hash ||
+                  (document && size != state.offset) || (loaded_before && !validateTableExists(state.table));
+    if (is_csv && !reload) {
+        reload = header.header().size() != state.columns.size();
+        for (size_t i = 0; !reload && i < state.columns.size(); ++i) {
+            reload = header.header()[i] != state.columns[i].name;
+        }
+    }
+    if (reload) {
+        if (loaded_before) {
+            std::cout << "Source " << state.source << " was truncated or rewritten; reloading " << state.table << std::endl;
+            if (!executeQuery("DROP TABLE IF EXISTS " + BulkLoader::quoteIdentifier(state.table) + ";")) {
+                return false;
+            }
+        }
+        SyncState fresh;
+        fresh.source = state.source;
+        fresh.path = state.path;
+        fresh.table = state.table;
+        fresh.format = state.format;
+        state = fresh;
+    } else if (document) {
+        return true;  // unchanged
+    }
+    
+    // Only whole records are loaded; a line still being written waits
+    uint64_t loaded = 0;
+    bool completed = true;
+    uint64_t position = is_csv ? std::max<uint64_t>(state.offset, header.dataStart()) : state.offset;
+    if (document) {
+        completed = loadJSON(state.path, nullptr, state.table, &loaded);
+        position = size;
+    }
+    for (size_t piece_bytes = SyncStateStore::kReadBytes; completed && position < size;) {
+        size_t want = static_cast<size_t>(std::min<uint64_t>(size - position, piece_bytes));
+        std::string piece = is_csv ? head.substr(0, header.dataStart()) : std::string();
+        if (!SyncStateStore::readRange(state.path, position, want, &piece)) {
+            std::cerr << "Sync source " << state.source << " shrank while it was read" << std::endl;
+            completed = false;
+            break;
+        }
+        
+        size_t taken;
+        uint64_t piece_rows = 0;
+        if (is_csv) {
+            CsvReader reader;
+            reader.openText(std::move(piece));
+            size_t end = reader.lastBoundary(reader.dataStart());
+            taken = end - reader.dataStart();
+            if (taken > 0) {
+                completed = loadCSV(reader, reader.dataStart(), end, state.table, {}, state.columns, nullptr, &piece_rows);
+            }
+        } else {
+            size_t newline = piece.rfind('\n');
+            taken = newline == std::string::npos ? 0 : newline + 1;
+            if (taken > 0) {
+                std::string_view lines(piece.data(), taken);
+                completed = loadJSON(state.path, &lines, state.table, &piece_rows);
+            }
+        }
+        
+        if (taken == 0) {
+            if (want == size - position) {
+                break;  // the last record is still being written
+            }
+            piece_bytes *= 2;  // one record longer than a piece
+            continue;
+        }
+        loaded += piece_rows;
+        if (completed) {
+            position += taken;
+        }
+    }
+    
+    // A failed pass may have committed some batches; tailing on from the
+    // old offset would duplicate them, so the next pass reloads instead
+    state.partial = !completed;
+    state.inode = inode;
+    state.rows += loaded;
+    if (completed) {
+        if (!SyncStateStore::fingerprints(state.path, position, &state.head_hash, &state.tail_hash)) {
+            state.partial = true;  // shrank since: the next pass reloads
+            return false;
+        }
+        state.offset = position;
+        state.last_sync = getCurrentTimestamp();
+        std::cout << "Synced " << state.source << ": " << loaded << " new row(s), " << state.rows << " in "
+                  << state.table << std::endl;
+    }
+    return completed;
+}
+
+void DatabaseIntelligence::runLiveSync() {
+    std::unique_lock<std::mutex> lock(sync_mutex_);
+    while (!sync_stopping_) {
+        // A source is updated when its interval is up and its file has
+        // changed since the last pass; quiet files cost nothing
+        auto now = std::chrono::steady_clock::now();
+        auto next = now + std::chrono::hours(1);
+        std::vector<std::string> due;
+        for (const auto& entry : sync_status_) {
+            if (!entry.second.active) {
+                continue;
+            }
+            auto& at = sync_due_[entry.first];
+            if (at <= now) {
+                if (sync_dirty_.erase(entry.first)) {
+                    due.push_back(entry.first);
+                }
+                at = now + std::chrono::minutes(entry.second.interval_minutes);
+            }
+            next = std::min(next, at);
+        }
+        
+        lock.unlock();
+        for (const auto& source : due) {
+            if (!updateFromSource(source)) {
+                std::lock_guard<std::mutex> retry(sync_mutex_);
+                sync_dirty_.insert(source);
+            }
+        }
+        
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - std::chrono::steady_clock::now());
+        std::vector<std::string> changed = sync_watcher_.wait(std::max(wait, std::chrono::milliseconds(0)));
+        lock.lock();
+        for (const auto& path : changed) {
+            for (const auto& entry : sync_status_) {
+                if (entry.second.active && FileWatcher::normalize(entry.second.path) == path) {
+                    sync_dirty_.insert(entry.first);
+                }
+            }
+        }
+    }
+}
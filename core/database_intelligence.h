@@ -5,7 +5,15 @@
 #include <map>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <thread>
 #include "schema_model.h"
+#include "columnar_result.h"
+#include "source_sync.h"
+
+class CsvReader;
 
 class DatabaseIntelligence {
 public:
@@ -19,12 +27,22 @@ public:
     };
 
     struct QueryResult {
-        std::vector<std::map<std::string, std::string>> rows;
-        std::vector<std::string> columns;
+        ColumnarResult data;   // column names stored once, typed column vectors
         int total_rows;
         std::string query_time;
         bool success;
         std::string error_message;
+
+        // Adapters for callers that still expect row maps
+        const std::vector<std::string>& columns() const { return data.columnNames(); }
+        std::vector<std::map<std::string, std::string>> rows() const { return data.toRowMaps(); }
+    };
+
+    struct UpsertResult {
+        size_t inserted = 0;
+        size_t updated = 0;
+        size_t unchanged = 0;
+        size_t rejected = 0;
     };
 
     struct SchemaField {
@@ -37,10 +55,14 @@ public:
     };
 
     DatabaseIntelligence(SchemaModel* schema);
-    ~DatabaseIntelligence() = default;
+    ~DatabaseIntelligence();
 
     // Data Ingestion
     bool ingestCSV(const std::string& file_path, const std::string& table_name);
+    // Refreshes a table from a newer export: rows are merged on key_columns
+    // and only new or changed rows are written
+    bool upsertCSV(const std::string& file_path, const std::string& table_name,
+                   const std::vector<std::string>& key_columns, UpsertResult* result = nullptr);
     bool ingestExcel(const std::string& file_path, const std::string& table_name);
     bool ingestJSON(const std::string& file_path, const std::string& table_name);
     bool connectToSQL(const std::string& connection_string, const std::string& source_name);
@@ -58,6 +80,10 @@ public:
     std::vector<std::string> suggestQueries(const std::string& context);
 
     // Live Synchronization
+    // csv and NDJSON file sources are tailed: each interval loads only what
+    // was appended since the last pass, and a truncated or replaced file is
+    // reloaded. Other JSON documents are reloaded whenever they change.
+    // The table is schema_mapping["table"], else the source name.
     bool startLiveSync(const std::string& source_name, int interval_minutes);
     bool stopLiveSync(const std::string& source_name);
     std::vector<std::string> getActiveSyncSources();
@@ -82,14 +108,36 @@ public:
 private:
     SchemaModel* schema_;
     std::map<std::string, DataSource> data_sources_;
-    std::map<std::string, bool> sync_status_;
+    std::map<std::string, SyncState> sync_status_;  // per source, persisted in sync_state
+    
+    // Live sync runs on one background thread; sync_mutex_ guards the
+    // source and sync maps, update_mutex_ keeps source updates one at a time
+    SyncStateStore sync_store_;
+    FileWatcher sync_watcher_;
+    std::mutex sync_mutex_;
+    std::mutex update_mutex_;
+    std::map<std::string, std::chrono::steady_clock::time_point> sync_due_;
+    std::set<std::string> sync_dirty_;  // sources whose file changed since their last pass
+    bool sync_stopping_ = false;
+    std::thread sync_thread_;
     
     // Helper methods
     std::string getCurrentTimestamp();
     bool validateTableExists(const std::string& table_name);
-    std::vector<std::string> parseCSVLine(const std::string& line);
-    std::string sanitizeSQL(const std::string& input);
     bool executeQuery(const std::string& query);
+    // Loads the CSV records in [begin, end); with no columns given they are
+    // inferred from those records and the table is created
+    bool loadCSV(CsvReader& reader, size_t begin, size_t end, const std::string& table_name,
+                 const std::vector<std::string>& key_columns, std::vector<TypeInference::Column>& columns,
+                 UpsertResult* result, uint64_t* loaded = nullptr);
+    // Loads a JSON file, or the given text of one
+    bool loadJSON(const std::string& file_path, const std::string_view* text, const std::string& table_name,
+                  uint64_t* loaded = nullptr);
+    
+    // Live sync helpers
+    bool syncStateFor(const std::string& source_name, SyncState* state);
+    bool syncFile(SyncState& state);
+    void runLiveSync();
     
     // NLP helpers
     std::vector<std::string> extractKeywords(const std::string& query);
@@ -0,0 +1,513 @@
+// Index advisor for Riley Corpbrain - foreign-key and workload-driven indexes
+#include "index_advisor.h"
+#include "database.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+bool isIdentifier(const std::string& token) {
+    return !token.empty() && (std::isalpha(static_cast<unsigned char>(token[0])) || token[0] == '_');
+}
+
+const std::set<std::string>& keywords() {
+    static const std::set<std::string> words = {
+        "where", "join", "inner", "left", "right", "full", "cross", "natural", "outer", "on",
+        "using", "group", "order", "limit", "set", "having", "union", "except", "intersect",
+        "window", "as", "values", "returning", "indexed", "not"
+    };
+    return words;
+}
+
+bool isEqualityOp(const std::string& token) {
+    return token == "=" || token == "==" || token == "in" || token == "is";
+}
+
+bool isRangeOp(const std::string& token) {
+    return token == "<" || token == "<=" || token == ">" || token == ">=" ||
+           token == "between" || token == "like" || token == "glob";
+}
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+void addUnique(std::vector<std::string>& columns, const std::string& column) {
+    if (std::find(columns.begin(), columns.end(), column) == columns.end()) {
+        columns.push_back(column);
+    }
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// IndexRecommendation
+// ---------------------------------------------------------------------------
+
+std::string IndexRecommendation::indexName() const {
+    std::string name = "idx_" + table;
+    for (const auto& column : columns) {
+        name += "_" + column;
+    }
+    return name;
+}
+
+std::string IndexRecommendation::ddl() const {
+    std::string sql = "CREATE INDEX IF NOT EXISTS " + indexName() + " ON " + table + " (";
+    for (size_t i = 0; i < columns.size(); i++) {
+        sql += (i > 0 ? ", " : "") + columns[i];
+    }
+    return sql + ");";
+}
+
+// ---------------------------------------------------------------------------
+// IndexAdvisor
+// ---------------------------------------------------------------------------
+
+IndexAdvisor::IndexAdvisor(Database* db) : IndexAdvisor(db, Options()) {}
+
+IndexAdvisor::IndexAdvisor(Database* db, const Options& options) : db_(db), options_(options) {
+    loadTables();
+}
+
+void IndexAdvisor::loadTables() {
+    std::vector<std::string> tables;
+    db_->forEachRow("SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%';",
+                    [&tables](const RowView& row) {
+                        tables.emplace_back(row.getText(0));
+                        return true;
+                    });
+
+    for (const auto& table : tables) {
+        PreparedStatement stmt = db_->prepareRead("SELECT name FROM pragma_table_info(?1);");
+        if (!stmt || !stmt.bind(1, table)) {
+            continue;
+        }
+
+        std::set<std::string>& columns = columns_[lowercase(table)];
+        db_->forEachRow(stmt, [&columns](const RowView& row) {
+            columns.insert(lowercase(std::string(row.getText(0))));
+            return true;
+        });
+    }
+}
+
+std::vector<IndexRecommendation> IndexAdvisor::adviseForeignKeys() {
+    std::vector<IndexRecommendation> recommendations;
+
+    for (const auto& [table, columns] : columns_) {
+        PreparedStatement stmt = db_->prepareRead(
+            "SELECT id, \"from\" FROM pragma_foreign_key_list(?1) ORDER BY id, seq;");
+        if (!stmt || !stmt.bind(1, table)) {
+            continue;
+        }
+
+        // Composite keys share an id
+        std::map<int64_t, std::vector<std::string>> keys;
+        db_->forEachRow(stmt, [&keys](const RowView& row) {
+            keys[row.getInt64(0)].push_back(lowercase(std::string(row.getText(1))));
+            return true;
+        });
+        stmt = PreparedStatement();
+
+        for (const auto& [id, key] : keys) {
+            if (hasLeadingIndex(table, key)) {
+                continue;
+            }
+
+            IndexRecommendation recommendation;
+            recommendation.table = table;
+            recommendation.columns = key;
+            recommendation.reason = "foreign key";
+            recommendation.statement = "SELECT * FROM " + table + " WHERE " + key.front() + " = ?";
+            recommendation.plan_before = db_->explainQueryPlan(recommendation.statement);
+
+            // Kept even without a plan change - FK checks on parent deletes use it too
+            applyRecommendation(recommendation, {table}, true);
+            recommendations.push_back(std::move(recommendation));
+        }
+    }
+
+    return recommendations;
+}
+
+std::vector<IndexRecommendation> IndexAdvisor::adviseWorkload() {
+    std::vector<IndexRecommendation> recommendations;
+    std::set<std::string> proposed;
+
+    for (const auto& stats : db_->queryStats().snapshot()) {
+        if (stats.fullscan_steps < options_.min_fullscan_steps) {
+            continue;
+        }
+
+        std::vector<std::string> tokens = tokenize(stats.statement);
+        if (tokens.empty() || (tokens[0] != "select" && tokens[0] != "with" &&
+                               tokens[0] != "update" && tokens[0] != "delete")) {
+            continue;
+        }
+
+        // Normalized SQL has ? in place of literals, which EXPLAIN accepts as parameters
+        std::string plan = db_->explainQueryPlan(stats.statement);
+        if (plan.empty()) {
+            continue;
+        }
+
+        for (const auto& [table, names] : tableAliases(tokens)) {
+            if (!scansTable(plan, names)) {
+                continue;
+            }
+
+            FilterColumns filters = filterColumns(tokens, table, names);
+
+            // Where SQLite built an automatic index, its key is the answer
+            std::istringstream lines(plan);
+            std::string line;
+            while (std::getline(lines, line)) {
+                size_t automatic = line.find("AUTOMATIC");
+                size_t open = line.find('(', automatic == std::string::npos ? 0 : automatic);
+                if (automatic == std::string::npos || open == std::string::npos) {
+                    continue;
+                }
+                std::vector<std::string> words = tokenize(line.substr(0, automatic));
+                if (words.size() < 2 || !names.count(words.back())) {
+                    continue;
+                }
+                std::vector<std::string> key = tokenize(line.substr(open));
+                for (size_t i = 0; i + 1 < key.size(); i++) {
+                    if (isIdentifier(key[i]) && key[i] != "and" && isEqualityOp(key[i + 1])) {
+                        addUnique(filters.joins, key[i]);
+                    }
+                }
+            }
+
+            // Try the key built from constant filters first, then add join
+            // columns for when this table is the inner side of a join
+            for (const auto& columns : candidateKeys(filters)) {
+                if (hasLeadingIndex(table, columns)) {
+                    break;  // an index exists and the planner still scans
+                }
+
+                IndexRecommendation recommendation;
+                recommendation.table = table;
+                recommendation.columns = columns;
+                recommendation.reason = "workload";
+                recommendation.statement = stats.statement;
+                recommendation.fullscan_steps = stats.fullscan_steps;
+                recommendation.plan_before = plan;
+
+                if (!proposed.insert(recommendation.indexName()).second) {
+                    break;
+                }
+
+                applyRecommendation(recommendation, names, false);
+                bool improved = recommendation.created || !options_.create;
+                recommendations.push_back(std::move(recommendation));
+                if (improved) {
+                    break;
+                }
+            }
+        }
+    }
+
+    if (options_.create && !recommendations.empty()) {
+        db_->execute("PRAGMA optimize;");
+    }
+
+    return recommendations;
+}
+
+std::vector<std::vector<std::string>> IndexAdvisor::candidateKeys(const FilterColumns& filters) const {
+    // Equality columns lead, then at most one range column - an index
+    // serves only one range constraint
+    auto build = [&filters, this](bool with_joins) {
+        std::vector<std::string> key;
+        if (with_joins) {
+            for (const auto& column : filters.joins) {
+                addUnique(key, column);
+            }
+        }
+        for (const auto& column : filters.equality) {
+            addUnique(key, column);
+        }
+        for (const auto& column : filters.range) {
+            if (std::find(key.begin(), key.end(), column) == key.end()) {
+                key.push_back(column);
+                break;
+            }
+        }
+        if (key.size() > options_.max_columns) {
+            key.resize(options_.max_columns);
+        }
+
+        // Projected, ordered and grouped columns after the filters make the index covering
+        std::vector<std::string> covering = key;
+        for (const auto& column : filters.referenced) {
+            addUnique(covering, column);
+        }
+        if (!key.empty() && filters.coverable && covering.size() <= options_.max_covering_columns) {
+            return covering;
+        }
+        return key;
+    };
+
+    std::vector<std::vector<std::string>> candidates;
+    std::vector<std::string> filtered = build(false);
+    std::vector<std::string> joined = build(true);
+
+    if (!filtered.empty()) {
+        candidates.push_back(filtered);
+    }
+    if (!joined.empty() && joined != filtered) {
+        candidates.push_back(joined);
+    }
+    return candidates;
+}
+
+void IndexAdvisor::applyRecommendation(IndexRecommendation& recommendation,
+                                       const std::set<std::string>& names, bool keep_without_gain) {
+    if (!options_.create) {
+        return;
+    }
+
+    if (!db_->execute(recommendation.ddl())) {
+        return;
+    }
+
+    recommendation.plan_after = db_->explainQueryPlan(recommendation.statement);
+    recommendation.created = true;
+
+    if (!keep_without_gain && scansTable(recommendation.plan_after, names)) {
+        db_->execute("DROP INDEX IF EXISTS " + recommendation.indexName() + ";");
+        recommendation.created = false;
+    }
+}
+
+// True if an existing index starts with exactly these columns
+bool IndexAdvisor::hasLeadingIndex(const std::string& table, const std::vector<std::string>& columns) {
+    PreparedStatement stmt = db_->prepareRead(
+        "SELECT il.name, ii.seqno, ii.name FROM pragma_index_list(?1) il "
+        "JOIN pragma_index_info(il.name) ii ORDER BY il.name, ii.seqno;");
+    if (!stmt || !stmt.bind(1, table)) {
+        return false;
+    }
+
+    std::map<std::string, std::vector<std::string>> indexes;
+    db_->forEachRow(stmt, [&indexes](const RowView& row) {
+        indexes[std::string(row.getText(0))].push_back(lowercase(std::string(row.getText(2))));
+        return true;
+    });
+
+    for (const auto& [name, indexed] : indexes) {
+        if (indexed.size() >= columns.size() &&
+            std::equal(columns.begin(), columns.end(), indexed.begin())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Plan lines read "SCAN <name> ..." (or "SCAN TABLE <name>" on older SQLite);
+// an automatic index is a scan SQLite pays for on every execution
+bool IndexAdvisor::scansTable(const std::string& plan, const std::set<std::string>& names) {
+    std::istringstream lines(plan);
+    std::string line;
+
+    while (std::getline(lines, line)) {
+        std::vector<std::string> words = tokenize(line);
+        if (words.size() < 2 || (words[0] != "scan" && words[0] != "search")) {
+            continue;
+        }
+
+        size_t at = words[1] == "table" && words.size() > 2 ? 2 : 1;
+        if (!names.count(words[at])) {
+            continue;
+        }
+
+        if (words[0] == "scan" || line.find("AUTOMATIC") != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Table -> the names it goes by in the statement (itself and any alias)
+std::map<std::string, std::set<std::string>> IndexAdvisor::tableAliases(const std::vector<std::string>& tokens) {
+    std::map<std::string, std::set<std::string>> aliases;
+
+    for (size_t i = 1; i < tokens.size(); i++) {
+        const std::string& previous = tokens[i - 1];
+        if (!columns_.count(tokens[i]) ||
+            (previous != "from" && previous != "join" && previous != "," && previous != "update")) {
+            continue;
+        }
+
+        std::set<std::string>& names = aliases[tokens[i]];
+        names.insert(tokens[i]);
+
+        size_t next = i + 1;
+        if (next < tokens.size() && tokens[next] == "as") {
+            next++;
+        }
+        if (next < tokens.size() && isIdentifier(tokens[next]) && !keywords().count(tokens[next])) {
+            names.insert(tokens[next]);
+        }
+    }
+
+    return aliases;
+}
+
+// Columns of table compared against something, split by comparison kind
+IndexAdvisor::FilterColumns IndexAdvisor::filterColumns(const std::vector<std::string>& tokens,
+                                                        const std::string& table,
+                                                        const std::set<std::string>& names) {
+    FilterColumns filters;
+    const std::set<std::string>& columns = columns_[table];
+
+    for (size_t i = 0; i < tokens.size(); i++) {
+        // A bare * selects every column (count(*) has a parenthesis before it)
+        if (tokens[i] == "*" && i > 0 && (tokens[i - 1] == "select" || tokens[i - 1] == "," ||
+                                          tokens[i - 1] == "distinct")) {
+            filters.coverable = false;
+        }
+        if (!isIdentifier(tokens[i])) {
+            continue;
+        }
+
+        std::string qualifier;
+        std::string column = tokens[i];
+        size_t end = i + 1;
+        if (i + 2 < tokens.size() && tokens[i + 1] == "." && isIdentifier(tokens[i + 2])) {
+            qualifier = tokens[i];
+            column = tokens[i + 2];
+            end = i + 3;
+        }
+
+        if (tokens[i] != "*" && i + 2 < tokens.size() && tokens[i + 1] == "." && tokens[i + 2] == "*" &&
+            names.count(tokens[i])) {
+            filters.coverable = false;  // alias.*
+        }
+
+        bool belongs = columns.count(column) && (qualifier.empty() || names.count(qualifier));
+        if (belongs) {
+            addUnique(filters.referenced, column);
+
+            const std::string& before = i > 0 ? tokens[i - 1] : std::string();
+            const std::string& after = end < tokens.size() ? tokens[end] : std::string();
+
+            // The other side of the comparison tells a filter from a join
+            const std::string& other = isEqualityOp(after)
+                ? (end + 1 < tokens.size() ? tokens[end + 1] : std::string())
+                : (i > 1 ? tokens[i - 2] : std::string());
+
+            if (isEqualityOp(before) || isEqualityOp(after)) {
+                if (other == "?" || other == "(" || other == "null") {
+                    addUnique(filters.equality, column);
+                } else {
+                    addUnique(filters.joins, column);
+                }
+            } else if (isRangeOp(before) || isRangeOp(after)) {
+                addUnique(filters.range, column);
+            }
+        }
+
+        i = end - 1;
+    }
+
+    return filters;
+}
+
+// Lowercased identifiers, operators and punctuation; literals become ?
+std::vector<std::string> IndexAdvisor::tokenize(const std::string& sql) {
+    std::vector<std::string> tokens;
+    size_t i = 0;
+
+    while (i < sql.size()) {
+        char c = sql[i];
+
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            i++;
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = i;
+            while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '_')) {
+                i++;
+            }
+            tokens.push_back(lowercase(sql.substr(start, i - start)));
+        } else if (c == '"' || c == '`' || c == '[') {
+            char close = c == '[' ? ']' : c;
+            size_t start = ++i;
+            while (i < sql.size() && sql[i] != close) {
+                i++;
+            }
+            tokens.push_back(lowercase(sql.substr(start, i - start)));
+            i++;
+        } else if (c == '\'') {
+            i++;
+            while (i < sql.size() && !(sql[i] == '\'' && (i + 1 >= sql.size() || sql[i + 1] != '\''))) {
+                i += sql[i] == '\'' ? 2 : 1;
+            }
+            i++;
+            tokens.push_back("?");
+        } else if (std::isdigit(static_cast<unsigned char>(c))) {
+            while (i < sql.size() && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '.')) {
+                i++;
+            }
+            tokens.push_back("?");
+        } else if (c == '?') {
+            i++;
+            while (i < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i]))) {
+                i++;
+            }
+            tokens.push_back("?");
+        } else {
+            static const char* pairs[] = {"==", "<=", ">=", "!=", "<>"};
+            std::string token(1, c);
+            for (const char* pair : pairs) {
+                if (sql.compare(i, 2, pair) == 0) {
+                    token = pair;
+                    break;
+                }
+            }
+            tokens.push_back(token);
+            i += token.size();
+        }
+    }
+
+    return tokens;
+}
+
+void IndexAdvisor::printReport(const std::vector<IndexRecommendation>& recommendations, std::ostream& out) {
+    out << "🔍 INDEX ADVISOR (" << recommendations.size() << " recommendations)" << std::endl;
+
+    for (const auto& recommendation : recommendations) {
+        out << (recommendation.created ? "  ✅ " : "  💡 ") << recommendation.ddl()
+            << "  [" << recommendation.reason;
+        if (recommendation.fullscan_steps > 0) {
+            out << ", " << recommendation.fullscan_steps << " full-scan steps";
+        }
+        out << "]" << std::endl;
+        out << "     for: " << recommendation.statement << std::endl;
+        out << "     before:" << std::endl;
+
+        std::istringstream before(recommendation.plan_before);
+        std::string line;
+        while (std::getline(before, line)) {
+            out << "       " << line << std::endl;
+        }
+
+        if (!recommendation.plan_after.empty()) {
+            out << "     after:" << std::endl;
+            std::istringstream after(recommendation.plan_after);
+            while (std::getline(after, line)) {
+                out << "       " << line << std::endl;
+            }
+        }
+
+        if (!recommendation.created && !recommendation.plan_after.empty()) {
+            out << "     ⚠️ no plan improvement - index dropped" << std::endl;
+        }
+    }
+}
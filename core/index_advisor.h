@@ -0,0 +1,79 @@
+// Index advisor - indexes for foreign keys and full scans in the workload
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class Database;
+
+struct IndexRecommendation {
+    std::string table;
+    std::vector<std::string> columns;
+    std::string reason;        // "foreign key" or "workload"
+    std::string statement;     // query the plans below were taken for
+    std::string plan_before;
+    std::string plan_after;
+    uint64_t fullscan_steps = 0; // full-scan steps recorded for the statement
+    bool created = false;
+
+    std::string indexName() const;
+    std::string ddl() const;
+};
+
+/**
+ * Index Advisor - finds missing indexes and proves they help
+ * Two sources feed it: foreign-key columns with no index whose leading
+ * column is that key, and statements in the QueryStats workload whose plan
+ * scans a whole table (or makes SQLite build an automatic index). Every
+ * candidate is explained before and after creating it; a workload index
+ * that does not remove the scan is dropped again.
+ * Workload keys are made covering where they can be: the statement's other
+ * columns of the table follow the filter columns, so the query is answered
+ * from the index alone. Statements selecting * and keys that would exceed
+ * max_covering_columns keep the plain filter key.
+ */
+class IndexAdvisor {
+public:
+    struct Options {
+        bool create = true;                // false = only report proposals
+        uint64_t min_fullscan_steps = 1000;  // ignore scans of tiny tables
+        size_t max_columns = 4;           // filter columns in a key
+        size_t max_covering_columns = 6;  // filter plus projected columns
+    };
+
+    explicit IndexAdvisor(Database* db);
+    IndexAdvisor(Database* db, const Options& options);
+
+    std::vector<IndexRecommendation> adviseForeignKeys();
+    std::vector<IndexRecommendation> adviseWorkload();
+
+    static void printReport(const std::vector<IndexRecommendation>& recommendations, std::ostream& out);
+
+private:
+    struct FilterColumns {
+        std::vector<std::string> equality;  // compared with a value
+        std::vector<std::string> joins;     // compared with another column
+        std::vector<std::string> range;
+        std::vector<std::string> referenced;  // every column of the table the statement reads
+        bool coverable = true;                // false when it selects *
+    };
+
+    void loadTables();
+    bool hasLeadingIndex(const std::string& table, const std::vector<std::string>& columns);
+    bool scansTable(const std::string& plan, const std::set<std::string>& names);
+    void applyRecommendation(IndexRecommendation& recommendation, const std::set<std::string>& names,
+                             bool keep_without_gain);
+    std::vector<std::vector<std::string>> candidateKeys(const FilterColumns& filters) const;
+    std::map<std::string, std::set<std::string>> tableAliases(const std::vector<std::string>& tokens);
+    FilterColumns filterColumns(const std::vector<std::string>& tokens, const std::string& table,
+                                const std::set<std::string>& names);
+
+    static std::vector<std::string> tokenize(const std::string& sql);
+
+    Database* db_;
+    Options options_;
+    std::map<std::string, std::set<std::string>> columns_;  // table -> column names
+};
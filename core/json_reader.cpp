@@ -0,0 +1,598 @@
+// JSON reader for Riley Corpbrain - buffered SAX parsing and record flattening
+#include "json_reader.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <unordered_set>
+
+namespace {
+
+void appendUtf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+void appendQuoted(std::string& out, std::string_view text) {
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out += "\\u00";
+                out += hex[(c >> 4) & 0xF];
+                out += hex[c & 0xF];
+            } else {
+                out += c;
+            }
+        }
+    }
+    out += '"';
+}
+
+void appendNumber(std::string& out, double value) {
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    out.append(text, result.ptr);
+}
+
+// Column names compare ASCII case-insensitively, as SQLite compares them
+struct NameHash {
+    size_t operator()(std::string_view name) const {
+        size_t hash = 14695981039346656037ull;
+        for (unsigned char c : name) {
+            hash = (hash ^ static_cast<size_t>(std::tolower(c))) * 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+struct NameEqual {
+    bool operator()(std::string_view a, std::string_view b) const {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](unsigned char x, unsigned char y) {
+            return std::tolower(x) == std::tolower(y);
+        });
+    }
+};
+
+} // namespace
+
+JsonSaxParser::JsonSaxParser(JsonSaxHandler& handler) : JsonSaxParser(handler, Options()) {}
+
+JsonSaxParser::JsonSaxParser(JsonSaxHandler& handler, const Options& options) : handler_(handler), options_(options) {
+    options_.buffer_bytes = std::max<size_t>(options_.buffer_bytes, 4096);
+}
+
+bool JsonSaxParser::parseFile(const std::string& path) {
+    error_.clear();
+    file_ = std::fopen(path.c_str(), "rb");
+    if (!file_) {
+        error_ = "cannot open " + path;
+        return false;
+    }
+
+    buffer_.resize(options_.buffer_bytes);
+    data_ = buffer_.data();
+    pos_ = len_ = consumed_ = 0;
+    line_ = 1;
+
+    bool ok = parseDocument();
+    std::fclose(file_);
+    file_ = nullptr;
+    return ok;
+}
+
+bool JsonSaxParser::parseText(std::string_view text) {
+    error_.clear();
+    data_ = text.data();
+    pos_ = consumed_ = 0;
+    len_ = text.size();
+    line_ = 1;
+    return parseDocument();
+}
+
+bool JsonSaxParser::refill() {
+    if (!file_) {
+        return false;
+    }
+    consumed_ += len_;
+    pos_ = 0;
+    len_ = std::fread(buffer_.data(), 1, buffer_.size(), file_);
+    return len_ > 0;
+}
+
+void JsonSaxParser::skipWhitespace() {
+    while (true) {
+        int c = peek();
+        if (c == '\n') {
+            line_++;
+        } else if (c != ' ' && c != '\t' && c != '\r') {
+            return;
+        }
+        pos_++;
+    }
+}
+
+bool JsonSaxParser::fail(const std::string& message) {
+    error_ = message + " at line " + std::to_string(line_);
+    return false;
+}
+
+bool JsonSaxParser::parseDocument() {
+    if (peek() == 0xEF) {
+        if (get() != 0xEF || get() != 0xBB || get() != 0xBF) {
+            return fail("unexpected byte");
+        }
+    }
+
+    while (true) {
+        skipWhitespace();
+        if (peek() < 0) {
+            return true;
+        }
+        if (!parseValue(0)) {
+            return false;
+        }
+    }
+}
+
+bool JsonSaxParser::parseValue(size_t depth) {
+    int c = peek();
+    switch (c) {
+    case '{':
+        return parseObject(depth);
+    case '[':
+        return parseArray(depth);
+    case '"':
+        pos_++;
+        return parseString(scratch_) && handler_.string(scratch_);
+    case 't':
+        return parseLiteral("true") && handler_.boolean(true);
+    case 'f':
+        return parseLiteral("false") && handler_.boolean(false);
+    case 'n':
+        return parseLiteral("null") && handler_.null();
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            return parseNumber();
+        }
+        return fail(c < 0 ? "unexpected end of input" : "unexpected character '" + std::string(1, static_cast<char>(c)) + "'");
+    }
+}
+
+bool JsonSaxParser::parseObject(size_t depth) {
+    if (depth >= options_.max_depth) {
+        return fail("nesting deeper than " + std::to_string(options_.max_depth));
+    }
+    pos_++;
+    if (!handler_.startObject()) {
+        return false;
+    }
+
+    skipWhitespace();
+    if (peek() == '}') {
+        pos_++;
+        return handler_.endObject();
+    }
+
+    while (true) {
+        skipWhitespace();
+        if (get() != '"') {
+            return fail("expected member name");
+        }
+        if (!parseString(key_) || !handler_.key(key_)) {
+            return false;
+        }
+
+        skipWhitespace();
+        if (get() != ':') {
+            return fail("expected ':'");
+        }
+        skipWhitespace();
+        if (!parseValue(depth + 1)) {
+            return false;
+        }
+
+        skipWhitespace();
+        int c = get();
+        if (c == '}') {
+            return handler_.endObject();
+        }
+        if (c != ',') {
+            return fail("expected ',' or '}'");
+        }
+    }
+}
+
+bool JsonSaxParser::parseArray(size_t depth) {
+    if (depth >= options_.max_depth) {
+        return fail("nesting deeper than " + std::to_string(options_.max_depth));
+    }
+    pos_++;
+    if (!handler_.startArray()) {
+        return false;
+    }
+
+    skipWhitespace();
+    if (peek() == ']') {
+        pos_++;
+        return handler_.endArray();
+    }
+
+    while (true) {
+        skipWhitespace();
+        if (!parseValue(depth + 1)) {
+            return false;
+        }
+
+        skipWhitespace();
+        int c = get();
+        if (c == ']') {
+            return handler_.endArray();
+        }
+        if (c != ',') {
+            return fail("expected ',' or ']'");
+        }
+    }
+}
+
+bool JsonSaxParser::parseString(std::string& out) {
+    out.clear();
+    while (true) {
+        // Copy the run up to the next quote, escape or control byte at once
+        size_t start = pos_;
+        while (pos_ < len_) {
+            unsigned char c = static_cast<unsigned char>(data_[pos_]);
+            if (c == '"' || c == '\\' || c < 0x20) {
+                break;
+            }
+            pos_++;
+        }
+        out.append(data_ + start, pos_ - start);
+        if (pos_ == len_) {
+            if (!refill()) {
+                return fail("unterminated string");
+            }
+            continue;  // the run reached the end of the buffer
+        }
+
+        int c = get();
+        if (c == '"') {
+            return true;
+        }
+        if (c != '\\') {
+            return fail("control character in string");
+        }
+
+        switch (get()) {
+        case '"': out += '"'; break;
+        case '\\': out += '\\'; break;
+        case '/': out += '/'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+            uint32_t code;
+            if (!readHex(code)) {
+                return false;
+            }
+            if (code >= 0xD800 && code < 0xDC00) {
+                uint32_t low;
+                if (get() != '\\' || get() != 'u' || !readHex(low) || low < 0xDC00 || low >= 0xE000) {
+                    return fail("unpaired surrogate");
+                }
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+            } else if (code >= 0xDC00 && code < 0xE000) {
+                return fail("unpaired surrogate");
+            }
+            appendUtf8(out, code);
+            break;
+        }
+        default:
+            return fail("invalid escape");
+        }
+    }
+}
+
+bool JsonSaxParser::readHex(uint32_t& value) {
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+        int c = get();
+        int digit = (c >= '0' && c <= '9') ? c - '0'
+                  : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                  : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                           : -1;
+        if (digit < 0) {
+            return fail("invalid \\u escape");
+        }
+        value = value * 16 + digit;
+    }
+    return true;
+}
+
+bool JsonSaxParser::parseNumber() {
+    scratch_.clear();
+    bool integral = true;
+    while (true) {
+        int c = peek();
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+') {
+            scratch_ += static_cast<char>(c);
+        } else if (c == '.' || c == 'e' || c == 'E') {
+            scratch_ += static_cast<char>(c);
+            integral = false;
+        } else {
+            break;
+        }
+        pos_++;
+    }
+
+    const char* first = scratch_.data();
+    const char* last = first + scratch_.size();
+    if (integral) {
+        int64_t value;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec == std::errc() && result.ptr == last) {
+            return handler_.integer(value);
+        }
+    }
+
+    // Fractions, exponents and integers beyond 64 bits
+    double value;
+    auto result = std::from_chars(first, last, value);
+    if (result.ec != std::errc() || result.ptr != last) {
+        return fail("invalid number '" + scratch_ + "'");
+    }
+    return handler_.number(value);
+}
+
+bool JsonSaxParser::parseLiteral(const char* literal) {
+    for (const char* p = literal; *p; p++) {
+        if (get() != static_cast<unsigned char>(*p)) {
+            return fail(std::string("invalid literal, expected ") + literal);
+        }
+    }
+    return true;
+}
+
+JsonRecordReader::JsonRecordReader() : JsonRecordReader(Options()) {}
+
+JsonRecordReader::JsonRecordReader(const Options& options) : options_(options) {
+    size_t start = 0;
+    while (!options_.records_path.empty() && start <= options_.records_path.size()) {
+        size_t dot = std::min(options_.records_path.find('.', start), options_.records_path.size());
+        path_.push_back(options_.records_path.substr(start, dot - start));
+        start = dot + 1;
+    }
+}
+
+bool JsonRecordReader::read(const std::string& path, const std::function<bool(JsonRecord&)>& consumer) {
+    return run([&path](JsonSaxParser& parser) { return parser.parseFile(path); }, consumer);
+}
+
+bool JsonRecordReader::readText(std::string_view text, const std::function<bool(JsonRecord&)>& consumer) {
+    return run([text](JsonSaxParser& parser) { return parser.parseText(text); }, consumer);
+}
+
+bool JsonRecordReader::run(const std::function<bool(JsonSaxParser&)>& parse, const std::function<bool(JsonRecord&)>& consumer) {
+    consumer_ = &consumer;
+    frames_.clear();
+    pending_key_.clear();
+    in_record_ = false;
+    prefix_.clear();
+    prefix_lengths_.clear();
+    record_.clear();
+    capture_first_.clear();
+    records_ = 0;
+    error_.clear();
+
+    JsonSaxParser parser(*this);
+    bool ok = parse(parser);
+    if (!ok && error_.empty()) {
+        error_ = parser.error();  // stays empty when the consumer stopped the read
+    }
+    consumer_ = nullptr;
+    return ok;
+}
+
+bool JsonRecordReader::atRecordArray() const {
+    if (frames_.empty() || !frames_.back().array || frames_.size() != path_.size() + 1) {
+        return false;
+    }
+    for (size_t i = 0; i < path_.size(); i++) {
+        if (frames_[i + 1].key != path_[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JsonRecordReader::emit() {
+    // A flattened name can repeat a literal key - {"b":{"c":1},"b_c":2} -
+    // and so can a key given twice; later duplicates are suffixed like
+    // CSV headers so no value overwrites another
+    if (record_.size() > 1) {
+        std::unordered_set<std::string_view, NameHash, NameEqual> seen;
+        for (auto& field : record_) {
+            if (seen.count(field.first)) {
+                std::string base = field.first;
+                for (int n = 2; seen.count(field.first); n++) {
+                    field.first = base + "_" + std::to_string(n);
+                }
+            }
+            seen.insert(field.first);
+        }
+    }
+
+    records_++;
+    bool keep_going = (*consumer_)(record_);
+    record_.clear();
+    return keep_going;
+}
+
+void JsonRecordReader::captureSeparator() {
+    // Inside an object the key already wrote its separator
+    if (capture_first_.back()) {
+        capture_first_.back() = false;
+    } else if (capture_.back() != ':') {
+        capture_ += ',';
+    }
+}
+
+bool JsonRecordReader::startObject() {
+    if (!capture_first_.empty()) {
+        captureSeparator();
+        capture_ += '{';
+        capture_first_.push_back(true);
+        return true;
+    }
+
+    if (in_record_) {
+        prefix_lengths_.push_back(prefix_.size());
+        prefix_ += pending_key_ + options_.separator;
+        return true;
+    }
+
+    if ((frames_.empty() && path_.empty()) || atRecordArray()) {
+        in_record_ = true;
+        return true;
+    }
+
+    frames_.push_back({false, frames_.empty() || frames_.back().array ? std::string() : pending_key_});
+    return true;
+}
+
+bool JsonRecordReader::endObject() {
+    if (!capture_first_.empty()) {
+        capture_ += '}';
+        capture_first_.pop_back();
+        return true;
+    }
+
+    if (in_record_) {
+        if (prefix_lengths_.empty()) {
+            in_record_ = false;
+            return emit();
+        }
+        prefix_.resize(prefix_lengths_.back());
+        prefix_lengths_.pop_back();
+        return true;
+    }
+
+    frames_.pop_back();
+    return true;
+}
+
+bool JsonRecordReader::startArray() {
+    if (!capture_first_.empty()) {
+        captureSeparator();
+        capture_ += '[';
+        capture_first_.push_back(true);
+        return true;
+    }
+
+    if (in_record_) {
+        capture_column_ = prefix_ + pending_key_;
+        capture_ = "[";
+        capture_first_.push_back(true);
+        return true;
+    }
+
+    frames_.push_back({true, frames_.empty() || frames_.back().array ? std::string() : pending_key_});
+    return true;
+}
+
+bool JsonRecordReader::endArray() {
+    if (!capture_first_.empty()) {
+        capture_ += ']';
+        capture_first_.pop_back();
+        if (capture_first_.empty()) {
+            record_.emplace_back(std::move(capture_column_), std::move(capture_));
+            capture_.clear();
+            capture_column_.clear();
+        }
+        return true;
+    }
+
+    frames_.pop_back();
+    return true;
+}
+
+bool JsonRecordReader::key(std::string_view name) {
+    if (!capture_first_.empty()) {
+        captureSeparator();
+        appendQuoted(capture_, name);
+        capture_ += ':';
+        return true;
+    }
+    pending_key_.assign(name.data(), name.size());
+    return true;
+}
+
+bool JsonRecordReader::scalar(SqlValue value, const char* literal) {
+    if (!capture_first_.empty()) {
+        captureSeparator();
+        if (literal) {
+            capture_ += literal;
+        } else if (auto* text = std::get_if<std::string>(&value)) {
+            appendQuoted(capture_, *text);
+        } else if (auto* integer = std::get_if<int64_t>(&value)) {
+            capture_ += std::to_string(*integer);
+        } else {
+            appendNumber(capture_, std::get<double>(value));
+        }
+        return true;
+    }
+
+    if (in_record_) {
+        record_.emplace_back(prefix_ + pending_key_, std::move(value));
+        return true;
+    }
+
+    // A bare scalar where a record was expected
+    if (frames_.empty() ? path_.empty() : atRecordArray()) {
+        record_.emplace_back("value", std::move(value));
+        return emit();
+    }
+    return true;
+}
+
+bool JsonRecordReader::string(std::string_view value) {
+    return scalar(std::string(value));
+}
+
+bool JsonRecordReader::integer(int64_t value) {
+    return scalar(value);
+}
+
+bool JsonRecordReader::number(double value) {
+    return scalar(value);
+}
+
+bool JsonRecordReader::boolean(bool value) {
+    return scalar(int64_t{value}, value ? "true" : "false");
+}
+
+bool JsonRecordReader::null() {
+    return scalar(nullptr, "null");
+}
@@ -0,0 +1,164 @@
+// JSON reader - streaming SAX parser and record flattening for imports
+#pragma once
+#include "statement_cache.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * JsonSaxHandler - receives parse events in document order
+ * Returning false from any event stops the parse. String views are only
+ * valid for the duration of the call.
+ */
+class JsonSaxHandler {
+public:
+    virtual ~JsonSaxHandler() = default;
+
+    virtual bool startObject() = 0;
+    virtual bool endObject() = 0;
+    virtual bool startArray() = 0;
+    virtual bool endArray() = 0;
+    virtual bool key(std::string_view name) = 0;
+    virtual bool string(std::string_view value) = 0;
+    virtual bool integer(int64_t value) = 0;
+    virtual bool number(double value) = 0;
+    virtual bool boolean(bool value) = 0;
+    virtual bool null() = 0;
+};
+
+/**
+ * JSON SAX Parser - streams a file through a fixed-size buffer
+ * Memory use is the read buffer plus the longest single string or number,
+ * whatever the file size. Any number of whitespace-separated top-level
+ * values are accepted, so one JSON document and NDJSON (one value per
+ * line) go through the same path.
+ */
+class JsonSaxParser {
+public:
+    struct Options {
+        size_t buffer_bytes = 1 << 20;
+        size_t max_depth = 256;
+    };
+
+    explicit JsonSaxParser(JsonSaxHandler& handler);
+    JsonSaxParser(JsonSaxHandler& handler, const Options& options);
+
+    bool parseFile(const std::string& path);
+    bool parseText(std::string_view text);
+
+    // Empty when the handler stopped the parse
+    const std::string& error() const { return error_; }
+    size_t line() const { return line_; }
+    size_t bytesRead() const { return consumed_ + pos_; }
+
+private:
+    bool parseDocument();
+    bool parseValue(size_t depth);
+    bool parseObject(size_t depth);
+    bool parseArray(size_t depth);
+    bool parseString(std::string& out);
+    bool parseNumber();
+    bool parseLiteral(const char* literal);
+    bool readHex(uint32_t& value);
+
+    int peek() { return pos_ < len_ || refill() ? static_cast<unsigned char>(data_[pos_]) : -1; }
+    int get() { return pos_ < len_ || refill() ? static_cast<unsigned char>(data_[pos_++]) : -1; }
+    bool refill();
+    void skipWhitespace();
+    bool fail(const std::string& message);
+
+    JsonSaxHandler& handler_;
+    Options options_;
+
+    std::FILE* file_ = nullptr;
+    std::vector<char> buffer_;
+    const char* data_ = nullptr;
+    size_t pos_ = 0;
+    size_t len_ = 0;
+    size_t consumed_ = 0;
+    size_t line_ = 1;
+
+    std::string key_;
+    std::string scratch_;
+    std::string error_;
+};
+
+using JsonRecord = std::vector<std::pair<std::string, SqlValue>>;
+
+/**
+ * JSON Record Reader - turns a JSON or NDJSON stream into flat records
+ * Records are the objects inside the top-level array, every top-level
+ * object (NDJSON), or - with records_path "data" or "result.items" - the
+ * elements of the array at that key path. Each record is handed over as
+ * soon as it closes, so only one record is ever held.
+ *
+ * Nested objects become columns joined with separator ("address_city");
+ * arrays inside a record are kept as compact JSON text. A name that
+ * repeats an earlier one in the record gets _2, _3... as CSV headers do.
+ * Booleans are stored as 0/1. Top-level scalars become a record with a "value" column.
+ */
+class JsonRecordReader : private JsonSaxHandler {
+public:
+    struct Options {
+        std::string records_path;
+        std::string separator = "_";
+    };
+
+    JsonRecordReader();
+    explicit JsonRecordReader(const Options& options);
+
+    bool read(const std::string& path, const std::function<bool(JsonRecord&)>& consumer);
+    bool readText(std::string_view text, const std::function<bool(JsonRecord&)>& consumer);
+
+    const std::string& error() const { return error_; }
+    size_t recordCount() const { return records_; }
+
+private:
+    bool run(const std::function<bool(JsonSaxParser&)>& parse, const std::function<bool(JsonRecord&)>& consumer);
+
+    bool startObject() override;
+    bool endObject() override;
+    bool startArray() override;
+    bool endArray() override;
+    bool key(std::string_view name) override;
+    bool string(std::string_view value) override;
+    bool integer(int64_t value) override;
+    bool number(double value) override;
+    bool boolean(bool value) override;
+    bool null() override;
+
+    bool scalar(SqlValue value, const char* literal = nullptr);
+    bool atRecordArray() const;
+    bool emit();
+    void captureSeparator();
+
+    struct Frame {
+        bool array;
+        std::string key;  // member name the container was opened under
+    };
+
+    Options options_;
+    std::vector<std::string> path_;
+    const std::function<bool(JsonRecord&)>* consumer_ = nullptr;
+
+    std::vector<Frame> frames_;  // containers outside the current record
+    std::string pending_key_;
+
+    bool in_record_ = false;
+    std::string prefix_;
+    std::vector<size_t> prefix_lengths_;  // one per nested object inside the record
+    JsonRecord record_;
+
+    // Arrays inside a record are re-serialized into one text column
+    std::string capture_;
+    std::string capture_column_;
+    std::vector<bool> capture_first_;  // per open container: no element yet
+
+    size_t records_ = 0;
+    std::string error_;
+};
@@ -0,0 +1,80 @@
+// Keyset pager for Riley Corpbrain - seek pagination for list views
+#include "keyset_pager.h"
+#include "database.h"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <utility>
+
+KeysetPager::KeysetPager(Database* db, std::string table, std::set<std::string> filterable)
+    : db_(db), table_(std::move(table)), filterable_(std::move(filterable)) {}
+
+Page KeysetPager::fetch(const PageRequest& request) const {
+    Page page;
+
+    for (const auto& [column, value] : request.filters) {
+        if (!filterable_.count(column)) {
+            std::cerr << "⚠️ " << table_ << " cannot be filtered on " << column << std::endl;
+            return page;
+        }
+    }
+
+    int limit = std::clamp(request.limit, 1, 1000);
+    int64_t cursor = request.after_id;
+    if (request.newest_first && cursor <= 0) {
+        cursor = std::numeric_limits<int64_t>::max();
+    }
+
+    // Filter columns are whitelisted, so only they are spliced into the SQL;
+    // each distinct filter combination becomes one cached statement
+    std::string sql = "SELECT * FROM " + table_ + " WHERE id " + (request.newest_first ? "<" : ">") + " ?1";
+    int parameter = 3;
+    for (const auto& filter : request.filters) {
+        sql += " AND " + filter.first + " = ?" + std::to_string(parameter++);
+    }
+    sql += std::string(" ORDER BY id") + (request.newest_first ? " DESC" : "") + " LIMIT ?2;";
+
+    PreparedStatement stmt = db_->prepareRead(sql);
+    if (!stmt || !stmt.bind(1, cursor) || !stmt.bind(2, limit + 1)) {
+        return page;
+    }
+
+    parameter = 3;
+    for (const auto& filter : request.filters) {
+        stmt.bind(parameter++, filter.second);
+    }
+
+    // One extra row tells whether another page follows
+    int64_t last_id = 0;
+    Database::forEachRow(stmt, [&](const RowView& row) {
+        if (static_cast<int>(page.rows.size()) == limit) {
+            page.has_more = true;
+            return false;
+        }
+
+        std::map<std::string, std::string> values;
+        for (int i = 0; i < row.columnCount(); i++) {
+            values[row.columnName(i)] = std::string(row.getText(i));
+        }
+        last_id = row.getInt64("id");
+        page.rows.push_back(std::move(values));
+        return true;
+    });
+
+    page.next_cursor = page.has_more ? last_id : 0;
+    return page;
+}
+
+std::vector<std::map<std::string, std::string>> KeysetPager::fetchAll(PageRequest request) const {
+    std::vector<std::map<std::string, std::string>> rows;
+    request.limit = 1000;
+    for (;;) {
+        Page page = fetch(request);
+        rows.insert(rows.end(), std::make_move_iterator(page.rows.begin()), std::make_move_iterator(page.rows.end()));
+        if (!page.has_more) {
+            return rows;
+        }
+        request.after_id = page.next_cursor;
+    }
+}
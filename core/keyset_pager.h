@@ -0,0 +1,46 @@
+// Keyset pager - constant-cost paging through large tables
+#pragma once
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class Database;
+
+struct PageRequest {
+    int64_t after_id = 0;   // cursor from the previous page; 0 starts at the beginning
+    int limit = 50;         // clamped to 1..1000
+    bool newest_first = false;
+    std::map<std::string, std::string> filters;  // column = value, ANDed
+};
+
+struct Page {
+    std::vector<std::map<std::string, std::string>> rows;
+    int64_t next_cursor = 0;  // after_id for the next page
+    bool has_more = false;
+};
+
+/**
+ * Keyset Pager - seek-based pagination over an integer primary key
+ * Each page is "WHERE id > cursor ORDER BY id LIMIT n", so fetching page
+ * 10,000 costs the same as page 1 (OFFSET would skip every earlier row),
+ * and cursors stay stable while rows are inserted or deleted around them.
+ * Filters are restricted to a per-table whitelist of columns; values are
+ * always bound. An index on a filter column also serves the id ordering,
+ * since SQLite appends the rowid to every index.
+ */
+class KeysetPager {
+public:
+    KeysetPager(Database* db, std::string table, std::set<std::string> filterable);
+
+    Page fetch(const PageRequest& request) const;
+
+    // Every matching row, fetched page by page - for callers that predate paging
+    std::vector<std::map<std::string, std::string>> fetchAll(PageRequest request) const;
+
+private:
+    Database* db_;
+    std::string table_;
+    std::set<std::string> filterable_;
+};
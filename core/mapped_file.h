@@ -0,0 +1,42 @@
+// Mapped file - read-only memory mapping of a whole file
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * Mapped File - maps a file read-only into the address space
+ * Importers parse straight out of the mapping, so multi-GB exports are
+ * paged in by the OS on demand instead of being copied through stream
+ * buffers. Empty files map to an empty view.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return open_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    std::string_view view() const { return std::string_view(data_, size_); }
+    const std::string& error() const { return error_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+    std::string error_;
+
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
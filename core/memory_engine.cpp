@@ -1,11 +1,35 @@
 #include "memory_engine.h"
 #include "database.h"
+#include "text_search.h"
 #include <iostream>
 #include <algorithm>
 #include <random>
 #include <sstream>
 #include <iomanip>
 
+namespace {
+const char* kMemoryColumns = "m.id, m.type, m.content, m.tags, m.importance, m.created_ms";
+
+// Text matches re-ranked per result returned
+const size_t kCandidatesPerResult = 10;
+
+// A row of kMemoryColumns
+MemoryEngine::MemoryEntry memoryFromRow(const RowView& row) {
+    MemoryEngine::MemoryEntry entry{};
+    entry.id = std::string(row.getText(0));
+    entry.type = static_cast<MemoryEngine::MemoryType>(row.getInt64(1));
+    entry.content = std::string(row.getText(2));
+    entry.importance_score = row.getDouble(4);
+    entry.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(row.getInt64(5)));
+    
+    std::istringstream tags{std::string(row.getText(3))};
+    for (std::string tag; tags >> tag;) {
+        entry.tags.push_back(tag);
+    }
+    return entry;
+}
+}
+
 MemoryEngine::MemoryEngine(Database* db) : db_(db) {
     std::cout << "🧠 Initializing Memory Engine..." << std::endl;
     
@@ -19,6 +43,19 @@ MemoryEngine::MemoryEngine(Database* db) : db_(db) {
     
     last_consolidation_ = std::chrono::system_clock::now();
     
+    // Memories persist in SQLite with a full-text index over content and tags
+    db_->ensureSchema("memory", R"(
+        CREATE TABLE IF NOT EXISTS memories (
+            id TEXT PRIMARY KEY,
+            type INTEGER NOT NULL,
+            content TEXT NOT NULL,
+            tags TEXT,
+            importance REAL DEFAULT 0.0,
+            created_ms INTEGER
+        );
+    )");
+    TextSearch::install(db_, "memories", "memories", {"content", "tags"});
+    
     // Load existing memories from database
     loadAssociationsFromDB();
     
@@ -84,59 +121,74 @@ std::vector<MemoryEngine::MemoryEntry> MemoryEngine::searchMemories(const Memory
     
     std::vector<MemoryEntry> results;
     
-    // Search through all memories
-    for (const auto& [id, memory] : memory_store_) {
-        bool matches = true;
-        
+    auto matchesFilters = [&query](const MemoryEntry& memory) {
         // Check memory type
         if (query.preferred_type != MemoryType::SHORT_TERM && memory.type != query.preferred_type) {
-            continue;
+            return false;
         }
         
         // Check importance threshold
         if (memory.importance_score < query.min_importance) {
-            continue;
+            return false;
         }
         
         // Check required tags
         for (const auto& required_tag : query.required_tags) {
             if (std::find(memory.tags.begin(), memory.tags.end(), required_tag) == memory.tags.end()) {
-                matches = false;
-                break;
+                return false;
             }
         }
         
-        if (!matches) continue;
-        
         // Check time range
         if (query.time_range_start != std::chrono::system_clock::time_point{} &&
             memory.timestamp < query.time_range_start) {
-            continue;
+            return false;
         }
         
         if (query.time_range_end != std::chrono::system_clock::time_point{} &&
             memory.timestamp > query.time_range_end) {
-            continue;
+            return false;
         }
         
-        // Check content relevance (simple text search)
-        if (!query.query_text.empty()) {
-            std::string content_lower = memory.content;
-            std::string query_lower = query.query_text;
-            std::transform(content_lower.begin(), content_lower.end(), content_lower.begin(), ::tolower);
-            std::transform(query_lower.begin(), query_lower.end(), query_lower.begin(), ::tolower);
-            
-            if (content_lower.find(query_lower) == std::string::npos) {
-                continue;
+        return true;
+    };
+    
+    if (query.query_text.empty()) {
+        for (const auto& [id, memory] : memory_store_) {
+            if (matchesFilters(memory)) {
+                results.push_back(memory);
             }
         }
         
-        results.push_back(memory);
+        // Rank by relevance
+        results = rankMemoriesByRelevance(results, query);
+    } else {
+        // Full-text index lookup - candidates arrive best bm25 match first.
+        // The best few times max_results of them that pass the filters are
+        // re-ranked like the unfiltered path, so importance and recency
+        // still count among text matches.
+        size_t pool = query.max_results > 0 ? static_cast<size_t>(query.max_results) * kCandidatesPerResult : 0;
+        std::string match = TextSearch::toMatchQuery(query.query_text);
+        PreparedStatement stmt = db_->prepareRead(
+            std::string("SELECT ") + kMemoryColumns + " FROM memories_fts f JOIN memories m ON m.rowid = f.rowid "
+            "WHERE memories_fts MATCH ?1 ORDER BY f.rank;");
+        
+        if (!match.empty() && stmt && stmt.bind(1, match)) {
+            Database::forEachRow(stmt, [&](const RowView& row) {
+                // The in-process copy also carries metadata and access counts
+                auto it = memory_store_.find(std::string(row.getText(0)));
+                MemoryEntry memory = it != memory_store_.end() ? it->second : memoryFromRow(row);
+                
+                if (matchesFilters(memory)) {
+                    results.push_back(std::move(memory));
+                }
+                return pool == 0 || results.size() < pool;
+            });
+        }
+        
+        results = rankMemoriesByRelevance(results, query);
     }
     
-    // Rank by relevance
-    results = rankMemoriesByRelevance(results, query);
-    
     // Limit results
     if (query.max_results > 0 && results.size() > static_cast<size_t>(query.max_results)) {
         results.resize(query.max_results);
@@ -383,16 +435,35 @@ std::vector<MemoryEngine::MemoryEntry> MemoryEngine::rankMemoriesByRelevance(con
 }
 
 void MemoryEngine::saveMemoryToDB(const MemoryEntry& entry) {
-    // In a real implementation, this would save to the database
-    // For now, just log the operation
-    std::cout << "💾 Saving memory to DB: " << entry.id << std::endl;
+    std::string tags;
+    for (const auto& tag : entry.tags) {
+        tags += (tags.empty() ? "" : " ") + tag;
+    }
+    int64_t created_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        entry.timestamp.time_since_epoch()).count();
+    
+    // Memories are stored in bursts - let the write queue batch them.
+    // The full-text index follows through its triggers.
+    db_->enqueueWrite(
+        "INSERT INTO memories (id, type, content, tags, importance, created_ms) VALUES (?1, ?2, ?3, ?4, ?5, ?6) "
+        "ON CONFLICT(id) DO UPDATE SET type = excluded.type, content = excluded.content, tags = excluded.tags, "
+        "importance = excluded.importance;",
+        {entry.id, static_cast<int64_t>(entry.type), entry.content, tags, entry.importance_score, created_ms});
 }
 
 MemoryEngine::MemoryEntry MemoryEngine::loadMemoryFromDB(const std::string& memory_id) {
-    // In a real implementation, this would load from the database
-    // For now, return an empty entry
-    std::cout << "📖 Loading memory from DB: " << memory_id << std::endl;
-    return MemoryEntry{};
+    MemoryEntry entry{};
+    
+    PreparedStatement stmt = db_->prepareRead(
+        std::string("SELECT ") + kMemoryColumns + " FROM memories m WHERE m.id = ?1;");
+    if (stmt && stmt.bind(1, memory_id)) {
+        Database::forEachRow(stmt, [&entry](const RowView& row) {
+            entry = memoryFromRow(row);
+            return false;
+        });
+    }
+    
+    return entry;
 }
 
 void MemoryEngine::saveAssociationsToDB() {
@@ -0,0 +1,309 @@
+// Metric partitions for Riley Corpbrain - monthly raw files, rollups in the main database
+#include "metric_partitions.h"
+#include "database.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr int64_t kSecondsPerDay = 86400;
+
+// Days since 1970-01-01 to civil year/month (UTC), by arithmetic - gmtime
+// is not thread-safe and its _r/_s variants are platform specific
+void civilFromDays(int64_t days, int& year, int& month) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int64_t doe = days - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+// Inverse of civilFromDays for the first of a month
+int64_t daysFromCivil(int year, int month) {
+    year -= month <= 2 ? 1 : 0;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yoe = year - era * 400;
+    int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+int64_t monthIndex(int64_t ts) {
+    int64_t days = ts >= 0 ? ts / kSecondsPerDay : (ts - kSecondsPerDay + 1) / kSecondsPerDay;
+    int year, month;
+    civilFromDays(days, year, month);
+    return static_cast<int64_t>(year) * 12 + (month - 1);
+}
+
+int64_t monthStart(int64_t index) {
+    return daysFromCivil(static_cast<int>(index / 12), static_cast<int>(index % 12 + 1)) * kSecondsPerDay;
+}
+
+std::string keyFromIndex(int64_t index) {
+    char key[16];
+    std::snprintf(key, sizeof(key), "%04d_%02d", static_cast<int>(index / 12), static_cast<int>(index % 12 + 1));
+    return key;
+}
+
+int64_t toSeconds(std::chrono::system_clock::time_point at) {
+    return std::chrono::duration_cast<std::chrono::seconds>(at.time_since_epoch()).count();
+}
+
+// One row per grain; the month bucket is computed by SQLite's calendar
+const char* kRollupSql = R"(
+    INSERT INTO metric_rollups (series, dimension, grain, bucket, count, sum, min, max) VALUES
+        (?1, ?2, 'hour', ?3 - ?3 % 3600, 1, ?4, ?4, ?4),
+        (?1, ?2, 'day', ?3 - ?3 % 86400, 1, ?4, ?4, ?4),
+        (?1, ?2, 'month', CAST(strftime('%s', ?3, 'unixepoch', 'start of month') AS INTEGER), 1, ?4, ?4, ?4)
+    ON CONFLICT(series, dimension, grain, bucket) DO UPDATE SET
+        count = count + 1, sum = sum + excluded.sum,
+        min = MIN(min, excluded.min), max = MAX(max, excluded.max);
+)";
+
+} // namespace
+
+MetricPartitions::MetricPartitions(Database* db, const Options& options) : db_(db), options_(options) {
+    std::error_code error;
+    std::filesystem::create_directories(options_.directory, error);
+    if (error) {
+        throw std::runtime_error("Cannot create partition directory " + options_.directory + ": " + error.message());
+    }
+
+    bool ready = db_->ensureSchema("metric_rollups", R"(
+        CREATE TABLE IF NOT EXISTS metric_rollups (
+            series TEXT NOT NULL,
+            dimension TEXT NOT NULL DEFAULT '',
+            grain TEXT NOT NULL,
+            bucket INTEGER NOT NULL,
+            count INTEGER NOT NULL,
+            sum REAL NOT NULL,
+            min REAL,
+            max REAL,
+            PRIMARY KEY (series, grain, bucket, dimension)
+        ) WITHOUT ROWID;
+    )");
+    if (!ready) {
+        throw std::runtime_error("Cannot create metric_rollups");
+    }
+
+    applyRetention();
+}
+
+MetricPartitions::~MetricPartitions() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeCurrent();
+}
+
+bool MetricPartitions::record(const std::string& series, double value, const std::string& dimension,
+                              std::chrono::system_clock::time_point at) {
+    int64_t ts = toSeconds(at);
+    std::string month = monthKey(ts);
+    bool rolled_over = false;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (month != current_month_) {
+            rolled_over = !current_month_.empty() && month > current_month_;
+            if (!openCurrent(month)) {
+                return false;
+            }
+        }
+
+        PreparedStatement stmt = statements_->acquire(
+            "INSERT INTO points (series, ts, value, dimension) VALUES (?1, ?2, ?3, ?4);");
+        if (!stmt || !stmt.bind(1, series) || !stmt.bind(2, ts) || !stmt.bind(3, value) ||
+            !stmt.bind(4, dimension) || !stmt.execute()) {
+            std::cerr << "❌ Metric point not stored: " << sqlite3_errmsg(current_) << std::endl;
+            return false;
+        }
+    }
+
+    // Rollups are small and hot - let the write queue batch them
+    db_->enqueueWrite(kRollupSql, {series, dimension, ts, value});
+
+    if (rolled_over) {
+        applyRetention();
+    }
+    return true;
+}
+
+std::vector<MetricPoint> MetricPartitions::range(const std::string& series,
+                                                 std::chrono::system_clock::time_point from,
+                                                 std::chrono::system_clock::time_point to) {
+    std::vector<MetricPoint> points;
+    int64_t first = toSeconds(from);
+    int64_t last = toSeconds(to);
+
+    // Partition pruning: only the months the range overlaps are opened
+    for (int64_t index = monthIndex(first); index <= monthIndex(last); index++) {
+        std::string path = partitionPath(keyFromIndex(index));
+        if (!std::filesystem::exists(path)) {
+            continue;
+        }
+
+        sqlite3* handle = nullptr;
+        if (sqlite3_open_v2(path.c_str(), &handle, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) != SQLITE_OK) {
+            std::cerr << "❌ Cannot open partition " << path << ": " << sqlite3_errmsg(handle) << std::endl;
+            sqlite3_close(handle);
+            continue;
+        }
+        sqlite3_busy_timeout(handle, 5000);
+
+        {
+            StatementCache statements(handle, 1);
+            statements.setQueryStats(&db_->queryStats());
+
+            PreparedStatement stmt = statements.acquire(
+                "SELECT ts, value, dimension FROM points WHERE series = ?1 AND ts BETWEEN ?2 AND ?3 ORDER BY ts;");
+            if (stmt && stmt.bind(1, series) && stmt.bind(2, first) && stmt.bind(3, last)) {
+                Database::forEachRow(stmt, [&points](const RowView& row) {
+                    points.push_back({row.getInt64(0), row.getDouble(1), std::string(row.getText(2))});
+                    return true;
+                });
+            }
+        }
+        sqlite3_close(handle);
+    }
+
+    return points;
+}
+
+std::vector<RollupBucket> MetricPartitions::trend(const std::string& series, const std::string& grain, int periods) {
+    std::vector<RollupBucket> buckets;
+
+    // Buckets are numbered so that consecutive periods differ by one
+    int64_t size = grain == "hour" ? 3600 : grain == "day" ? kSecondsPerDay : 0;
+    auto indexOf = [size](int64_t bucket) { return size ? bucket / size : monthIndex(bucket); };
+    auto startOf = [size](int64_t index) { return size ? index * size : monthStart(index); };
+
+    PreparedStatement latest = db_->prepareRead(
+        "SELECT MAX(bucket) FROM metric_rollups WHERE series = ?1 AND grain = ?2;");
+    if (periods <= 0 || !latest || !latest.bind(1, series) || !latest.bind(2, grain) || !latest.step() ||
+        latest.columnType(0) == SqlType::NULL_VALUE) {
+        return buckets;
+    }
+    int64_t last = indexOf(latest.getInt64(0));
+    int64_t first = last - periods + 1;
+    latest = PreparedStatement();
+
+    for (int64_t index = first; index <= last; index++) {
+        buckets.push_back({startOf(index), 0, 0.0, 0.0, 0.0});
+    }
+
+    PreparedStatement stmt = db_->prepareRead(
+        "SELECT bucket, SUM(count), SUM(sum), MIN(min), MAX(max) FROM metric_rollups "
+        "WHERE series = ?1 AND grain = ?2 AND bucket >= ?3 GROUP BY bucket;");
+    if (!stmt || !stmt.bind(1, series) || !stmt.bind(2, grain) || !stmt.bind(3, startOf(first))) {
+        return {};
+    }
+
+    Database::forEachRow(stmt, [&](const RowView& row) {
+        int64_t index = indexOf(row.getInt64(0));
+        if (index >= first && index <= last) {
+            buckets[static_cast<size_t>(index - first)] =
+                {row.getInt64(0), row.getInt64(1), row.getDouble(2), row.getDouble(3), row.getDouble(4)};
+        }
+        return true;
+    });
+
+    return buckets;
+}
+
+void MetricPartitions::applyRetention() {
+    int64_t now = toSeconds(std::chrono::system_clock::now());
+
+    // Raw points: whole month files go at once
+    std::string cutoff = keyFromIndex(monthIndex(now) - options_.raw_retention_months);
+    std::vector<std::filesystem::path> expired;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(options_.directory, error)) {
+        std::string name = entry.path().filename().string();
+        // metrics_YYYY_MM.db
+        if (name.size() == 18 && name.compare(0, 8, "metrics_") == 0 && name.compare(15, 3, ".db") == 0 &&
+            name.substr(8, 7) < cutoff) {
+            expired.push_back(entry.path());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& path : expired) {
+            if (path.filename().string() == "metrics_" + current_month_ + ".db") {
+                closeCurrent();
+            }
+            for (const char* suffix : {"", "-wal", "-shm"}) {
+                std::filesystem::remove(path.string() + suffix, error);
+            }
+            std::cout << "🗑️ Dropped metric partition " << path.filename().string() << std::endl;
+        }
+    }
+
+    // Fine-grained rollups age out; monthly ones are kept for long-range trends
+    db_->executeWithParams("DELETE FROM metric_rollups WHERE grain = 'hour' AND bucket < ?1;",
+                           {std::to_string(now - options_.hourly_retention_days * kSecondsPerDay)});
+    db_->executeWithParams("DELETE FROM metric_rollups WHERE grain = 'day' AND bucket < ?1;",
+                           {std::to_string(now - options_.daily_retention_days * kSecondsPerDay)});
+}
+
+std::string MetricPartitions::monthKey(int64_t ts) {
+    return keyFromIndex(monthIndex(ts));
+}
+
+std::string MetricPartitions::partitionPath(const std::string& month) const {
+    return (std::filesystem::path(options_.directory) / ("metrics_" + month + ".db")).string();
+}
+
+bool MetricPartitions::openCurrent(const std::string& month) {
+    closeCurrent();
+
+    std::string path = partitionPath(month);
+    if (sqlite3_open_v2(path.c_str(), &current_, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
+                        nullptr) != SQLITE_OK) {
+        std::cerr << "❌ Cannot open partition " << path << ": " << sqlite3_errmsg(current_) << std::endl;
+        sqlite3_close(current_);
+        current_ = nullptr;
+        return false;
+    }
+
+    sqlite3_busy_timeout(current_, 5000);
+    int rc = sqlite3_exec(current_, R"(
+        PRAGMA journal_mode = WAL;
+        PRAGMA synchronous = NORMAL;
+        CREATE TABLE IF NOT EXISTS points (
+            series TEXT NOT NULL,
+            ts INTEGER NOT NULL,
+            value REAL NOT NULL,
+            dimension TEXT NOT NULL DEFAULT ''
+        );
+        CREATE INDEX IF NOT EXISTS idx_points_series_ts ON points(series, ts);
+    )", nullptr, nullptr, nullptr);
+
+    if (rc != SQLITE_OK) {
+        std::cerr << "❌ Cannot prepare partition " << path << ": " << sqlite3_errmsg(current_) << std::endl;
+        sqlite3_close(current_);
+        current_ = nullptr;
+        return false;
+    }
+
+    statements_ = std::make_unique<StatementCache>(current_, 4);
+    statements_->setQueryStats(&db_->queryStats());
+    current_month_ = month;
+    return true;
+}
+
+void MetricPartitions::closeCurrent() {
+    statements_.reset();
+    if (current_) {
+        sqlite3_close(current_);
+        current_ = nullptr;
+    }
+    current_month_.clear();
+}
@@ -0,0 +1,88 @@
+// Metric partitions - month-partitioned time series with rollups
+#pragma once
+#include "statement_cache.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct sqlite3;
+class Database;
+
+struct MetricPoint {
+    int64_t ts;  // unix seconds, UTC
+    double value;
+    std::string dimension;
+};
+
+struct RollupBucket {
+    int64_t bucket;  // start of the hour/day/month, unix seconds UTC
+    int64_t count;
+    double sum;
+    double min;
+    double max;
+};
+
+/**
+ * Metric Partitions - raw points in one SQLite file per month
+ * Points land in <directory>/metrics_YYYY_MM.db and are rolled up into
+ * hourly, daily and monthly buckets in the main database (metric_rollups,
+ * maintained through the group-commit queue). Range queries open only the
+ * month files the range overlaps; trend queries read the rollups and never
+ * touch raw points, so they stay fast however much history accumulates.
+ *
+ * Each partition is its own connection rather than an ATTACHed schema -
+ * SQLite caps attachments at 10 per connection, which a multi-year range
+ * would exceed, and raw writes never take the main writer lock.
+ *
+ * Retention drops whole month files past raw_retention_months, and prunes
+ * hourly and daily rollups past their windows; monthly rollups are kept.
+ */
+class MetricPartitions {
+public:
+    struct Options {
+        std::string directory;
+        int raw_retention_months = 24;
+        int hourly_retention_days = 90;
+        int daily_retention_days = 3 * 365;
+    };
+
+    MetricPartitions(Database* db, const Options& options);
+    ~MetricPartitions();
+
+    MetricPartitions(const MetricPartitions&) = delete;
+    MetricPartitions& operator=(const MetricPartitions&) = delete;
+
+    bool record(const std::string& series, double value, const std::string& dimension = "",
+                std::chrono::system_clock::time_point at = std::chrono::system_clock::now());
+
+    // Raw points in [from, to], oldest first, read from the overlapping months only
+    std::vector<MetricPoint> range(const std::string& series,
+                                   std::chrono::system_clock::time_point from,
+                                   std::chrono::system_clock::time_point to);
+
+    // The `periods` consecutive buckets of a grain ("hour", "day", "month")
+    // ending with the latest recorded one, oldest first. Periods with no
+    // points are included with count 0 and zero sum/min/max, so a series
+    // can be read as evenly spaced.
+    std::vector<RollupBucket> trend(const std::string& series, const std::string& grain, int periods);
+
+    void applyRetention();
+
+    static std::string monthKey(int64_t ts);  // "YYYY_MM" in UTC
+
+private:
+    std::string partitionPath(const std::string& month) const;
+    bool openCurrent(const std::string& month);  // caller holds mutex_
+    void closeCurrent();
+
+    Database* db_;
+    Options options_;
+
+    std::mutex mutex_;  // guards the current month's writer connection
+    std::string current_month_;
+    sqlite3* current_ = nullptr;
+    std::unique_ptr<StatementCache> statements_;
+};
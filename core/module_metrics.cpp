@@ -0,0 +1,172 @@
+// Module metrics for Riley Corpbrain - trigger-maintained aggregates
+#include "module_metrics.h"
+#include "database.h"
+#include <cctype>
+#include <iostream>
+#include <set>
+
+namespace {
+
+std::string quote(const std::string& text) {
+    std::string quoted = "'";
+    for (char c : text) {
+        quoted += c;
+        if (c == '\'') {
+            quoted += '\'';
+        }
+    }
+    return quoted + "'";
+}
+
+// Replace every $. with prefix ("NEW.", "OLD." or "" for a plain SELECT)
+std::string bindRow(const std::string& expression, const std::string& prefix) {
+    std::string result;
+    for (size_t i = 0; i < expression.size(); i++) {
+        if (expression[i] == '$' && i + 1 < expression.size() && expression[i + 1] == '.') {
+            result += prefix;
+            i++;
+        } else {
+            result += expression[i];
+        }
+    }
+    return result;
+}
+
+std::set<std::string> referencedColumns(const std::string& expression) {
+    std::set<std::string> columns;
+    for (size_t i = 0; i + 1 < expression.size(); i++) {
+        if (expression[i] != '$' || expression[i + 1] != '.') {
+            continue;
+        }
+        size_t start = i + 2;
+        size_t end = start;
+        while (end < expression.size() &&
+               (std::isalnum(static_cast<unsigned char>(expression[end])) || expression[end] == '_')) {
+            end++;
+        }
+        columns.insert(expression.substr(start, end - start));
+    }
+    return columns;
+}
+
+std::set<std::string> tableColumns(Database* db, const std::string& table) {
+    std::set<std::string> columns;
+    PreparedStatement stmt = db->prepareRead("SELECT name FROM pragma_table_info(?1);");
+    if (stmt && stmt.bind(1, table)) {
+        Database::forEachRow(stmt, [&columns](const RowView& row) {
+            columns.emplace(row.getText(0));
+            return true;
+        });
+    }
+    return columns;
+}
+
+// SQL for the name a row's delta is filed under
+std::string metricName(const AggregateSpec& spec, const std::string& prefix) {
+    if (spec.bucket.empty()) {
+        return quote(spec.metric);
+    }
+    return quote(spec.metric + ":") + " || COALESCE(" + bindRow(spec.bucket, prefix) + ", 'none')";
+}
+
+std::string applyDelta(const std::string& module, const AggregateSpec& spec,
+                       const std::string& prefix, const std::string& sign) {
+    return "    INSERT INTO module_metrics (module, metric, value) VALUES (" + quote(module) + ", " +
+           metricName(spec, prefix) + ", " + sign + "COALESCE(" + bindRow(spec.expression, prefix) + ", 0))\n"
+           "        ON CONFLICT(module, metric) DO UPDATE SET value = value + excluded.value;\n";
+}
+
+} // namespace
+
+bool ModuleMetrics::install(Database* db, const std::string& module, const std::vector<AggregateSpec>& specs) {
+    if (!db->ensureSchema("metrics", R"(
+        CREATE TABLE IF NOT EXISTS module_metrics (
+            module TEXT NOT NULL,
+            metric TEXT NOT NULL,
+            value REAL NOT NULL DEFAULT 0,
+            PRIMARY KEY (module, metric)
+        ) WITHOUT ROWID;
+    )")) {
+        return false;
+    }
+
+    // Keep only aggregates the live tables can feed, grouped by table
+    std::map<std::string, std::vector<const AggregateSpec*>> byTable;
+    std::map<std::string, std::set<std::string>> columns;
+
+    for (const auto& spec : specs) {
+        if (!columns.count(spec.table)) {
+            columns[spec.table] = tableColumns(db, spec.table);
+        }
+
+        std::set<std::string> needed = referencedColumns(spec.expression + " " + spec.bucket);
+        bool available = !columns[spec.table].empty();
+        for (const auto& column : needed) {
+            available = available && columns[spec.table].count(column) > 0;
+        }
+
+        if (!available) {
+            std::cout << "⚠️ Metric " << module << "." << spec.metric << " skipped - "
+                      << spec.table << " lacks its columns" << std::endl;
+            continue;
+        }
+        byTable[spec.table].push_back(&spec);
+    }
+
+    std::string ddl;
+    for (const auto& [table, tableSpecs] : byTable) {
+        std::string trigger = "trg_metrics_" + module + "_" + table;
+
+        ddl += "DROP TRIGGER IF EXISTS " + trigger + "_insert;\n";
+        ddl += "DROP TRIGGER IF EXISTS " + trigger + "_update;\n";
+        ddl += "DROP TRIGGER IF EXISTS " + trigger + "_delete;\n";
+
+        ddl += "CREATE TRIGGER " + trigger + "_insert AFTER INSERT ON " + table + " BEGIN\n";
+        for (const AggregateSpec* spec : tableSpecs) {
+            ddl += applyDelta(module, *spec, "NEW.", "");
+        }
+        ddl += "END;\n";
+
+        // Take the old row out and put the new one in - also moves it between buckets
+        ddl += "CREATE TRIGGER " + trigger + "_update AFTER UPDATE ON " + table + " BEGIN\n";
+        for (const AggregateSpec* spec : tableSpecs) {
+            ddl += applyDelta(module, *spec, "OLD.", "-");
+            ddl += applyDelta(module, *spec, "NEW.", "");
+        }
+        ddl += "END;\n";
+
+        ddl += "CREATE TRIGGER " + trigger + "_delete AFTER DELETE ON " + table + " BEGIN\n";
+        for (const AggregateSpec* spec : tableSpecs) {
+            ddl += applyDelta(module, *spec, "OLD.", "-");
+        }
+        ddl += "END;\n";
+    }
+
+    // One-time backfill from the tables, in the same transaction as the triggers
+    ddl += "DELETE FROM module_metrics WHERE module = " + quote(module) + ";\n";
+    for (const auto& [table, tableSpecs] : byTable) {
+        for (const AggregateSpec* spec : tableSpecs) {
+            ddl += "INSERT INTO module_metrics (module, metric, value) SELECT " + quote(module) + ", " +
+                   metricName(*spec, "") + ", COALESCE(SUM(" + bindRow(spec->expression, "") + "), 0) FROM " +
+                   table + (spec->bucket.empty() ? "" : " GROUP BY 2") + ";\n";
+        }
+    }
+
+    return db->ensureSchema("metrics:" + module, ddl);
+}
+
+std::map<std::string, double> ModuleMetrics::read(Database* db, const std::string& module) {
+    std::map<std::string, double> values;
+
+    PreparedStatement stmt = db->prepareRead("SELECT metric, value FROM module_metrics WHERE module = ?1;");
+    if (!stmt || !stmt.bind(1, module)) {
+        return values;
+    }
+
+    Database::forEachRow(stmt, [&values](const RowView& row) {
+        values[std::string(row.getText(0))] = row.getDouble(1);
+        return true;
+    });
+
+    return values;
+}
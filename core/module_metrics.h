@@ -0,0 +1,35 @@
+// Module metrics - aggregates kept current by triggers
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+class Database;
+
+// One incrementally maintained aggregate: the running SUM of expression over
+// every row of table. Columns are written as $.column and become NEW./OLD.
+// inside the triggers. With a bucket expression the sum is kept per bucket
+// value, under the name "metric:bucket" (e.g. expenses per month).
+struct AggregateSpec {
+    std::string metric;
+    std::string table;
+    std::string expression;
+    std::string bucket;
+};
+
+/**
+ * Module Metrics - O(1) dashboard numbers
+ * Each module registers its aggregates once; INSERT, UPDATE and DELETE
+ * triggers then apply the row's delta to module_metrics, so a metrics getter
+ * reads a handful of rows instead of scanning its tables. Installing runs
+ * through the schema migrator: the triggers are rebuilt and the sums
+ * backfilled from the tables only when the generated DDL changes.
+ * Aggregates whose columns are missing from the live table are skipped.
+ */
+class ModuleMetrics {
+public:
+    static bool install(Database* db, const std::string& module, const std::vector<AggregateSpec>& specs);
+
+    // metric name -> value for one module
+    static std::map<std::string, double> read(Database* db, const std::string& module);
+};
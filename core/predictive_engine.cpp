@@ -276,8 +276,41 @@ double PredictiveEngine::calculateTrendStrength(const std::vector<double>& data)
 }
 
 std::vector<double> PredictiveEngine::getHistoricalData(const std::string& metric_name, int periods) {
-    // Simulate historical data - in real implementation, this would query the database
     std::vector<double> data;
+
+    // Monthly revenue from the analytics replica, oldest first
+    if (metric_name == "sales_revenue" && db_) {
+        PreparedStatement stmt = db_->prepareAnalytics(
+            "SELECT strftime('%Y-%m', close_date) AS period, SUM(amount) FROM sales_deals "
+            "WHERE close_date IS NOT NULL GROUP BY period ORDER BY period DESC LIMIT ?1;");
+        if (stmt && stmt.bind(1, periods)) {
+            Database::forEachRow(stmt, [&data](const RowView& row) {
+                data.push_back(row.getDouble(1));
+                return true;
+            });
+            std::reverse(data.begin(), data.end());
+        }
+
+        // Too little history to fit a model - fall back to the simulation
+        if (data.size() >= 3) {
+            return data;
+        }
+        data.clear();
+    }
+
+    // Recorded time series - monthly rollups, so years of raw points are never scanned
+    if (db_ && db_->metricPartitions()) {
+        for (const auto& bucket : db_->metricPartitions()->trend(metric_name, "month", periods)) {
+            data.push_back(bucket.sum);
+        }
+
+        if (data.size() >= 3) {
+            return data;
+        }
+        data.clear();
+    }
+
+    // Simulate historical data for metrics without recorded history
     std::random_device rd;
     std::mt19937 gen(rd());
     
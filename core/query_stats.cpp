@@ -0,0 +1,332 @@
+// Query statistics for Riley Corpbrain - where the database time goes
+#include "query_stats.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+// ---------------------------------------------------------------------------
+// StatementStats
+// ---------------------------------------------------------------------------
+
+double StatementStats::meanMs() const {
+    return calls == 0 ? 0.0 : static_cast<double>(total_us) / calls / 1000.0;
+}
+
+double StatementStats::percentileMs(double percentile) const {
+    if (calls == 0) {
+        return 0.0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(percentile * calls + 0.5);
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += histogram[i];
+        if (seen >= target) {
+            return static_cast<double>(uint64_t(1) << (i + 1)) / 1000.0;
+        }
+    }
+    return static_cast<double>(max_us) / 1000.0;
+}
+
+// ---------------------------------------------------------------------------
+// QueryStats
+// ---------------------------------------------------------------------------
+
+namespace {
+
+size_t bucketFor(uint64_t elapsed_us) {
+    size_t bucket = 0;
+    while (elapsed_us > 1 && bucket < StatementStats::BUCKETS - 1) {
+        elapsed_us >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+bool isIdentifierChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Plans are stored unindented; reports nest them under their statement
+void printPlan(std::ostream& out, const std::string& plan) {
+    std::istringstream lines(plan);
+    std::string line;
+    while (std::getline(lines, line)) {
+        out << "      " << line << std::endl;
+    }
+}
+
+// Digits after these belong to a parameter name (?1, :name2) not a literal
+bool continuesToken(char c) {
+    return isIdentifierChar(c) || c == '?' || c == ':' || c == '@' || c == '$';
+}
+
+} // namespace
+
+void QueryStats::record(sqlite3_stmt* stmt, std::chrono::nanoseconds elapsed, uint64_t rows, bool failed) {
+    const char* text = sqlite3_sql(stmt);
+    if (!text) {
+        return;
+    }
+
+    std::string sql(text);
+    uint64_t elapsed_us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    uint64_t fullscan_steps = static_cast<uint64_t>(
+        sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1));
+    uint64_t vm_steps = static_cast<uint64_t>(
+        sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1));
+
+    add(sql, elapsed_us, rows, fullscan_steps, vm_steps, failed);
+
+    if (elapsed_us >= static_cast<uint64_t>(slowThreshold().count()) * 1000) {
+        logSlow(sqlite3_db_handle(stmt), sql, elapsed_us);
+    }
+}
+
+void QueryStats::record(sqlite3* db, const std::string& sql, std::chrono::nanoseconds elapsed, bool failed) {
+    uint64_t elapsed_us = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    add(sql, elapsed_us, 0, 0, 0, failed);
+
+    if (elapsed_us >= static_cast<uint64_t>(slowThreshold().count()) * 1000) {
+        logSlow(db, sql, elapsed_us);
+    }
+}
+
+void QueryStats::add(const std::string& sql, uint64_t elapsed_us, uint64_t rows, uint64_t fullscan_steps,
+                     uint64_t vm_steps, bool failed) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const std::string& key = normalizedKey(sql);
+    StatementStats& stats = statements_[key];
+    if (stats.statement.empty()) {
+        stats.statement = key;
+    }
+
+    stats.calls++;
+    stats.total_us += elapsed_us;
+    stats.max_us = std::max(stats.max_us, elapsed_us);
+    stats.rows_returned += rows;
+    stats.fullscan_steps += fullscan_steps;
+    stats.vm_steps += vm_steps;
+    stats.histogram[bucketFor(elapsed_us)]++;
+    if (failed) {
+        stats.errors++;
+    }
+
+    total_calls_++;
+}
+
+// Plans are gathered outside the stats lock; the caller still owns the
+// connection, so running EXPLAIN on it is safe
+void QueryStats::logSlow(sqlite3* db, const std::string& sql, uint64_t elapsed_us) {
+    SlowQuery entry;
+    entry.sql = sql;
+    entry.elapsed_ms = static_cast<double>(elapsed_us) / 1000.0;
+    entry.plan = explainQueryPlan(db, sql);
+    entry.when = std::chrono::system_clock::now();
+
+    std::cerr << "🐢 Slow query (" << std::fixed << std::setprecision(1) << entry.elapsed_ms
+              << "ms): " << normalize(sql) << std::endl;
+    printPlan(std::cerr, entry.plan);
+    std::cerr.unsetf(std::ios::floatfield);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    slow_log_.push_back(std::move(entry));
+    if (slow_log_.size() > SLOW_LOG_CAPACITY) {
+        slow_log_.pop_front();
+    }
+}
+
+// Caller holds mutex_
+const std::string& QueryStats::normalizedKey(const std::string& sql) {
+    auto it = normalized_.find(sql);
+    if (it != normalized_.end()) {
+        return it->second;
+    }
+
+    // SQL with formatted-in values never repeats, so keep the memo bounded
+    if (normalized_.size() >= NORMALIZED_CACHE_LIMIT) {
+        normalized_.clear();
+    }
+    return normalized_.emplace(sql, normalize(sql)).first->second;
+}
+
+void QueryStats::setSlowThreshold(std::chrono::milliseconds threshold) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slow_threshold_ = threshold;
+}
+
+std::chrono::milliseconds QueryStats::slowThreshold() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(slow_threshold_);
+}
+
+std::vector<StatementStats> QueryStats::snapshot() const {
+    std::vector<StatementStats> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result.reserve(statements_.size());
+        for (const auto& [key, stats] : statements_) {
+            result.push_back(stats);
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const StatementStats& a, const StatementStats& b) {
+        return a.total_us > b.total_us;
+    });
+    return result;
+}
+
+std::vector<SlowQuery> QueryStats::slowQueries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<SlowQuery>(slow_log_.begin(), slow_log_.end());
+}
+
+uint64_t QueryStats::totalCalls() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_calls_;
+}
+
+void QueryStats::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statements_.clear();
+    slow_log_.clear();
+    total_calls_ = 0;
+}
+
+std::string QueryStats::summary() const {
+    std::vector<StatementStats> stats = snapshot();
+
+    uint64_t calls = 0;
+    uint64_t total_us = 0;
+    for (const auto& entry : stats) {
+        calls += entry.calls;
+        total_us += entry.total_us;
+    }
+
+    std::ostringstream out;
+    out << "🗄️ " << calls << " queries, " << std::fixed << std::setprecision(1)
+        << total_us / 1000.0 << "ms total, " << slowQueries().size() << " slow";
+    if (!stats.empty()) {
+        out << " | top: " << stats.front().statement.substr(0, 40);
+    }
+    return out.str();
+}
+
+void QueryStats::dump(std::ostream& out, size_t top) const {
+    std::vector<StatementStats> stats = snapshot();
+
+    out << "📊 QUERY STATISTICS (" << stats.size() << " statements)" << std::endl;
+    out << std::fixed << std::setprecision(2);
+
+    for (size_t i = 0; i < stats.size() && i < top; i++) {
+        const StatementStats& entry = stats[i];
+        out << "  " << std::setw(8) << entry.calls << " calls"
+            << "  total " << std::setw(9) << entry.total_us / 1000.0 << "ms"
+            << "  mean " << std::setw(7) << entry.meanMs() << "ms"
+            << "  p95 " << std::setw(7) << entry.percentileMs(0.95) << "ms"
+            << "  max " << std::setw(7) << entry.max_us / 1000.0 << "ms"
+            << "  rows " << entry.rows_returned
+            << "  full-scan steps " << entry.fullscan_steps
+            << "  vm steps " << entry.vm_steps;
+        if (entry.errors > 0) {
+            out << "  errors " << entry.errors;
+        }
+        out << std::endl << "      " << entry.statement << std::endl;
+    }
+
+    std::vector<SlowQuery> slow = slowQueries();
+    if (!slow.empty()) {
+        out << "🐢 SLOW QUERIES (over " << slowThreshold().count() << "ms)" << std::endl;
+        for (const auto& entry : slow) {
+            out << "  " << entry.elapsed_ms << "ms  " << normalize(entry.sql) << std::endl;
+            printPlan(out, entry.plan);
+        }
+    }
+
+    out.unsetf(std::ios::floatfield);
+}
+
+// Replace literals with ? and collapse whitespace
+std::string QueryStats::normalize(const std::string& sql) {
+    std::string result;
+    result.reserve(sql.size());
+
+    size_t i = 0;
+    while (i < sql.size()) {
+        char c = sql[i];
+
+        if (c == '\'') {
+            // String literal, '' is an escaped quote
+            i++;
+            while (i < sql.size()) {
+                if (sql[i] == '\'' && (i + 1 >= sql.size() || sql[i + 1] != '\'')) {
+                    break;
+                }
+                i += sql[i] == '\'' ? 2 : 1;
+            }
+            i++;
+            result += '?';
+        } else if (std::isdigit(static_cast<unsigned char>(c)) &&
+                   (result.empty() || !continuesToken(result.back()))) {
+            while (i < sql.size() && (isIdentifierChar(sql[i]) || sql[i] == '.')) {
+                i++;
+            }
+            result += '?';
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) {
+                i++;
+            }
+            if (!result.empty()) {
+                result += ' ';
+            }
+        } else {
+            result += c;
+            i++;
+        }
+    }
+
+    while (!result.empty() && (result.back() == ' ' || result.back() == ';')) {
+        result.pop_back();
+    }
+    return result;
+}
+
+// EXPLAIN QUERY PLAN as an indented tree, one line per plan step
+std::string QueryStats::explainQueryPlan(sqlite3* db, const std::string& sql) {
+    std::string explain = "EXPLAIN QUERY PLAN " + sql;
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db, explain.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        sqlite3_finalize(stmt);
+        return "";
+    }
+
+    std::map<int, int> depth;  // plan node id -> indentation level
+    std::ostringstream plan;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int id = sqlite3_column_int(stmt, 0);
+        int parent = sqlite3_column_int(stmt, 1);
+        const unsigned char* detail = sqlite3_column_text(stmt, 3);
+
+        auto it = depth.find(parent);
+        int level = it == depth.end() ? 0 : it->second + 1;
+        depth[id] = level;
+
+        plan << std::string(static_cast<size_t>(level) * 2, ' ')
+             << (detail ? reinterpret_cast<const char*>(detail) : "") << std::endl;
+    }
+
+    sqlite3_finalize(stmt);
+    return plan.str();
+}
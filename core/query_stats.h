@@ -0,0 +1,93 @@
+// Query statistics - per-statement latency histograms and slow-query log
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+/**
+ * Statement Stats - aggregated executions of one normalized statement
+ * Latencies go into log2 buckets: bucket i counts executions that took
+ * [2^i, 2^(i+1)) microseconds, bucket 0 also takes anything under 1us and
+ * the last bucket everything slower.
+ */
+struct StatementStats {
+    static constexpr size_t BUCKETS = 24;
+
+    std::string statement;       // normalized SQL
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t total_us = 0;
+    uint64_t max_us = 0;
+    uint64_t rows_returned = 0;
+    uint64_t fullscan_steps = 0; // rows stepped by full table scans (not index scans)
+    uint64_t vm_steps = 0;       // virtual machine steps - total work, indexed or not
+    std::array<uint64_t, BUCKETS> histogram{};
+
+    double meanMs() const;
+    double percentileMs(double percentile) const;  // upper bound of the bucket
+};
+
+struct SlowQuery {
+    std::string sql;
+    double elapsed_ms = 0.0;
+    std::string plan;  // EXPLAIN QUERY PLAN output
+    std::chrono::system_clock::time_point when;
+};
+
+/**
+ * Query Stats - shared by the writer and every pooled reader
+ * Literals are stripped from the SQL before aggregating, so statements that
+ * still format values into their text land in one entry per shape.
+ */
+class QueryStats {
+public:
+    QueryStats() = default;
+
+    QueryStats(const QueryStats&) = delete;
+    QueryStats& operator=(const QueryStats&) = delete;
+
+    // Called once per completed execution of a prepared statement
+    void record(sqlite3_stmt* stmt, std::chrono::nanoseconds elapsed, uint64_t rows, bool failed);
+    // Called for sqlite3_exec() scripts, which have no statement handle
+    void record(sqlite3* db, const std::string& sql, std::chrono::nanoseconds elapsed, bool failed);
+
+    void setSlowThreshold(std::chrono::milliseconds threshold);
+    std::chrono::milliseconds slowThreshold() const;
+
+    std::vector<StatementStats> snapshot() const;  // by total time, slowest first
+    std::vector<SlowQuery> slowQueries() const;    // most recent last
+    uint64_t totalCalls() const;
+    void reset();
+
+    std::string summary() const;  // one line for status displays
+    void dump(std::ostream& out, size_t top = 20) const;
+
+    static std::string normalize(const std::string& sql);
+    static std::string explainQueryPlan(sqlite3* db, const std::string& sql);
+
+private:
+    void add(const std::string& sql, uint64_t elapsed_us, uint64_t rows, uint64_t fullscan_steps,
+             uint64_t vm_steps, bool failed);
+    void logSlow(sqlite3* db, const std::string& sql, uint64_t elapsed_us);
+    const std::string& normalizedKey(const std::string& sql);
+
+    static constexpr size_t SLOW_LOG_CAPACITY = 100;
+    static constexpr size_t NORMALIZED_CACHE_LIMIT = 4096;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, StatementStats> statements_;
+    std::unordered_map<std::string, std::string> normalized_;  // raw SQL -> normalized
+    std::deque<SlowQuery> slow_log_;
+    uint64_t total_calls_ = 0;
+    std::chrono::microseconds slow_threshold_{100000};
+};
@@ -0,0 +1,170 @@
+// Records - typed rows for the core business tables
+#pragma once
+#include "typed_table.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+
+// Column sets follow the module DDL (CRMModule, SalesModule, ...); defaults
+// mirror the column defaults. created_at is left to the database. Tables
+// that data/schema.sql creates first in an older layout are brought up to
+// these columns by each module's ensureColumns() step at registration.
+
+struct ClientRecord {
+    int64_t id = 0;
+    std::string name;
+    std::string email;
+    std::optional<std::string> phone;
+    std::optional<std::string> company;
+    std::optional<std::string> industry;
+    double value_score = 0.0;
+    double churn_risk = 0.0;
+    std::string segment = "Standard";
+};
+
+template <>
+struct TableDescriptor<ClientRecord> {
+    static constexpr const char* table = "clients";
+    static constexpr const char* touch = "updated_at";
+    static constexpr auto columns = std::make_tuple(
+        column("name", &ClientRecord::name),
+        column("email", &ClientRecord::email),
+        column("phone", &ClientRecord::phone),
+        column("company", &ClientRecord::company),
+        column("industry", &ClientRecord::industry),
+        column("value_score", &ClientRecord::value_score),
+        column("churn_risk", &ClientRecord::churn_risk),
+        column("segment", &ClientRecord::segment));
+};
+
+struct DealRecord {
+    int64_t id = 0;
+    std::optional<int64_t> client_id;
+    std::string deal_name;
+    double amount = 0.0;
+    std::string stage = "Prospecting";
+    double probability = 0.1;
+    std::optional<std::string> expected_close_date;
+    std::optional<std::string> actual_close_date;
+    std::optional<std::string> sales_rep;
+};
+
+template <>
+struct TableDescriptor<DealRecord> {
+    static constexpr const char* table = "sales_deals";
+    static constexpr const char* touch = "updated_at";
+    static constexpr auto columns = std::make_tuple(
+        column("client_id", &DealRecord::client_id),
+        column("deal_name", &DealRecord::deal_name),
+        column("amount", &DealRecord::amount),
+        column("stage", &DealRecord::stage),
+        column("probability", &DealRecord::probability),
+        column("expected_close_date", &DealRecord::expected_close_date),
+        column("actual_close_date", &DealRecord::actual_close_date),
+        column("sales_rep", &DealRecord::sales_rep));
+};
+
+struct TicketRecord {
+    int64_t id = 0;
+    std::optional<int64_t> client_id;
+    std::string title;
+    std::optional<std::string> description;
+    std::string priority = "Medium";
+    std::string status = "Open";
+    std::optional<std::string> assigned_to;
+    std::optional<std::string> resolved_at;
+};
+
+template <>
+struct TableDescriptor<TicketRecord> {
+    static constexpr const char* table = "support_tickets";
+    static constexpr const char* touch = nullptr;
+    static constexpr auto columns = std::make_tuple(
+        column("client_id", &TicketRecord::client_id),
+        column("title", &TicketRecord::title),
+        column("description", &TicketRecord::description),
+        column("priority", &TicketRecord::priority),
+        column("status", &TicketRecord::status),
+        column("assigned_to", &TicketRecord::assigned_to),
+        column("resolved_at", &TicketRecord::resolved_at));
+};
+
+struct EmployeeRecord {
+    int64_t id = 0;
+    std::string name;
+    std::string email;
+    std::optional<std::string> department;
+    std::optional<std::string> position;
+    std::optional<double> salary;
+    std::optional<std::string> hire_date;  // empty = today, in SQLite's calendar
+    std::string status = "Active";
+};
+
+template <>
+struct TableDescriptor<EmployeeRecord> {
+    static constexpr const char* table = "employees";
+    static constexpr const char* touch = nullptr;
+    static constexpr auto columns = std::make_tuple(
+        column("name", &EmployeeRecord::name),
+        column("email", &EmployeeRecord::email),
+        column("department", &EmployeeRecord::department),
+        column("position", &EmployeeRecord::position),
+        column("salary", &EmployeeRecord::salary),
+        column("hire_date", &EmployeeRecord::hire_date, "DATE('now')"),
+        column("status", &EmployeeRecord::status));
+};
+
+struct ProjectRecord {
+    int64_t id = 0;
+    std::string name;
+    std::optional<std::string> description;
+    std::optional<int64_t> client_id;
+    std::string status = "Planning";
+    std::optional<std::string> start_date;
+    std::optional<std::string> end_date;
+    std::optional<double> budget;
+    double progress = 0.0;
+    std::optional<std::string> project_manager;
+};
+
+template <>
+struct TableDescriptor<ProjectRecord> {
+    static constexpr const char* table = "projects";
+    static constexpr const char* touch = nullptr;
+    static constexpr auto columns = std::make_tuple(
+        column("name", &ProjectRecord::name),
+        column("description", &ProjectRecord::description),
+        column("client_id", &ProjectRecord::client_id),
+        column("status", &ProjectRecord::status),
+        column("start_date", &ProjectRecord::start_date),
+        column("end_date", &ProjectRecord::end_date),
+        column("budget", &ProjectRecord::budget),
+        column("progress", &ProjectRecord::progress),
+        column("project_manager", &ProjectRecord::project_manager));
+};
+
+struct InventoryRecord {
+    int64_t id = 0;
+    std::string item_name;
+    std::optional<std::string> sku;  // UNIQUE - leave empty rather than ""
+    int64_t quantity = 0;
+    std::optional<double> unit_price;
+    std::optional<std::string> category;
+    std::optional<std::string> supplier;
+    int64_t reorder_level = 10;
+};
+
+template <>
+struct TableDescriptor<InventoryRecord> {
+    static constexpr const char* table = "inventory";
+    static constexpr const char* touch = nullptr;
+    static constexpr auto columns = std::make_tuple(
+        column("item_name", &InventoryRecord::item_name),
+        column("sku", &InventoryRecord::sku),
+        column("quantity", &InventoryRecord::quantity),
+        column("unit_price", &InventoryRecord::unit_price),
+        column("category", &InventoryRecord::category),
+        column("supplier", &InventoryRecord::supplier),
+        column("reorder_level", &InventoryRecord::reorder_level));
+};
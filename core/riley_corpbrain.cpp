@@ -3,6 +3,8 @@
 #include "riley_corpbrain.h"
 #include "schema_model.h"
 #include "database.h"
+#include "index_advisor.h"
+#include "shard_router.h"
 #include "python_embed.h"
 #include "CRMModule.h"
 #include "SalesModule.h"
@@ -25,6 +27,7 @@ RileyCorpBrain::RileyCorpBrain() : initialized(false) {
     try {
         // Initialize core systems
         db = new Database();
+        db->enableMetricPartitions();
         schema = new SchemaModel(db);
         ai = new PythonEmbed();
 
@@ -62,11 +65,22 @@ RileyCorpBrain::~RileyCorpBrain() {
     // Clean up core systems
     delete ai;
     delete schema;
+    delete shards;
     delete db;
 
     std::cout << "✅ Shutdown complete" << std::endl;
 }
 
+ShardRouter* RileyCorpBrain::getShards() {
+    std::call_once(shards_once, [this] { shards = new ShardRouter(); });
+    return shards;
+}
+
+// Ranked full-text search over one of the registered indexes
+std::vector<SearchHit> RileyCorpBrain::searchText(const std::string& index, const std::string& text, int limit) {
+    return TextSearch::search(db, index, text, limit);
+}
+
 // Initialize all modules and establish cross-module intelligence
 void RileyCorpBrain::initializeModules() {
     if (initialized) {
@@ -92,6 +106,16 @@ void RileyCorpBrain::initializeModules() {
             throw std::runtime_error("Failed to enable foreign keys");
         }
 
+        // Index the foreign keys the module schemas declare without one
+        IndexAdvisor advisor(db);
+        auto foreignKeyIndexes = advisor.adviseForeignKeys();
+        if (!foreignKeyIndexes.empty()) {
+            IndexAdvisor::printReport(foreignKeyIndexes, std::cout);
+        }
+
+        // Copy for analytics only once every module's tables are in place
+        db->enableSnapshotReplica();
+
         initialized = true;
         std::cout << "✅ All modules initialized successfully" << std::endl;
 
@@ -183,6 +207,14 @@ void RileyCorpBrain::handleUIAction(const std::string& action, const QVariantMap
         else if (action == "run_analytics") {
             runAIAnalytics();
         }
+        else if (action == "rescore_churn") {
+            crm->rescoreChurnRisk();
+        }
+        else if (action == "optimize_indexes") {
+            // Index the full scans recorded in the query workload so far
+            IndexAdvisor advisor(db);
+            IndexAdvisor::printReport(advisor.adviseWorkload(), std::cout);
+        }
         else {
             std::cerr << "⚠️ Unknown action: " << action << std::endl;
         }
@@ -2,6 +2,9 @@
 #pragma once
 #include <string>
 #include <map>
+#include <mutex>
+#include <vector>
+#include "text_search.h"
 // Forward declaration for Qt type
 class QVariantMap;
 class CRMModule;
@@ -13,6 +16,7 @@ class HRModule;
 class InventoryModule;
 class ComplianceModule;
 class Database;
+class ShardRouter;
 class SchemaModel;
 class PythonEmbed;
 class RileyCorpBrain {
@@ -22,8 +26,16 @@ public:
     void initializeModules();
     void runAIAnalytics();
     void handleUIAction(const std::string& action, const QVariantMap& params);
+    Database* getDatabase() const { return db; }
+    // Per-company databases for subsidiaries; the main database stays the default.
+    // Created on first use, so nothing touches the shard directory until then.
+    ShardRouter* getShards();
+    // Ranked full-text search: "tickets", "interactions" or "memories"
+    std::vector<SearchHit> searchText(const std::string& index, const std::string& text, int limit = 20);
 private:
     Database* db;
+    ShardRouter* shards = nullptr;
+    std::once_flag shards_once;
     SchemaModel* schema;
     PythonEmbed* ai;
     CRMModule* crm;
@@ -0,0 +1,156 @@
+// Row cache for Riley Corpbrain - hook-invalidated point lookups
+#include "row_cache.h"
+#include <sqlite3.h>
+#include <algorithm>
+
+namespace {
+// Same threshold SQLite's own auto-checkpoint uses; installing a WAL hook
+// replaces that hook, so the cache checkpoints in its place
+constexpr int kAutoCheckpointPages = 1000;
+}
+
+RowCache::RowCache(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {}
+
+void RowCache::attach(sqlite3* writer) {
+    sqlite3_update_hook(writer, &RowCache::onUpdate, this);
+    sqlite3_commit_hook(writer, &RowCache::onCommit, this);
+    sqlite3_rollback_hook(writer, &RowCache::onRollback, this);
+    sqlite3_wal_hook(writer, &RowCache::onWal, this);
+}
+
+void RowCache::watch(const std::string& table) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    watched_.insert(table);
+}
+
+bool RowCache::watches(const std::string& table) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return watched_.count(table) > 0;
+}
+
+bool RowCache::lookup(const std::string& table, int64_t rowid, Row& row) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(Key(table, rowid));
+    if (it == index_.end()) {
+        misses_++;
+        return false;
+    }
+
+    entries_.splice(entries_.begin(), entries_, it->second);
+    row = it->second->second;
+    hits_++;
+    return true;
+}
+
+void RowCache::store(const std::string& table, int64_t rowid, Row row, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // A commit landed while the row was being read - it may be stale
+    if (generation != generation_.load()) {
+        return;
+    }
+
+    Key key(table, rowid);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->second = std::move(row);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    entries_.emplace_front(key, std::move(row));
+    index_[key] = entries_.begin();
+
+    if (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+}
+
+void RowCache::invalidateTable(const std::string& table) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->first.first == table) {
+            index_.erase(it->first);
+            it = entries_.erase(it);
+            invalidations_++;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void RowCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+    entries_.clear();
+    index_.clear();
+}
+
+size_t RowCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void RowCache::evict(const std::vector<Key>& keys) {
+    generation_++;
+
+    for (const auto& key : keys) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            entries_.erase(it->second);
+            index_.erase(it);
+            invalidations_++;
+        }
+    }
+}
+
+// Hooks - called by SQLite on the thread that holds the writer
+
+void RowCache::onUpdate(void* self, int, const char* database, const char* table, long long rowid) {
+    auto* cache = static_cast<RowCache*>(self);
+    if (std::string(database) != "main") {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(cache->mutex_);
+    if (cache->watched_.count(table)) {
+        cache->pending_.emplace_back(table, rowid);
+    }
+}
+
+int RowCache::onCommit(void* self) {
+    auto* cache = static_cast<RowCache*>(self);
+
+    // Evict now for this connection's own readers, and again from the WAL
+    // hook for readers that loaded the old row before the commit was visible.
+    // Without WAL the commit is visible to everyone once it returns.
+    std::lock_guard<std::mutex> lock(cache->mutex_);
+    cache->committed_ = std::move(cache->pending_);
+    cache->pending_.clear();
+    cache->evict(cache->committed_);
+    return 0;  // never veto the commit
+}
+
+void RowCache::onRollback(void* self) {
+    auto* cache = static_cast<RowCache*>(self);
+    std::lock_guard<std::mutex> lock(cache->mutex_);
+    cache->pending_.clear();
+}
+
+int RowCache::onWal(void* self, sqlite3* db, const char* database, int pages) {
+    auto* cache = static_cast<RowCache*>(self);
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex_);
+        cache->evict(cache->committed_);
+        cache->committed_.clear();
+    }
+
+    if (pages >= kAutoCheckpointPages) {
+        sqlite3_wal_checkpoint_v2(db, database, SQLITE_CHECKPOINT_PASSIVE, nullptr, nullptr);
+    }
+    return SQLITE_OK;
+}
@@ -0,0 +1,98 @@
+// Row cache - point lookups on hot tables served from memory
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+struct sqlite3;
+
+/**
+ * Row Cache - LRU of whole rows keyed by (table, rowid)
+ * Only watched tables are cached. Invalidation is driven by the writer
+ * connection's hooks rather than by timeouts: sqlite3_update_hook records
+ * every rowid a statement touches, and those rows are evicted once the
+ * transaction commits (again after the WAL append, when other connections
+ * can see it). Rolled-back changes evict nothing.
+ *
+ * A reader that misses loads from disk and stores the row only if no commit
+ * invalidated anything in between (generation check), so a row read just
+ * before a commit can never be cached after it.
+ *
+ * The hooks only see writes made through this process's writer connection.
+ * SQLite also skips the update hook for rows removed by REPLACE conflict
+ * resolution on another UNIQUE column, and for the truncate optimization
+ * (DELETE without WHERE on a table without triggers); call invalidateTable()
+ * after such statements.
+ */
+class RowCache {
+public:
+    using Row = std::map<std::string, std::string>;
+
+    explicit RowCache(size_t capacity = 4096);
+
+    RowCache(const RowCache&) = delete;
+    RowCache& operator=(const RowCache&) = delete;
+
+    // Install the update/commit/rollback/WAL hooks on the writer connection
+    void attach(sqlite3* writer);
+
+    void watch(const std::string& table);
+    bool watches(const std::string& table) const;
+
+    // A hit copies the row out and counts; a miss only counts
+    bool lookup(const std::string& table, int64_t rowid, Row& row);
+
+    // Take the generation before reading from disk and pass it to store()
+    uint64_t generation() const { return generation_.load(); }
+    void store(const std::string& table, int64_t rowid, Row row, uint64_t generation);
+
+    void invalidateTable(const std::string& table);
+    void clear();
+
+    size_t size() const;
+    uint64_t hits() const { return hits_.load(); }
+    uint64_t misses() const { return misses_.load(); }
+    uint64_t invalidations() const { return invalidations_.load(); }
+
+private:
+    using Key = std::pair<std::string, int64_t>;
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<std::string>()(key.first) ^ (std::hash<int64_t>()(key.second) * 31);
+        }
+    };
+
+    using Entries = std::list<std::pair<Key, Row>>;
+
+    void evict(const std::vector<Key>& keys);  // caller holds mutex_
+
+    static void onUpdate(void* self, int op, const char* database, const char* table, long long rowid);  // sqlite3_int64
+    static int onCommit(void* self);
+    static void onRollback(void* self);
+    static int onWal(void* self, sqlite3* db, const char* database, int pages);
+
+    size_t capacity_;
+    mutable std::mutex mutex_;
+    Entries entries_;  // most recently used first
+    std::unordered_map<Key, Entries::iterator, KeyHash> index_;
+    std::set<std::string> watched_;
+
+    // Touched by the open transaction, and by the last commit until its WAL
+    // append - only ever used from the thread holding the writer
+    std::vector<Key> pending_;
+    std::vector<Key> committed_;
+
+    std::atomic<uint64_t> generation_{0};
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> invalidations_{0};
+};
@@ -0,0 +1,76 @@
+// Row cursor for Riley Corpbrain - streams rows straight off sqlite3_step
+#include "row_cursor.h"
+#include <utility>
+
+// ---------------------------------------------------------------------------
+// RowView
+// ---------------------------------------------------------------------------
+
+int RowView::columnIndex(std::string_view name) const {
+    int count = stmt_->columnCount();
+    for (int i = 0; i < count; i++) {
+        const char* column = stmt_->columnName(i);
+        if (column && name == column) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool RowView::isNull(std::string_view name) const {
+    int column = columnIndex(name);
+    return column < 0 || stmt_->isNull(column);
+}
+
+int64_t RowView::getInt64(std::string_view name, int64_t fallback) const {
+    int column = columnIndex(name);
+    return column < 0 || stmt_->isNull(column) ? fallback : stmt_->getInt64(column);
+}
+
+double RowView::getDouble(std::string_view name, double fallback) const {
+    int column = columnIndex(name);
+    return column < 0 || stmt_->isNull(column) ? fallback : stmt_->getDouble(column);
+}
+
+std::string_view RowView::getText(std::string_view name) const {
+    int column = columnIndex(name);
+    return column < 0 ? std::string_view() : stmt_->getText(column);
+}
+
+// ---------------------------------------------------------------------------
+// RowCursor
+// ---------------------------------------------------------------------------
+
+RowCursor::RowCursor(PreparedStatement stmt)
+    : stmt_(std::move(stmt)), row_(&stmt_) {}
+
+RowCursor::RowCursor(RowCursor&& other) noexcept
+    : stmt_(std::move(other.stmt_)), row_(&stmt_), rows_read_(other.rows_read_),
+      finished_(other.finished_) {
+    other.rows_read_ = 0;
+    other.finished_ = true;
+}
+
+RowCursor& RowCursor::operator=(RowCursor&& other) noexcept {
+    if (this != &other) {
+        stmt_ = std::move(other.stmt_);
+        rows_read_ = other.rows_read_;
+        finished_ = other.finished_;
+        other.rows_read_ = 0;
+        other.finished_ = true;
+    }
+    return *this;
+}
+
+bool RowCursor::next() {
+    // SQLite restarts a statement stepped past SQLITE_DONE, so stop here
+    if (finished_ || !stmt_.valid()) {
+        return false;
+    }
+    if (!stmt_.step()) {
+        finished_ = true;
+        return false;
+    }
+    rows_read_++;
+    return true;
+}
@@ -0,0 +1,75 @@
+// Row cursor - forward-only, zero-copy access to query results
+#pragma once
+#include "statement_cache.h"
+#include <cstdint>
+#include <string_view>
+
+/**
+ * RowView - view of the row a statement is currently positioned on
+ * Text and blob views point into SQLite's own buffers and are only valid
+ * until the cursor advances; copy them if they must outlive the row.
+ */
+class RowView {
+public:
+    explicit RowView(const PreparedStatement* stmt) : stmt_(stmt) {}
+
+    int columnCount() const { return stmt_->columnCount(); }
+    const char* columnName(int column) const { return stmt_->columnName(column); }
+    int columnIndex(std::string_view name) const;  // -1 when no such column
+
+    // Access by position
+    SqlType columnType(int column) const { return stmt_->columnType(column); }
+    bool isNull(int column) const { return stmt_->isNull(column); }
+    int64_t getInt64(int column) const { return stmt_->getInt64(column); }
+    double getDouble(int column) const { return stmt_->getDouble(column); }
+    std::string_view getText(int column) const { return stmt_->getText(column); }
+    std::string_view getBlob(int column) const { return stmt_->getBlob(column); }
+
+    // Access by name - resolve the index once outside hot loops instead
+    bool isNull(std::string_view name) const;
+    int64_t getInt64(std::string_view name, int64_t fallback = 0) const;
+    double getDouble(std::string_view name, double fallback = 0.0) const;
+    std::string_view getText(std::string_view name) const;
+
+private:
+    const PreparedStatement* stmt_;
+};
+
+/**
+ * RowCursor - steps a prepared statement one row at a time
+ * Memory use is independent of the result size: nothing is materialized,
+ * and the statement returns to its cache when the cursor is destroyed.
+ *
+ *     RowCursor cursor = db->openCursor("SELECT id, name FROM clients");
+ *     while (cursor.next()) {
+ *         const RowView& row = cursor.row();
+ *         ...
+ *     }
+ */
+class RowCursor {
+public:
+    RowCursor() : row_(&stmt_) {}
+    explicit RowCursor(PreparedStatement stmt);
+    RowCursor(RowCursor&& other) noexcept;
+    RowCursor& operator=(RowCursor&& other) noexcept;
+    RowCursor(const RowCursor&) = delete;
+    RowCursor& operator=(const RowCursor&) = delete;
+
+    bool valid() const { return stmt_.valid(); }
+    explicit operator bool() const { return valid(); }
+
+    // Bind parameters through the statement before the first next()
+    PreparedStatement& statement() { return stmt_; }
+
+    bool next();
+    const RowView& row() const { return row_; }
+
+    int64_t rowsRead() const { return rows_read_; }
+    bool failed() const { return stmt_.failed(); }
+
+private:
+    PreparedStatement stmt_;
+    RowView row_;
+    int64_t rows_read_ = 0;
+    bool finished_ = false;
+};
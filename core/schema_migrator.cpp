@@ -0,0 +1,133 @@
+// Schema migrator for Riley Corpbrain - fingerprint-based fast startup
+#include "schema_migrator.h"
+#include "database.h"
+#include <cstdio>
+#include <iostream>
+#include <set>
+
+SchemaMigrator::SchemaMigrator(Database* db) : db_(db) {}
+
+std::string SchemaMigrator::fingerprint(const std::string& ddl) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : ddl) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    return hex;
+}
+
+void SchemaMigrator::loadFingerprints() {
+    loaded_ = true;
+
+    // Look the table up first so a fresh database does not log a prepare error
+    bool exists = false;
+    db_->forEachRow("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'schema_migrations';",
+                    [&exists](const RowView&) {
+                        exists = true;
+                        return false;
+                    });
+
+    if (!exists) {
+        db_->execute(R"(
+            CREATE TABLE IF NOT EXISTS schema_migrations (
+                component TEXT PRIMARY KEY,
+                fingerprint TEXT NOT NULL,
+                applied_at TEXT DEFAULT CURRENT_TIMESTAMP
+            );
+        )");
+        return;
+    }
+
+    db_->forEachRow("SELECT component, fingerprint FROM schema_migrations;", [this](const RowView& row) {
+        fingerprints_[std::string(row.getText(0))] = std::string(row.getText(1));
+        return true;
+    });
+}
+
+bool SchemaMigrator::ensure(const std::string& component, const std::string& ddl) {
+    if (!loaded_) {
+        loadFingerprints();
+    }
+
+    std::string current = fingerprint(ddl);
+
+    auto it = fingerprints_.find(component);
+    if (it != fingerprints_.end() && it->second == current) {
+        skipped_++;
+        return true;
+    }
+
+    std::cout << "🔧 Applying schema for " << component << " (" << current << ")" << std::endl;
+
+    if (!db_->beginTransaction()) {
+        return false;
+    }
+
+    bool ok = db_->execute(ddl);
+    if (ok) {
+        PreparedStatement record = db_->prepare(
+            "INSERT OR REPLACE INTO schema_migrations (component, fingerprint, applied_at) "
+            "VALUES (?1, ?2, CURRENT_TIMESTAMP);");
+        ok = record && record.bind(1, component) && record.bind(2, current) && record.execute();
+    }
+
+    if (!ok || !db_->commitTransaction()) {
+        db_->rollbackTransaction();
+        std::cerr << "❌ Schema migration failed for " << component << std::endl;
+        return false;
+    }
+
+    fingerprints_[component] = current;
+    applied_++;
+    return true;
+}
+
+bool SchemaMigrator::ensureColumns(const std::string& table, const std::vector<ColumnSpec>& columns) {
+    std::set<std::string> existing;
+    PreparedStatement info = db_->prepareRead("SELECT name FROM pragma_table_info(?1);");
+    if (!info || !info.bind(1, table)) {
+        return false;
+    }
+    Database::forEachRow(info, [&existing](const RowView& row) {
+        existing.emplace(row.getText(0));
+        return true;
+    });
+    if (existing.empty()) {
+        return false;  // no such table
+    }
+
+    std::vector<const ColumnSpec*> missing;
+    for (const auto& column : columns) {
+        if (!existing.count(column.name)) {
+            missing.push_back(&column);
+        }
+    }
+    if (missing.empty()) {
+        return true;
+    }
+
+    std::cout << "🔧 Adding " << missing.size() << " column(s) to " << table << std::endl;
+
+    if (!db_->beginTransaction()) {
+        return false;
+    }
+
+    bool ok = true;
+    for (const ColumnSpec* column : missing) {
+        ok = ok && db_->execute("ALTER TABLE " + table + " ADD COLUMN " + column->name + " " + column->declaration + ";");
+        if (ok && !column->legacy.empty() && existing.count(column->legacy)) {
+            ok = db_->execute("UPDATE " + table + " SET " + column->name + " = " + column->legacy + ";");
+        }
+    }
+
+    if (!ok || !db_->commitTransaction()) {
+        db_->rollbackTransaction();
+        std::cerr << "❌ Column upgrade failed for " << table << std::endl;
+        return false;
+    }
+    columns_added_ += missing.size();
+    return true;
+}
@@ -0,0 +1,56 @@
+// Schema migrator - skips DDL that has already been applied
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class Database;
+
+/**
+ * Schema Migrator - fingerprint-tracked DDL per component
+ * Each component (core schema, enterprise tables, each business module)
+ * hands over its DDL; a 64-bit FNV-1a fingerprint of the text is compared
+ * with the one stored in schema_migrations. Unchanged DDL is skipped, so a
+ * warm start costs one SELECT instead of re-running every CREATE statement.
+ * Changed DDL is applied and its fingerprint recorded in one transaction.
+ * The DDL must stay idempotent (IF NOT EXISTS) because a changed component
+ * is re-applied as a whole.
+ *
+ * A table that already existed in an older layout (data/schema.sql creates
+ * some business tables before their modules do) is left alone by CREATE
+ * TABLE IF NOT EXISTS; ensureColumns() adds the columns it is missing.
+ */
+struct ColumnSpec {
+    std::string name;
+    std::string declaration;  // type and constant default, as ALTER TABLE accepts
+    std::string legacy = "";  // older column whose values are copied in when added
+};
+
+class SchemaMigrator {
+public:
+    explicit SchemaMigrator(Database* db);
+
+    // Applies ddl unless the component's fingerprint is unchanged
+    bool ensure(const std::string& component, const std::string& ddl);
+
+    // Adds the columns table lacks, in one transaction; true if none are missing
+    bool ensureColumns(const std::string& table, const std::vector<ColumnSpec>& columns);
+
+    static std::string fingerprint(const std::string& ddl);
+
+    size_t appliedCount() const { return applied_; }
+    size_t skippedCount() const { return skipped_; }
+    size_t columnsAddedCount() const { return columns_added_; }
+
+private:
+    void loadFingerprints();
+
+    Database* db_;
+    bool loaded_ = false;
+    std::map<std::string, std::string> fingerprints_;  // component -> fingerprint
+    size_t applied_ = 0;
+    size_t skipped_ = 0;
+    size_t columns_added_ = 0;
+};
@@ -1,23 +1,49 @@
 // Data model logic for Riley Corpbrain
 #include "schema_model.h"
-// ...implement ORM-like logic for each table in schema.sql...
+#include "database.h"
+#include <iostream>
 
-#include <vector>
-#include <string>
-#include <map>
+SchemaModel::SchemaModel(Database* db) : db_(db) {}
 
-class SchemaModel {
-public:
-    SchemaModel(Database* db) : db_(db) {}
+// Aggregates for AI - read from the analytics replica so they never hold
+// a read transaction on the live file
+std::map<std::string, double> SchemaModel::getSalesData() {
+    std::map<std::string, double> salesData;
 
-    std::map<std::string, double> getSalesData() {
-        // Query sales_deals table and aggregate data for AI
-        std::map<std::string, double> salesData;
-        // ...fetch from db_ and fill salesData...
-        salesData["amount"] = 120000.0; // Example stub
+    PreparedStatement stmt = db_->prepareAnalytics(
+        "SELECT COUNT(*), COALESCE(SUM(amount), 0), COALESCE(AVG(amount), 0), "
+        "COALESCE(SUM(stage = 'Closed Won'), 0) FROM sales_deals;");
+    if (!stmt) {
         return salesData;
     }
-    // Add more methods for clients, projects, employees, etc.
-private:
-    Database* db_;
-};
+
+    Database::forEachRow(stmt, [&salesData](const RowView& row) {
+        salesData["deal_count"] = row.getDouble(0);
+        salesData["amount"] = row.getDouble(1);
+        salesData["average_amount"] = row.getDouble(2);
+        salesData["won_count"] = row.getDouble(3);
+        return false;
+    });
+
+    return salesData;
+}
+
+std::map<std::string, double> SchemaModel::getClientData() {
+    std::map<std::string, double> clientData;
+
+    PreparedStatement stmt = db_->prepareAnalytics(
+        "SELECT COUNT(*), COUNT(DISTINCT industry), "
+        "(SELECT COUNT(*) FROM client_interactions) FROM clients;");
+    if (!stmt) {
+        return clientData;
+    }
+
+    Database::forEachRow(stmt, [&clientData](const RowView& row) {
+        clientData["client_count"] = row.getDouble(0);
+        clientData["industry_count"] = row.getDouble(1);
+        clientData["interaction_count"] = row.getDouble(2);
+        return false;
+    });
+
+    return clientData;
+}
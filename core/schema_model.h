@@ -6,6 +6,7 @@ class Database;
 class SchemaModel {
 public:
     SchemaModel(Database* db);
+    Database* getDatabase() const { return db_; }
     std::map<std::string, double> getSalesData();
     std::map<std::string, double> getClientData();
 private:
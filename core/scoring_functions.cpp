@@ -0,0 +1,90 @@
+// Scoring functions for Riley Corpbrain - churn model as SQLite UDFs
+#include "scoring_functions.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+std::optional<double> argument(sqlite3_value* value) {
+    if (sqlite3_value_type(value) == SQLITE_NULL) {
+        return std::nullopt;
+    }
+    return sqlite3_value_double(value);
+}
+
+ChurnFactors factorsFrom(sqlite3_value** argv) {
+    ChurnFactors factors;
+    factors.last_interaction_days = argument(argv[0]);
+    factors.support_tickets = argument(argv[1]);
+    factors.engagement_score = argument(argv[2]);
+    factors.payment_delays = argument(argv[3]);
+    return factors;
+}
+
+void churnScalar(sqlite3_context* context, int, sqlite3_value** argv) {
+    sqlite3_result_double(context, ScoringFunctions::churnRisk(factorsFrom(argv)));
+}
+
+struct ChurnAverage {
+    double sum;
+    sqlite3_int64 count;
+};
+
+void churnAverageStep(sqlite3_context* context, int, sqlite3_value** argv) {
+    auto* average = static_cast<ChurnAverage*>(sqlite3_aggregate_context(context, sizeof(ChurnAverage)));
+    if (!average) {
+        sqlite3_result_error_nomem(context);
+        return;
+    }
+    average->sum += ScoringFunctions::churnRisk(factorsFrom(argv));
+    average->count++;
+}
+
+void churnAverageFinal(sqlite3_context* context) {
+    // Zero-filled on first use, and never allocated when no row was stepped
+    auto* average = static_cast<ChurnAverage*>(sqlite3_aggregate_context(context, 0));
+    if (!average || average->count == 0) {
+        sqlite3_result_null(context);
+        return;
+    }
+    sqlite3_result_double(context, average->sum / static_cast<double>(average->count));
+}
+
+} // namespace
+
+double ScoringFunctions::churnRisk(const ChurnFactors& factors) {
+    double risk_score = 0.0;
+
+    if (factors.last_interaction_days) {
+        risk_score += std::min(*factors.last_interaction_days / 60.0, 1.0) * 0.3; // 30% weight
+    }
+    if (factors.support_tickets) {
+        risk_score += std::min(*factors.support_tickets / 5.0, 1.0) * 0.2; // 20% weight
+    }
+    if (factors.engagement_score) {
+        risk_score += (1.0 - *factors.engagement_score) * 0.4; // 40% weight
+    }
+    if (factors.payment_delays) {
+        risk_score += std::min(*factors.payment_delays / 3.0, 1.0) * 0.1; // 10% weight
+    }
+
+    return std::min(risk_score, 1.0);
+}
+
+bool ScoringFunctions::registerWith(sqlite3* db) {
+    const int flags = SQLITE_UTF8 | SQLITE_DETERMINISTIC | SQLITE_INNOCUOUS;
+
+    int rc = sqlite3_create_function_v2(db, "riley_churn", 4, flags, nullptr,
+                                        churnScalar, nullptr, nullptr, nullptr);
+    if (rc == SQLITE_OK) {
+        rc = sqlite3_create_function_v2(db, "riley_churn_avg", 4, flags, nullptr,
+                                        nullptr, churnAverageStep, churnAverageFinal, nullptr);
+    }
+
+    if (rc != SQLITE_OK) {
+        std::cerr << "❌ Cannot register scoring functions: " << sqlite3_errmsg(db) << std::endl;
+        return false;
+    }
+    return true;
+}
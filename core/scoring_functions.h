@@ -0,0 +1,35 @@
+// Scoring functions - churn scoring shared by C++ and SQL
+#pragma once
+#include <optional>
+
+struct sqlite3;
+
+// Inputs to the churn model; a missing factor contributes nothing
+struct ChurnFactors {
+    std::optional<double> last_interaction_days;
+    std::optional<double> support_tickets;
+    std::optional<double> engagement_score;  // 0..1
+    std::optional<double> payment_delays;
+};
+
+/**
+ * Scoring Functions - the same C++ model callable from SQL
+ * Registered on every connection (writer, pooled readers, replica), so a
+ * whole table is rescored in one set-based statement instead of pulling
+ * rows out one at a time:
+ *
+ *     UPDATE clients SET churn_risk = riley_churn(days, tickets, engagement, delays);
+ *     SELECT segment, riley_churn_avg(days, tickets, engagement, delays) FROM ... GROUP BY segment;
+ *
+ * riley_churn(days, tickets, engagement, delays)      scalar, 0..1
+ * riley_churn_avg(days, tickets, engagement, delays)  aggregate mean, NULL over no rows
+ *
+ * Arguments may be NULL for unknown factors. Both functions are
+ * deterministic, so they may be used in indexes and generated columns.
+ */
+class ScoringFunctions {
+public:
+    static double churnRisk(const ChurnFactors& factors);
+
+    static bool registerWith(sqlite3* db);
+};
@@ -0,0 +1,143 @@
+// Shard router for Riley Corpbrain - per-company database files
+#include "shard_router.h"
+#include "database.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <future>
+#include <iostream>
+
+ShardRouter::ShardRouter() : ShardRouter(Options()) {}
+
+ShardRouter::ShardRouter(const Options& options) : options_(options) {
+    options_.max_open = std::max<size_t>(options_.max_open, 1);
+    options_.max_parallel = std::max<size_t>(options_.max_parallel, 1);
+}
+
+std::shared_ptr<Database> ShardRouter::shard(const std::string& company, bool create) {
+    if (!validCompanyId(company)) {
+        std::cerr << "❌ Invalid company id: '" << company << "'" << std::endl;
+        return nullptr;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = open_.find(company);
+        if (it != open_.end()) {
+            recent_.splice(recent_.begin(), recent_, it->second.position);
+            return it->second.db;
+        }
+    }
+
+    // Open outside the lock - creating a shard applies its schema, and other
+    // tenants should not wait for that
+    std::string path = (std::filesystem::path(options_.directory) / (company + ".db")).string();
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+        if (!create) {
+            std::cerr << "⚠️ No shard for company '" << company << "'" << std::endl;
+            return nullptr;
+        }
+        std::filesystem::create_directories(options_.directory, error);
+        if (error) {
+            std::cerr << "❌ Cannot create shard directory " << options_.directory << ": " << error.message() << std::endl;
+            return nullptr;
+        }
+    }
+
+    std::shared_ptr<Database> db;
+    try {
+        db = std::make_shared<Database>(path, options_.readers_per_shard);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Cannot open shard for " << company << ": " << e.what() << std::endl;
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Another thread may have opened it meanwhile - keep the first one
+    auto it = open_.find(company);
+    if (it != open_.end()) {
+        recent_.splice(recent_.begin(), recent_, it->second.position);
+        return it->second.db;
+    }
+
+    recent_.push_front(company);
+    open_[company] = Entry{db, recent_.begin()};
+
+    if (open_.size() > options_.max_open) {
+        open_.erase(recent_.back());
+        recent_.pop_back();
+    }
+
+    return db;
+}
+
+std::vector<std::string> ShardRouter::companies() const {
+    std::vector<std::string> found;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(options_.directory, error)) {
+        if (entry.path().extension() == ".db") {
+            std::string company = entry.path().stem().string();
+            if (validCompanyId(company)) {
+                found.push_back(company);
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+std::vector<std::map<std::string, std::string>> ShardRouter::scatterGather(const std::string& sql,
+                                                                           std::vector<std::string> companies) {
+    if (companies.empty()) {
+        companies = this->companies();
+    }
+
+    std::vector<std::vector<std::map<std::string, std::string>>> results(companies.size());
+
+    // Fan out in waves so a large tenant list does not spawn a thread per shard
+    for (size_t start = 0; start < companies.size(); start += options_.max_parallel) {
+        size_t end = std::min(companies.size(), start + options_.max_parallel);
+        std::vector<std::future<void>> wave;
+
+        for (size_t i = start; i < end; i++) {
+            wave.push_back(std::async(std::launch::async, [this, &companies, &results, &sql, i] {
+                std::shared_ptr<Database> db = shard(companies[i], false);
+                if (!db) {
+                    return;
+                }
+                results[i] = db->query(sql);
+                for (auto& row : results[i]) {
+                    row["company"] = companies[i];
+                }
+            }));
+        }
+
+        for (auto& task : wave) {
+            task.get();
+        }
+    }
+
+    std::vector<std::map<std::string, std::string>> merged;
+    for (auto& rows : results) {
+        std::move(rows.begin(), rows.end(), std::back_inserter(merged));
+    }
+    return merged;
+}
+
+size_t ShardRouter::openCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_.size();
+}
+
+bool ShardRouter::validCompanyId(const std::string& company) {
+    if (company.empty() || company.size() > 64) {
+        return false;
+    }
+    return std::all_of(company.begin(), company.end(), [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+    });
+}
@@ -0,0 +1,71 @@
+// Shard router - one database file per company
+#pragma once
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Database;
+
+/**
+ * Shard Router - maps each company (tenant) to its own SQLite file
+ * <directory>/<company>.db, so a busy subsidiary's writer lock, WAL and page
+ * cache are separate from everyone else's. Open shards are kept in an LRU
+ * of max_open databases; evicting one only drops the router's reference,
+ * so callers still holding the shared_ptr keep using it safely.
+ *
+ * Scatter-gather runs one statement on many shards in parallel (at most
+ * max_parallel at a time) and concatenates the rows, each tagged with a
+ * "company" column. Aggregates come back per shard - re-aggregate them
+ * after the merge.
+ *
+ * Company ids are used as file names, so only letters, digits, '-' and '_'
+ * are accepted. Scatter-gather only opens shards that already exist, so a
+ * mistyped id is skipped rather than created. The directory itself is
+ * created with the first shard.
+ */
+class ShardRouter {
+public:
+    struct Options {
+        std::string directory = "tenants";
+        size_t max_open = 16;
+        size_t readers_per_shard = 2;
+        size_t max_parallel = 8;
+    };
+
+    ShardRouter();
+    explicit ShardRouter(const Options& options);
+
+    ShardRouter(const ShardRouter&) = delete;
+    ShardRouter& operator=(const ShardRouter&) = delete;
+
+    // The company's database, opened on first use and created when it does
+    // not exist yet (unless create is false); null on error or when missing
+    std::shared_ptr<Database> shard(const std::string& company, bool create = true);
+
+    // Every company with a database file, sorted
+    std::vector<std::string> companies() const;
+
+    // Run sql on the given companies (all of them when empty) in parallel
+    std::vector<std::map<std::string, std::string>> scatterGather(const std::string& sql,
+                                                                  std::vector<std::string> companies = {});
+
+    size_t openCount() const;
+    static bool validCompanyId(const std::string& company);
+
+private:
+    struct Entry {
+        std::shared_ptr<Database> db;
+        std::list<std::string>::iterator position;
+    };
+
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::list<std::string> recent_;  // most recently used first
+    std::unordered_map<std::string, Entry> open_;
+};
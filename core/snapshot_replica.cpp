@@ -0,0 +1,161 @@
+// Snapshot replica for Riley Corpbrain - analytics off the live database file
+#include "snapshot_replica.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+SnapshotReplica::Snapshot::~Snapshot() {
+    readers.reset();
+    sqlite3_close(handle);
+}
+
+SnapshotReplica::SnapshotReplica(const std::string& source_path, const Options& options, QueryStats* stats)
+    : source_path_(source_path), options_(options), stats_(stats) {
+    if (!refresh()) {
+        throw std::runtime_error("Cannot create snapshot replica of " + source_path);
+    }
+
+    if (options_.background_refresh) {
+        refresher_ = std::thread(&SnapshotReplica::runRefresher, this);
+    }
+}
+
+SnapshotReplica::~SnapshotReplica() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    stop_signal_.notify_all();
+
+    if (refresher_.joinable()) {
+        refresher_.join();
+    }
+}
+
+PreparedStatement SnapshotReplica::prepare(const std::string& sql) {
+    if (age() > options_.max_staleness) {
+        std::lock_guard<std::mutex> refreshing(refresh_mutex_);
+        // Another thread may have refreshed while this one waited
+        if (age() > options_.max_staleness) {
+            swapInNewCopy();
+        }
+    }
+
+    std::shared_ptr<Snapshot> snapshot = current();
+    ConnectionPool::Lease lease = snapshot->readers->acquire();
+    if (!lease) {
+        return PreparedStatement();
+    }
+
+    PreparedStatement stmt = lease->statements->acquire(sql);
+    if (!stmt) {
+        return stmt;
+    }
+
+    // The guard keeps this copy alive across a swap and returns the reader on release
+    auto guard = std::make_shared<std::pair<std::shared_ptr<Snapshot>, ConnectionPool::Lease>>(
+        std::move(snapshot), std::move(lease));
+    stmt.attachGuard(std::move(guard));
+    return stmt;
+}
+
+bool SnapshotReplica::refresh() {
+    std::lock_guard<std::mutex> refreshing(refresh_mutex_);
+    return swapInNewCopy();
+}
+
+// Caller holds refresh_mutex_
+bool SnapshotReplica::swapInNewCopy() {
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<Snapshot> snapshot = takeSnapshot();
+    if (!snapshot) {
+        return false;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_ = std::move(snapshot);
+        last_duration_ = elapsed;
+    }
+    refresh_count_++;
+    return true;
+}
+
+std::shared_ptr<SnapshotReplica::Snapshot> SnapshotReplica::takeSnapshot() {
+    sqlite3* source = nullptr;
+    if (sqlite3_open_v2(source_path_.c_str(), &source, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                        nullptr) != SQLITE_OK) {
+        std::cerr << "❌ Replica cannot open source: " << sqlite3_errmsg(source) << std::endl;
+        sqlite3_close(source);
+        return nullptr;
+    }
+    sqlite3_busy_timeout(source, 5000);
+
+    // A named memdb database is shared by every connection that opens the
+    // name, and freed when the last one closes
+    std::string name = "file:/riley-replica-" + std::to_string(reinterpret_cast<uintptr_t>(this)) + "-" +
+                       std::to_string(++copies_taken_) + "?vfs=memdb";
+    auto snapshot = std::make_shared<Snapshot>();
+    if (sqlite3_open_v2(name.c_str(), &snapshot->handle,
+                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX,
+                        nullptr) != SQLITE_OK) {
+        std::cerr << "❌ Replica cannot open memory database: " << sqlite3_errmsg(snapshot->handle) << std::endl;
+        sqlite3_close(source);
+        return nullptr;
+    }
+
+    // One step copies every page inside a single read transaction - in WAL
+    // mode that is a consistent snapshot and writers carry on meanwhile
+    sqlite3_backup* backup = sqlite3_backup_init(snapshot->handle, "main", source, "main");
+    int rc = backup ? sqlite3_backup_step(backup, -1) : SQLITE_ERROR;
+    sqlite3_backup_finish(backup);
+
+    if (rc != SQLITE_DONE) {
+        std::cerr << "❌ Replica backup failed: " << sqlite3_errmsg(snapshot->handle) << std::endl;
+        sqlite3_close(source);
+        return nullptr;
+    }
+    sqlite3_close(source);
+
+    try {
+        snapshot->readers = std::make_unique<ConnectionPool>(name, std::max<size_t>(options_.readers, 1), stats_);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Replica readers unavailable: " << e.what() << std::endl;
+        return nullptr;
+    }
+    snapshot->taken_at = std::chrono::steady_clock::now();
+    return snapshot;
+}
+
+std::shared_ptr<SnapshotReplica::Snapshot> SnapshotReplica::current() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_;
+}
+
+std::chrono::milliseconds SnapshotReplica::age() const {
+    std::shared_ptr<Snapshot> snapshot = current();
+    if (!snapshot) {
+        return std::chrono::milliseconds::max();
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - snapshot->taken_at);
+}
+
+std::chrono::milliseconds SnapshotReplica::lastRefreshDuration() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_duration_;
+}
+
+void SnapshotReplica::runRefresher() {
+    auto interval = std::max<std::chrono::milliseconds>(options_.max_staleness / 2, std::chrono::seconds(1));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_signal_.wait_for(lock, interval, [this] { return stopping_; })) {
+        lock.unlock();
+        refresh();
+        lock.lock();
+    }
+}
@@ -0,0 +1,83 @@
+// Snapshot replica - periodically refreshed in-memory copy for analytics
+#pragma once
+#include "connection_pool.h"
+#include "statement_cache.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+struct sqlite3;
+class QueryStats;
+
+/**
+ * Snapshot Replica - read-only in-memory copy of the database file
+ * Taken with the SQLite online backup API from a separate read-only
+ * connection, so in WAL mode a copy never blocks the writer. Long analytics
+ * queries run here instead of holding read transactions on the live file.
+ * Each refresh builds a complete new copy and swaps it in; statements still
+ * running on the old copy finish there. A copy older than max_staleness is
+ * refreshed before the next statement is prepared, and with
+ * background_refresh a thread keeps it fresh ahead of time.
+ *
+ * The copy lives in a named memdb database that a small ConnectionPool of
+ * read-only connections shares, so analytics statements on different
+ * threads run in parallel as they do on the WAL reader pool, and a thread
+ * may nest statements on the reader it already holds.
+ */
+class SnapshotReplica {
+public:
+    struct Options {
+        std::chrono::seconds max_staleness{60};
+        bool background_refresh = true;  // refresh every max_staleness / 2
+        size_t readers = 4;  // connections sharing each copy
+    };
+
+    SnapshotReplica(const std::string& source_path, const Options& options, QueryStats* stats = nullptr);
+    ~SnapshotReplica();
+
+    SnapshotReplica(const SnapshotReplica&) = delete;
+    SnapshotReplica& operator=(const SnapshotReplica&) = delete;
+
+    // The statement holds one of the copy's readers until it is released;
+    // empty when the copy cannot compile it or no reader came free
+    PreparedStatement prepare(const std::string& sql);
+
+    bool refresh();  // copy now, regardless of age
+    std::chrono::milliseconds age() const;
+    uint64_t refreshCount() const { return refresh_count_.load(); }
+    std::chrono::milliseconds lastRefreshDuration() const;
+
+private:
+    struct Snapshot {
+        sqlite3* handle = nullptr;  // holds the memdb copy open for the readers
+        std::unique_ptr<ConnectionPool> readers;
+        std::chrono::steady_clock::time_point taken_at;
+        ~Snapshot();
+    };
+
+    bool swapInNewCopy();
+    std::shared_ptr<Snapshot> takeSnapshot();
+    std::shared_ptr<Snapshot> current() const;
+    void runRefresher();
+
+    std::string source_path_;
+    Options options_;
+    QueryStats* stats_;
+
+    mutable std::mutex mutex_;  // guards current_ and last_duration_
+    std::shared_ptr<Snapshot> current_;
+    std::chrono::milliseconds last_duration_{0};
+    std::atomic<uint64_t> refresh_count_{0};
+    uint64_t copies_taken_ = 0;  // names each memdb copy; under refresh_mutex_
+
+    std::mutex refresh_mutex_;  // one copy in flight at a time
+
+    std::condition_variable stop_signal_;
+    bool stopping_ = false;
+    std::thread refresher_;
+};
@@ -0,0 +1,328 @@
+// Source sync for Riley Corpbrain - tail state persistence and file watching
+#include "source_sync.h"
+#include "database.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+uint64_t fnv1a(std::string_view bytes) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+SyncStateStore::SyncStateStore(Database* db) : db_(db) {}
+
+std::map<std::string, SyncState> SyncStateStore::load() {
+    std::map<std::string, SyncState> states;
+    ready_ = db_->ensureSchema("sync_state", R"(
+        CREATE TABLE IF NOT EXISTS sync_state (
+            source TEXT PRIMARY KEY,
+            path TEXT NOT NULL,
+            table_name TEXT NOT NULL,
+            format TEXT NOT NULL,
+            byte_offset INTEGER NOT NULL DEFAULT 0,
+            rows_loaded INTEGER NOT NULL DEFAULT 0,
+            inode INTEGER NOT NULL DEFAULT 0,
+            head_hash INTEGER NOT NULL DEFAULT 0,
+            tail_hash INTEGER NOT NULL DEFAULT 0,
+            columns TEXT NOT NULL DEFAULT '',
+            partial INTEGER NOT NULL DEFAULT 0,
+            interval_minutes INTEGER NOT NULL DEFAULT 0,
+            active INTEGER NOT NULL DEFAULT 0,
+            last_sync TEXT
+        );
+    )");
+    if (!ready_) {
+        std::cerr << "❌ Sync state table unavailable; live syncs will not resume after restart" << std::endl;
+        return states;
+    }
+
+    db_->forEachRow("SELECT source, path, table_name, format, byte_offset, rows_loaded, inode, head_hash, "
+                    "tail_hash, columns, partial, interval_minutes, active, last_sync FROM sync_state;",
+                    [&states](const RowView& row) {
+                        SyncState state;
+                        state.source = std::string(row.getText(0));
+                        state.path = std::string(row.getText(1));
+                        state.table = std::string(row.getText(2));
+                        state.format = std::string(row.getText(3));
+                        state.offset = static_cast<uint64_t>(row.getInt64(4));
+                        state.rows = static_cast<uint64_t>(row.getInt64(5));
+                        state.inode = static_cast<uint64_t>(row.getInt64(6));
+                        state.head_hash = static_cast<uint64_t>(row.getInt64(7));
+                        state.tail_hash = static_cast<uint64_t>(row.getInt64(8));
+                        state.columns = decodeColumns(std::string(row.getText(9)));
+                        state.partial = row.getInt64(10) != 0;
+                        state.interval_minutes = static_cast<int>(row.getInt64(11));
+                        state.active = row.getInt64(12) != 0;
+                        state.last_sync = std::string(row.getText(13));
+                        states[state.source] = std::move(state);
+                        return true;
+                    });
+    return states;
+}
+
+bool SyncStateStore::save(const SyncState& state) {
+    if (!ready_) {
+        return false;
+    }
+
+    PreparedStatement stmt = db_->prepare(
+        "INSERT OR REPLACE INTO sync_state (source, path, table_name, format, byte_offset, rows_loaded, inode, "
+        "head_hash, tail_hash, columns, partial, interval_minutes, active, last_sync) "
+        "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14);");
+    bool ok = stmt && stmt.bind(1, state.source) && stmt.bind(2, state.path) && stmt.bind(3, state.table) &&
+              stmt.bind(4, state.format) && stmt.bind(5, static_cast<int64_t>(state.offset)) &&
+              stmt.bind(6, static_cast<int64_t>(state.rows)) && stmt.bind(7, static_cast<int64_t>(state.inode)) &&
+              stmt.bind(8, static_cast<int64_t>(state.head_hash)) &&
+              stmt.bind(9, static_cast<int64_t>(state.tail_hash)) && stmt.bind(10, encodeColumns(state.columns)) &&
+              stmt.bind(11, state.partial ? 1 : 0) && stmt.bind(12, state.interval_minutes) &&
+              stmt.bind(13, state.active ? 1 : 0) && stmt.bind(14, state.last_sync) && stmt.execute();
+    if (!ok) {
+        std::cerr << "❌ Sync state not saved for " << state.source << ": " << stmt.errorMessage() << std::endl;
+    }
+    return ok;
+}
+
+bool SyncStateStore::fingerprints(const std::string& path, uint64_t offset, uint64_t* head, uint64_t* tail) {
+    size_t head_length = static_cast<size_t>(std::min<uint64_t>(offset, kFingerprintBytes));
+    size_t tail_length = head_length;
+    std::string bytes;
+    if (!readRange(path, 0, head_length, &bytes) || !readRange(path, offset - tail_length, tail_length, &bytes)) {
+        return false;
+    }
+    *head = fnv1a(std::string_view(bytes).substr(0, head_length));
+    *tail = fnv1a(std::string_view(bytes).substr(head_length));
+    return true;
+}
+
+bool SyncStateStore::readRange(const std::string& path, uint64_t offset, size_t length, std::string* out) {
+    if (length == 0) {
+        return true;
+    }
+    std::ifstream file(path, std::ios::binary);
+    if (!file.seekg(static_cast<std::streamoff>(offset))) {
+        return false;
+    }
+    size_t start = out->size();
+    out->resize(start + length);
+    file.read(&(*out)[start], static_cast<std::streamsize>(length));
+    if (static_cast<size_t>(file.gcount()) != length) {
+        out->resize(start);
+        return false;
+    }
+    return true;
+}
+
+bool SyncStateStore::stat(const std::string& path, uint64_t* size, uint64_t* inode) {
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(path, error)) {
+        return false;
+    }
+    uintmax_t bytes = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    *size = static_cast<uint64_t>(bytes);
+    *inode = 0;
+#ifndef _WIN32
+    struct stat info;
+    if (::stat(path.c_str(), &info) == 0) {
+        *inode = static_cast<uint64_t>(info.st_ino);
+    }
+#endif
+    return true;
+}
+
+// Per column "type,date order,name length:name" - names may hold any character
+std::string SyncStateStore::encodeColumns(const std::vector<TypeInference::Column>& columns) {
+    std::string text;
+    for (const auto& column : columns) {
+        text += std::to_string(static_cast<int>(column.type)) + "," + std::to_string(static_cast<int>(column.date_order)) +
+                "," + std::to_string(column.name.size()) + ":" + column.name;
+    }
+    return text;
+}
+
+std::vector<TypeInference::Column> SyncStateStore::decodeColumns(const std::string& text) {
+    std::vector<TypeInference::Column> columns;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        int type = 0, order = 0;
+        size_t length = 0;
+        int consumed = 0;
+        if (std::sscanf(text.c_str() + pos, "%d,%d,%zu:%n", &type, &order, &length, &consumed) != 3 ||
+            consumed == 0 || pos + consumed + length > text.size()) {
+            return {};  // unreadable: the source is reloaded and re-inferred
+        }
+        pos += consumed;
+
+        TypeInference::Column column;
+        column.type = static_cast<TypeInference::Type>(type);
+        column.date_order = static_cast<TypeInference::DateOrder>(order);
+        column.name = text.substr(pos, length);
+        columns.push_back(std::move(column));
+        pos += length;
+    }
+    return columns;
+}
+
+FileWatcher::FileWatcher() {
+#ifdef __linux__
+    notify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notify_fd_ >= 0) {
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) {
+            close(notify_fd_);
+            notify_fd_ = -1;
+        }
+    }
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+    if (notify_fd_ >= 0) {
+        close(notify_fd_);
+        close(wake_fd_);
+    }
+#endif
+}
+
+std::string FileWatcher::normalize(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    return (error ? std::filesystem::path(path) : absolute).lexically_normal().string();
+}
+
+void FileWatcher::watch(const std::string& path) {
+    std::string file = normalize(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (files_[file]++ > 0) {
+        return;
+    }
+
+#ifdef __linux__
+    std::string directory = std::filesystem::path(file).parent_path().string();
+    if (notify_fd_ >= 0 && !directories_.count(directory)) {
+        int watch = inotify_add_watch(notify_fd_, directory.c_str(),
+                                      IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE);
+        if (watch < 0) {
+            std::cerr << "⚠️ Cannot watch " << directory << "; changes there are found by polling only" << std::endl;
+        } else {
+            directories_[directory] = watch;
+            watch_dirs_[watch] = directory;
+        }
+    }
+#endif
+}
+
+void FileWatcher::unwatch(const std::string& path) {
+    std::string file = normalize(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(file);
+    if (it == files_.end() || --it->second > 0) {
+        return;
+    }
+    files_.erase(it);
+
+#ifdef __linux__
+    // The directory watch goes once no watched file is left in it
+    std::string directory = std::filesystem::path(file).parent_path().string();
+    bool in_use = std::any_of(files_.begin(), files_.end(), [&directory](const auto& entry) {
+        return std::filesystem::path(entry.first).parent_path().string() == directory;
+    });
+    auto watch = directories_.find(directory);
+    if (!in_use && watch != directories_.end()) {
+        inotify_rm_watch(notify_fd_, watch->second);
+        watch_dirs_.erase(watch->second);
+        directories_.erase(watch);
+    }
+#endif
+}
+
+std::vector<std::string> FileWatcher::wait(std::chrono::milliseconds timeout) {
+    std::vector<std::string> changed;
+
+#ifdef __linux__
+    if (notify_fd_ >= 0) {
+        pollfd fds[2] = {{notify_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+        int ms = static_cast<int>(std::clamp<int64_t>(timeout.count(), 0, 24 * 60 * 60 * 1000));
+        if (poll(fds, 2, ms) <= 0) {
+            return changed;
+        }
+
+        if (fds[1].revents & POLLIN) {
+            uint64_t count;
+            ssize_t drained = read(wake_fd_, &count, sizeof(count));
+            (void)drained;
+        }
+
+        alignas(inotify_event) char buffer[16 * 1024];
+        std::lock_guard<std::mutex> lock(mutex_);
+        ssize_t length;
+        while ((length = read(notify_fd_, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + length;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + event->len;
+
+                auto directory = watch_dirs_.find(event->wd);
+                if (directory == watch_dirs_.end() || event->len == 0) {
+                    continue;
+                }
+                std::string file = (std::filesystem::path(directory->second) / event->name).string();
+                if (files_.count(file) && std::find(changed.begin(), changed.end(), file) == changed.end()) {
+                    changed.push_back(file);
+                }
+            }
+        }
+        return changed;
+    }
+#endif
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (wake_signal_.wait_for(lock, timeout, [this] { return woken_; })) {
+        woken_ = false;
+        return changed;
+    }
+    for (const auto& entry : files_) {
+        changed.push_back(entry.first);
+    }
+    return changed;
+}
+
+void FileWatcher::wake() {
+#ifdef __linux__
+    if (notify_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(wake_fd_, &one, sizeof(one));
+        (void)written;
+        return;
+    }
+#endif
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        woken_ = true;
+    }
+    wake_signal_.notify_all();
+}
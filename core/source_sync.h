@@ -0,0 +1,119 @@
+// Source sync - persisted tail positions and change watching for file sources
+#pragma once
+#include "type_inference.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Database;
+
+/**
+ * Sync State - how much of a file source has been loaded into its table
+ * offset is the end of the last whole record loaded; a record still being
+ * written at the end of the file waits for the next pass. The inode and
+ * fingerprints of the bytes at the start of the file and just before
+ * offset tell an append from a rewrite: if the file was replaced, shrank
+ * below offset or no longer has the loaded bytes in place, it is reloaded
+ * from the start. A rewrite that keeps both ends byte-identical goes
+ * unnoticed until the file next shrinks or is replaced. A JSON document
+ * that is not one value per line cannot be tailed: once its size or
+ * fingerprints change it is reloaded whole.
+ */
+struct SyncState {
+    std::string source;
+    std::string path;
+    std::string table;
+    std::string format;  // "csv", or "json": NDJSON is tailed by whole lines, a document reloaded
+    uint64_t offset = 0;
+    uint64_t rows = 0;
+    uint64_t inode = 0;
+    uint64_t head_hash = 0;
+    uint64_t tail_hash = 0;
+    std::vector<TypeInference::Column> columns;  // CSV: as the table was created
+    bool partial = false;  // a pass failed midway: reload before tailing again
+    int interval_minutes = 0;
+    bool active = false;
+    std::string last_sync;
+};
+
+/**
+ * Sync State Store - SyncState rows kept in sync_state, so live syncs
+ * resume where they stopped after a restart instead of reloading
+ */
+class SyncStateStore {
+public:
+    explicit SyncStateStore(Database* db);
+
+    std::map<std::string, SyncState> load();
+    bool save(const SyncState& state);
+
+    // Bytes hashed at each end of the loaded prefix
+    static constexpr size_t kFingerprintBytes = 4096;
+    // Most bytes of a source a sync pass holds in memory at once
+    static constexpr size_t kReadBytes = 64 << 20;
+
+    // Hashes of the bytes at each end of the first offset bytes of the file;
+    // false when it holds fewer or cannot be read
+    static bool fingerprints(const std::string& path, uint64_t offset, uint64_t* head, uint64_t* tail);
+
+    // Appends length bytes from offset to out; false when the file is now
+    // shorter. Live sources are read, never mapped: a mapping faults
+    // (SIGBUS) when the file is truncated under it
+    static bool readRange(const std::string& path, uint64_t offset, size_t length, std::string* out);
+
+    // Size and inode of a regular file; false when it cannot be read.
+    // The inode is 0 on Windows, where the fingerprints alone decide
+    static bool stat(const std::string& path, uint64_t* size, uint64_t* inode);
+
+private:
+    static std::string encodeColumns(const std::vector<TypeInference::Column>& columns);
+    static std::vector<TypeInference::Column> decodeColumns(const std::string& text);
+
+    Database* db_;
+    bool ready_ = false;
+};
+
+/**
+ * File Watcher - change notification for a set of files
+ * On Linux the parent directories are watched with inotify, since exports
+ * are often replaced by rename, which a watch on the file itself would
+ * miss; wait() returns once a watched file is written, created, moved or
+ * deleted. Elsewhere (or without inotify) wait() sleeps out the timeout
+ * and reports every file, leaving the caller's own checks to decide.
+ */
+class FileWatcher {
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Paths are compared in this form; watch() may be called repeatedly
+    static std::string normalize(const std::string& path);
+    void watch(const std::string& path);
+    void unwatch(const std::string& path);
+
+    // Normalized paths that changed within timeout; empty after wake()
+    std::vector<std::string> wait(std::chrono::milliseconds timeout);
+    void wake();
+
+    bool notifying() const { return notify_fd_ >= 0; }
+
+private:
+    std::mutex mutex_;
+    std::map<std::string, int> files_;        // path -> watch count
+    std::map<std::string, int> directories_;  // directory -> inotify watch
+    std::map<int, std::string> watch_dirs_;
+
+    int notify_fd_ = -1;
+    int wake_fd_ = -1;
+    std::condition_variable wake_signal_;  // without inotify
+    bool woken_ = false;
+};
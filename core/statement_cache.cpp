@@ -0,0 +1,313 @@
+// Prepared statement cache for Riley Corpbrain - avoids re-parsing hot SQL
+#include "statement_cache.h"
+#include "query_stats.h"
+#include <sqlite3.h>
+
+// ---------------------------------------------------------------------------
+// PreparedStatement
+// ---------------------------------------------------------------------------
+
+PreparedStatement::PreparedStatement(sqlite3_stmt* stmt, StatementCache* cache)
+    : stmt_(stmt), cache_(cache) {}
+
+PreparedStatement::PreparedStatement(PreparedStatement&& other) noexcept
+    : stmt_(other.stmt_), cache_(other.cache_), status_(other.status_),
+      guard_(std::move(other.guard_)), elapsed_(other.elapsed_), rows_(other.rows_),
+      running_(other.running_) {
+    other.stmt_ = nullptr;
+    other.cache_ = nullptr;
+    other.running_ = false;
+}
+
+PreparedStatement& PreparedStatement::operator=(PreparedStatement&& other) noexcept {
+    if (this != &other) {
+        release();
+        stmt_ = other.stmt_;
+        cache_ = other.cache_;
+        status_ = other.status_;
+        guard_ = std::move(other.guard_);
+        elapsed_ = other.elapsed_;
+        rows_ = other.rows_;
+        running_ = other.running_;
+        other.stmt_ = nullptr;
+        other.cache_ = nullptr;
+        other.running_ = false;
+    }
+    return *this;
+}
+
+PreparedStatement::~PreparedStatement() {
+    release();
+}
+
+void PreparedStatement::release() {
+    if (!stmt_) {
+        guard_.reset();
+        return;
+    }
+
+    finishExecution();
+    sqlite3_reset(stmt_);
+    sqlite3_clear_bindings(stmt_);
+
+    if (cache_) {
+        cache_->release(stmt_);
+    } else {
+        sqlite3_finalize(stmt_);
+    }
+
+    stmt_ = nullptr;
+    cache_ = nullptr;
+
+    // Only now may the connection be used by someone else
+    guard_.reset();
+}
+
+bool PreparedStatement::bind(int index, int64_t value) {
+    return sqlite3_bind_int64(stmt_, index, static_cast<sqlite3_int64>(value)) == SQLITE_OK;
+}
+
+bool PreparedStatement::bind(int index, double value) {
+    return sqlite3_bind_double(stmt_, index, value) == SQLITE_OK;
+}
+
+bool PreparedStatement::bind(int index, std::string_view value) {
+    return sqlite3_bind_text64(stmt_, index, value.data(), value.size(),
+                               SQLITE_TRANSIENT, SQLITE_UTF8) == SQLITE_OK;
+}
+
+bool PreparedStatement::bindBlob(int index, const void* data, size_t size) {
+    return sqlite3_bind_blob64(stmt_, index, data, size, SQLITE_TRANSIENT) == SQLITE_OK;
+}
+
+bool PreparedStatement::bindNull(int index) {
+    return sqlite3_bind_null(stmt_, index) == SQLITE_OK;
+}
+
+bool PreparedStatement::bindValue(int index, const SqlValue& value) {
+    switch (value.index()) {
+        case 1: return bind(index, std::get<int64_t>(value));
+        case 2: return bind(index, std::get<double>(value));
+        case 3: return bind(index, std::get<std::string>(value));
+        default: return bindNull(index);
+    }
+}
+
+int PreparedStatement::parameterIndex(const char* name) const {
+    return sqlite3_bind_parameter_index(stmt_, name);
+}
+
+int PreparedStatement::parameterCount() const {
+    return sqlite3_bind_parameter_count(stmt_);
+}
+
+bool PreparedStatement::step() {
+    QueryStats* stats = cache_ ? cache_->queryStats() : nullptr;
+    if (!stats) {
+        status_ = sqlite3_step(stmt_);
+        return status_ == SQLITE_ROW;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    status_ = sqlite3_step(stmt_);
+    elapsed_ += std::chrono::steady_clock::now() - start;
+    running_ = true;
+
+    if (status_ == SQLITE_ROW) {
+        rows_++;
+        return true;
+    }
+
+    finishExecution();
+    return false;
+}
+
+bool PreparedStatement::execute() {
+    while (step()) {
+    }
+    return status_ == SQLITE_DONE;
+}
+
+// An execution ends at SQLITE_DONE, on error, or when the caller resets or
+// releases the statement early
+void PreparedStatement::finishExecution() {
+    if (!running_) {
+        return;
+    }
+    running_ = false;
+
+    if (QueryStats* stats = cache_ ? cache_->queryStats() : nullptr) {
+        stats->record(stmt_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed_), rows_, failed());
+    }
+
+    elapsed_ = {};
+    rows_ = 0;
+}
+
+void PreparedStatement::reset() {
+    finishExecution();
+    sqlite3_reset(stmt_);
+    status_ = SQLITE_OK;
+}
+
+bool PreparedStatement::failed() const {
+    return status_ != SQLITE_OK && status_ != SQLITE_ROW && status_ != SQLITE_DONE;
+}
+
+int PreparedStatement::columnCount() const {
+    return sqlite3_column_count(stmt_);
+}
+
+const char* PreparedStatement::columnName(int column) const {
+    return sqlite3_column_name(stmt_, column);
+}
+
+SqlType PreparedStatement::columnType(int column) const {
+    return static_cast<SqlType>(sqlite3_column_type(stmt_, column));
+}
+
+bool PreparedStatement::isNull(int column) const {
+    return sqlite3_column_type(stmt_, column) == SQLITE_NULL;
+}
+
+int64_t PreparedStatement::getInt64(int column) const {
+    return static_cast<int64_t>(sqlite3_column_int64(stmt_, column));
+}
+
+double PreparedStatement::getDouble(int column) const {
+    return sqlite3_column_double(stmt_, column);
+}
+
+std::string_view PreparedStatement::getText(int column) const {
+    // Fetch the pointer before the size, as documented by SQLite
+    const unsigned char* text = sqlite3_column_text(stmt_, column);
+    if (!text) {
+        return {};
+    }
+    return std::string_view(reinterpret_cast<const char*>(text),
+                            static_cast<size_t>(sqlite3_column_bytes(stmt_, column)));
+}
+
+std::string_view PreparedStatement::getBlob(int column) const {
+    const void* blob = sqlite3_column_blob(stmt_, column);
+    if (!blob) {
+        return {};
+    }
+    return std::string_view(static_cast<const char*>(blob),
+                            static_cast<size_t>(sqlite3_column_bytes(stmt_, column)));
+}
+
+int PreparedStatement::changes() const {
+    return sqlite3_changes(sqlite3_db_handle(stmt_));
+}
+
+int64_t PreparedStatement::lastInsertRowId() const {
+    return static_cast<int64_t>(sqlite3_last_insert_rowid(sqlite3_db_handle(stmt_)));
+}
+
+const char* PreparedStatement::errorMessage() const {
+    return sqlite3_errmsg(sqlite3_db_handle(stmt_));
+}
+
+const char* PreparedStatement::sql() const {
+    return sqlite3_sql(stmt_);
+}
+
+// ---------------------------------------------------------------------------
+// StatementCache
+// ---------------------------------------------------------------------------
+
+StatementCache::StatementCache(sqlite3* db, size_t capacity)
+    : db_(db), capacity_(capacity) {}
+
+StatementCache::~StatementCache() {
+    clear();
+}
+
+PreparedStatement StatementCache::acquire(const std::string& sql) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = idle_index_.find(sql);
+        if (it != idle_index_.end()) {
+            IdleList::iterator entry = it->second;
+            sqlite3_stmt* stmt = entry->second;
+            in_use_.emplace(stmt, std::move(entry->first));
+            idle_.erase(entry);
+            idle_index_.erase(it);
+            ++hits_;
+            return PreparedStatement(stmt, this);
+        }
+        ++misses_;
+    }
+
+    // Compile outside the lock - parsing is the expensive part we are caching
+    sqlite3_stmt* stmt = nullptr;
+    int rc = sqlite3_prepare_v3(db_, sql.c_str(), static_cast<int>(sql.size() + 1),
+                                SQLITE_PREPARE_PERSISTENT, &stmt, nullptr);
+    if (rc != SQLITE_OK || !stmt) {
+        sqlite3_finalize(stmt);
+        return PreparedStatement();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    in_use_.emplace(stmt, sql);
+    return PreparedStatement(stmt, this);
+}
+
+void StatementCache::release(sqlite3_stmt* stmt) {
+    sqlite3_stmt* evicted = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = in_use_.find(stmt);
+        if (it == in_use_.end()) {
+            evicted = stmt;
+        } else {
+            idle_.emplace_front(std::move(it->second), stmt);
+            idle_index_.emplace(idle_.front().first, idle_.begin());
+            in_use_.erase(it);
+
+            if (idle_.size() > capacity_) {
+                IdleList::iterator oldest = std::prev(idle_.end());
+                auto range = idle_index_.equal_range(oldest->first);
+                for (auto index = range.first; index != range.second; ++index) {
+                    if (index->second == oldest) {
+                        idle_index_.erase(index);
+                        break;
+                    }
+                }
+                evicted = oldest->second;
+                idle_.erase(oldest);
+            }
+        }
+    }
+
+    if (evicted) {
+        sqlite3_finalize(evicted);
+    }
+}
+
+void StatementCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : idle_) {
+        sqlite3_finalize(entry.second);
+    }
+    idle_.clear();
+    idle_index_.clear();
+}
+
+size_t StatementCache::idleCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return idle_.size();
+}
+
+uint64_t StatementCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t StatementCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
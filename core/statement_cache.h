@@ -0,0 +1,152 @@
+// Prepared statement cache - compiled SQLite statements reused by SQL text
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+class StatementCache;
+class QueryStats;
+
+// Storage class of a column value (same codes as SQLite's fundamental types)
+enum class SqlType {
+    INTEGER = 1,
+    REAL = 2,
+    TEXT = 3,
+    BLOB = 4,
+    NULL_VALUE = 5
+};
+
+// A parameter value held until it is bound (queued writes, bulk loads)
+using SqlValue = std::variant<std::nullptr_t, int64_t, double, std::string>;
+
+/**
+ * PreparedStatement - RAII handle over a cached sqlite3_stmt
+ * Parameters are bound 1-based (SQLite convention), columns are read 0-based.
+ * On destruction the statement is reset, its bindings cleared, and it is
+ * handed back to the owning cache for the next caller with the same SQL.
+ */
+class PreparedStatement {
+public:
+    PreparedStatement() = default;
+    PreparedStatement(sqlite3_stmt* stmt, StatementCache* cache);
+    PreparedStatement(PreparedStatement&& other) noexcept;
+    PreparedStatement& operator=(PreparedStatement&& other) noexcept;
+    PreparedStatement(const PreparedStatement&) = delete;
+    PreparedStatement& operator=(const PreparedStatement&) = delete;
+    ~PreparedStatement();
+
+    bool valid() const { return stmt_ != nullptr; }
+    explicit operator bool() const { return valid(); }
+
+    // Typed parameter binding
+    bool bind(int index, int64_t value);
+    bool bind(int index, int value) { return bind(index, static_cast<int64_t>(value)); }
+    bool bind(int index, double value);
+    bool bind(int index, std::string_view value);
+    bool bind(int index, const char* value) { return bind(index, std::string_view(value)); }
+    bool bind(int index, const std::string& value) { return bind(index, std::string_view(value)); }
+    bool bindBlob(int index, const void* data, size_t size);
+    bool bindNull(int index);
+    bool bindValue(int index, const SqlValue& value);
+    int parameterIndex(const char* name) const;
+    int parameterCount() const;
+
+    // Execution
+    bool step();     // true while a result row is available
+    bool execute();  // runs to completion, true on SQLITE_DONE
+    void reset();    // rewinds the statement, bindings are kept
+    bool failed() const;  // last step ended in an error rather than SQLITE_DONE
+
+    // Column access for the current row
+    int columnCount() const;
+    const char* columnName(int column) const;
+    SqlType columnType(int column) const;
+    bool isNull(int column) const;
+    int64_t getInt64(int column) const;
+    double getDouble(int column) const;
+    std::string_view getText(int column) const;
+    std::string_view getBlob(int column) const;
+
+    // Results of the last execution
+    int changes() const;
+    int64_t lastInsertRowId() const;
+    const char* errorMessage() const;
+    const char* sql() const;
+    sqlite3_stmt* handle() const { return stmt_; }
+
+    // Keeps a lock or connection lease alive until the statement is released
+    void attachGuard(std::shared_ptr<void> guard) { guard_ = std::move(guard); }
+
+private:
+    void release();
+    void finishExecution();  // reports the execution to the cache's QueryStats
+
+    sqlite3_stmt* stmt_ = nullptr;
+    StatementCache* cache_ = nullptr;
+    int status_ = 0;
+    std::shared_ptr<void> guard_;
+
+    // Time spent inside sqlite3_step for the current execution
+    std::chrono::steady_clock::duration elapsed_{};
+    uint64_t rows_ = 0;
+    bool running_ = false;
+};
+
+/**
+ * Statement Cache - per-connection LRU of idle prepared statements
+ * Statements are keyed by their exact SQL text, so callers must bind values
+ * as parameters instead of formatting them into the SQL string.
+ */
+class StatementCache {
+public:
+    explicit StatementCache(sqlite3* db, size_t capacity = 64);
+    ~StatementCache();
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    // Returns an invalid statement if SQLite fails to compile the SQL
+    PreparedStatement acquire(const std::string& sql);
+    void clear();
+
+    size_t idleCount() const;
+    uint64_t hits() const;
+    uint64_t misses() const;
+    sqlite3* connection() const { return db_; }
+
+    // Executions of this cache's statements are timed into stats
+    void setQueryStats(QueryStats* stats) { stats_ = stats; }
+    QueryStats* queryStats() const { return stats_; }
+
+private:
+    friend class PreparedStatement;
+    void release(sqlite3_stmt* stmt);
+
+    using IdleList = std::list<std::pair<std::string, sqlite3_stmt*>>;
+
+    sqlite3* db_;
+    size_t capacity_;
+    QueryStats* stats_ = nullptr;
+    mutable std::mutex mutex_;
+
+    // Idle statements, most recently released first
+    IdleList idle_;
+    std::unordered_multimap<std::string, IdleList::iterator> idle_index_;
+
+    // SQL key of every statement currently checked out
+    std::unordered_map<sqlite3_stmt*, std::string> in_use_;
+
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
@@ -0,0 +1,132 @@
+// Text search for Riley Corpbrain - FTS5 indexes kept in sync by triggers
+#include "text_search.h"
+#include "database.h"
+#include <cctype>
+#include <iostream>
+#include <set>
+
+namespace {
+
+std::set<std::string> tableColumns(Database* db, const std::string& table) {
+    std::set<std::string> columns;
+    PreparedStatement stmt = db->prepareRead("SELECT name FROM pragma_table_info(?1);");
+    if (stmt && stmt.bind(1, table)) {
+        Database::forEachRow(stmt, [&columns](const RowView& row) {
+            columns.emplace(row.getText(0));
+            return true;
+        });
+    }
+    return columns;
+}
+
+// "a, b" / "NEW.a, NEW.b"
+std::string columnList(const std::vector<std::string>& columns, const std::string& prefix) {
+    std::string list;
+    for (const auto& column : columns) {
+        list += (list.empty() ? "" : ", ") + prefix + column;
+    }
+    return list;
+}
+
+bool isWordByte(char c) {
+    // Bytes of multi-byte UTF-8 characters count as word bytes, like the
+    // unicode61 tokenizer treats letters outside ASCII
+    return std::isalnum(static_cast<unsigned char>(c)) || static_cast<unsigned char>(c) >= 0x80;
+}
+
+} // namespace
+
+bool TextSearch::install(Database* db, const std::string& index, const std::string& table,
+                         const std::vector<std::string>& columns) {
+    std::set<std::string> available = tableColumns(db, table);
+
+    std::vector<std::string> indexed;
+    for (const auto& column : columns) {
+        if (available.count(column)) {
+            indexed.push_back(column);
+        }
+    }
+
+    if (indexed.empty()) {
+        std::cout << "⚠️ Search index " << index << " skipped - " << table << " has none of its columns" << std::endl;
+        return false;
+    }
+
+    std::string fts = index + "_fts";
+    std::string cols = columnList(indexed, "");
+
+    // The whole block only runs when it differs from the last one applied,
+    // so the index is recreated and rebuilt rather than patched in place
+    std::string ddl =
+        "DROP TRIGGER IF EXISTS " + fts + "_insert;\n"
+        "DROP TRIGGER IF EXISTS " + fts + "_update;\n"
+        "DROP TRIGGER IF EXISTS " + fts + "_delete;\n"
+        "DROP TABLE IF EXISTS " + fts + ";\n"
+        "CREATE VIRTUAL TABLE " + fts + " USING fts5(" + cols + ", content='" + table +
+        "', content_rowid='rowid');\n"
+
+        "CREATE TRIGGER " + fts + "_insert AFTER INSERT ON " + table + " BEGIN\n"
+        "    INSERT INTO " + fts + " (rowid, " + cols + ") VALUES (NEW.rowid, " + columnList(indexed, "NEW.") + ");\n"
+        "END;\n"
+
+        // Only when indexed text changes - status updates leave the index alone
+        "CREATE TRIGGER " + fts + "_update AFTER UPDATE OF " + cols + " ON " + table + " BEGIN\n"
+        "    INSERT INTO " + fts + " (" + fts + ", rowid, " + cols + ") VALUES ('delete', OLD.rowid, " +
+        columnList(indexed, "OLD.") + ");\n"
+        "    INSERT INTO " + fts + " (rowid, " + cols + ") VALUES (NEW.rowid, " + columnList(indexed, "NEW.") + ");\n"
+        "END;\n"
+
+        "CREATE TRIGGER " + fts + "_delete AFTER DELETE ON " + table + " BEGIN\n"
+        "    INSERT INTO " + fts + " (" + fts + ", rowid, " + cols + ") VALUES ('delete', OLD.rowid, " +
+        columnList(indexed, "OLD.") + ");\n"
+        "END;\n"
+
+        "INSERT INTO " + fts + " (" + fts + ") VALUES ('rebuild');\n";
+
+    return db->ensureSchema("search:" + index, ddl);
+}
+
+std::vector<SearchHit> TextSearch::search(Database* db, const std::string& index,
+                                          const std::string& text, int limit) {
+    std::vector<SearchHit> hits;
+
+    std::string match = toMatchQuery(text);
+    if (match.empty()) {
+        return hits;
+    }
+
+    std::string fts = index + "_fts";
+    PreparedStatement stmt = db->prepareRead(
+        "SELECT rowid, bm25(" + fts + "), snippet(" + fts + ", -1, '[', ']', '...', 12) FROM " + fts +
+        " WHERE " + fts + " MATCH ?1 ORDER BY rank LIMIT ?2;");
+    if (!stmt || !stmt.bind(1, match) || !stmt.bind(2, limit)) {
+        return hits;
+    }
+
+    Database::forEachRow(stmt, [&hits](const RowView& row) {
+        hits.push_back({row.getInt64(0), row.getDouble(1), std::string(row.getText(2))});
+        return true;
+    });
+
+    return hits;
+}
+
+std::string TextSearch::toMatchQuery(const std::string& text) {
+    std::string query;
+
+    size_t i = 0;
+    while (i < text.size()) {
+        if (!isWordByte(text[i])) {
+            i++;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < text.size() && isWordByte(text[i])) {
+            i++;
+        }
+        query += (query.empty() ? "\"" : " \"") + text.substr(start, i - start) + "\"*";
+    }
+
+    return query;
+}
@@ -0,0 +1,37 @@
+// Text search - FTS5 indexes over free-text columns
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Database;
+
+struct SearchHit {
+    int64_t rowid;        // rowid in the source table
+    double score;         // bm25, lower is more relevant
+    std::string snippet;  // matched terms in [brackets]
+};
+
+/**
+ * Text Search - ranked full-text search backed by FTS5
+ * Each index is an external-content FTS5 table named <index>_fts over the
+ * source table, so the text is stored once. INSERT, UPDATE and DELETE
+ * triggers keep it in sync, and a lookup walks the inverted index instead
+ * of scanning every row. Installing runs through the schema migrator and
+ * rebuilds the index from the table only when its definition changes.
+ * Columns missing from the live table are left out of the index.
+ */
+class TextSearch {
+public:
+    static bool install(Database* db, const std::string& index, const std::string& table,
+                        const std::vector<std::string>& columns);
+
+    // Best matches first; every word must match, as a prefix
+    static std::vector<SearchHit> search(Database* db, const std::string& index,
+                                         const std::string& text, int limit = 20);
+
+    // Plain user text as an FTS5 MATCH expression: each word quoted (so
+    // operators and punctuation are inert) and prefix-matched. Empty when
+    // the text has no words.
+    static std::string toMatchQuery(const std::string& text);
+};
@@ -0,0 +1,265 @@
+// Type inference for Riley Corpbrain - reservoir sampling and typed conversion
+#include "type_inference.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <unordered_set>
+
+namespace {
+
+std::string_view trim(std::string_view text) {
+    size_t first = text.find_first_not_of(" \t");
+    if (first == std::string_view::npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(" \t") - first + 1);
+}
+
+// "007" is an identifier, not the number 7
+bool hasLeadingZero(std::string_view text) {
+    if (!text.empty() && text[0] == '-') {
+        text.remove_prefix(1);
+    }
+    return text.size() > 1 && text[0] == '0' && text[1] >= '0' && text[1] <= '9';
+}
+
+bool parseInteger(std::string_view text, int64_t* value) {
+    if (text.empty() || hasLeadingZero(text)) {
+        return false;
+    }
+    auto result = std::from_chars(text.data(), text.data() + text.size(), *value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool parseReal(std::string_view text, double* value) {
+    // from_chars also takes "inf" and "nan"; a number starts with a digit, '-' or '.'
+    if (text.empty() || hasLeadingZero(text) || !(std::isdigit(static_cast<unsigned char>(text[0])) || text[0] == '-' || text[0] == '.')) {
+        return false;
+    }
+    auto result = std::from_chars(text.data(), text.data() + text.size(), *value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+// Reads 1..max_digits digits; returns the count read
+size_t readNumber(std::string_view text, size_t pos, size_t max_digits, int* value) {
+    size_t i = pos;
+    *value = 0;
+    while (i < text.size() && i - pos < max_digits && text[i] >= '0' && text[i] <= '9') {
+        *value = *value * 10 + (text[i] - '0');
+        i++;
+    }
+    return i - pos;
+}
+
+void setText(SqlValue& out, std::string_view text) {
+    if (auto* existing = std::get_if<std::string>(&out)) {
+        existing->assign(text.data(), text.size());
+    } else {
+        out = std::string(text);
+    }
+}
+
+} // namespace
+
+TypeInference::TypeInference(std::vector<std::string> columns) : TypeInference(std::move(columns), Options()) {}
+
+TypeInference::TypeInference(std::vector<std::string> columns, const Options& options)
+    : columns_(std::move(columns)), options_(options), random_(options.seed) {
+    options_.sample_rows = std::max<size_t>(options_.sample_rows, 1);
+}
+
+void TypeInference::offer(const std::string_view* fields, size_t count) {
+    size_t slot = offered_++;
+    if (slot >= options_.sample_rows) {
+        slot = std::uniform_int_distribution<size_t>(0, slot)(random_);
+        if (slot >= options_.sample_rows) {
+            return;
+        }
+    } else {
+        sample_.emplace_back(columns_.size());
+    }
+
+    auto& row = sample_[slot];
+    for (size_t i = 0; i < columns_.size(); i++) {
+        std::string_view field = i < count ? fields[i] : std::string_view();
+        row[i].assign(field.data(), field.size());
+    }
+}
+
+std::vector<TypeInference::Column> TypeInference::infer() const {
+    std::vector<Column> result;
+    std::vector<std::string_view> values;
+
+    for (size_t c = 0; c < columns_.size(); c++) {
+        Column column;
+        column.name = columns_[c];
+
+        values.clear();
+        for (const auto& row : sample_) {
+            std::string_view value = trim(row[c]);
+            if (value.empty()) {
+                column.empty++;
+            } else {
+                values.push_back(value);
+            }
+        }
+        column.samples = values.size();
+        column.distinct = std::unordered_set<std::string_view>(values.begin(), values.end()).size();
+
+        auto all = [&values](auto&& test) { return std::all_of(values.begin(), values.end(), test); };
+        int64_t integer;
+        double real;
+
+        if (values.empty()) {
+            column.type = Type::Text;
+        } else if (all([&](std::string_view v) { return parseInteger(v, &integer); })) {
+            column.type = Type::Integer;
+        } else if (all([&](std::string_view v) { return parseReal(v, &real); })) {
+            column.type = Type::Real;
+        } else {
+            column.type = Type::Text;
+            for (DateOrder order : {DateOrder::YMD, DateOrder::MDY, DateOrder::DMY}) {
+                if (all([&](std::string_view v) { return parseDate(v, order, nullptr); })) {
+                    column.type = Type::Date;
+                    column.date_order = order;
+                    break;
+                }
+            }
+        }
+
+        size_t category_max = std::min(options_.category_max, column.samples / 20);
+        if (column.type == Type::Text && column.samples && column.distinct <= category_max) {
+            column.type = Type::Category;
+        }
+        result.push_back(std::move(column));
+    }
+    return result;
+}
+
+const char* TypeInference::sqlType(Type type) {
+    switch (type) {
+    case Type::Integer:
+        return "INTEGER";
+    case Type::Real:
+        return "REAL";
+    case Type::Date:
+        return "DATE";
+    default:
+        return "TEXT";
+    }
+}
+
+const char* TypeInference::typeName(Type type) {
+    return type == Type::Category ? "CATEGORY" : sqlType(type);
+}
+
+void TypeInference::convert(const Column& column, std::string_view field, SqlValue& out) {
+    if (column.type == Type::Text || column.type == Type::Category) {
+        setText(out, field);
+        return;
+    }
+
+    std::string_view value = trim(field);
+    if (value.empty()) {
+        out = nullptr;
+        return;
+    }
+
+    int64_t integer;
+    double real;
+    if (column.type == Type::Integer && parseInteger(value, &integer)) {
+        out = integer;
+    } else if (column.type != Type::Date && parseReal(value, &real)) {
+        out = real;
+    } else if (column.type == Type::Date) {
+        std::string* iso = std::get_if<std::string>(&out);
+        if (!iso) {
+            out = std::string();
+            iso = &std::get<std::string>(out);
+        }
+        if (!parseDate(value, column.date_order, iso)) {
+            iso->assign(field.data(), field.size());
+        }
+    } else {
+        setText(out, field);  // not what the sample predicted - keep it as written
+    }
+}
+
+bool TypeInference::parseDate(std::string_view text, DateOrder order, std::string* iso) {
+    // Date: 2024-03-31, 2024/3/31 (YMD); 3/31/2024 (MDY); 31.03.2024 (DMY)
+    int first, second, third;
+    size_t pos = 0;
+    size_t digits = readNumber(text, pos, 4, &first);
+    if (!digits || pos + digits >= text.size()) {
+        return false;
+    }
+    pos += digits;
+    char separator = text[pos];
+    if (separator != '-' && separator != '/' && separator != '.') {
+        return false;
+    }
+    bool year_first = digits == 4;
+    if (year_first != (order == DateOrder::YMD)) {
+        return false;
+    }
+    // Dotted dates are day-first wherever they are written; only slashes
+    // and dashes leave 01/02/2024 to the column's order
+    if (separator == '.' && order == DateOrder::MDY) {
+        return false;
+    }
+
+    size_t second_digits = readNumber(text, ++pos, 2, &second);
+    pos += second_digits;
+    if (!second_digits || pos >= text.size() || text[pos] != separator) {
+        return false;
+    }
+    size_t third_digits = readNumber(text, ++pos, year_first ? 2 : 4, &third);
+    pos += third_digits;
+    if (!third_digits || (!year_first && third_digits != 4)) {
+        return false;
+    }
+
+    int year = year_first ? first : third;
+    int month = order == DateOrder::DMY ? second : (year_first ? second : first);
+    int day = order == DateOrder::DMY ? first : (year_first ? third : second);
+
+    static const int month_days[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (month < 1 || month > 12 || day < 1 || day > month_days[month - 1] || (month == 2 && day == 29 && !leap)) {
+        return false;
+    }
+
+    // Optional time: "T" or space, then HH:MM or HH:MM:SS
+    int hour = 0, minute = 0, second_of_minute = 0;
+    bool has_time = pos < text.size();
+    if (has_time) {
+        if (text[pos] != 'T' && text[pos] != ' ') {
+            return false;
+        }
+        pos++;
+        if (readNumber(text, pos, 2, &hour) != 2 || pos + 2 >= text.size() || text[pos + 2] != ':' ||
+            readNumber(text, pos + 3, 2, &minute) != 2) {
+            return false;
+        }
+        pos += 5;
+        if (pos < text.size()) {
+            if (text[pos] != ':' || readNumber(text, pos + 1, 2, &second_of_minute) != 2) {
+                return false;
+            }
+            pos += 3;
+        }
+        if (pos != text.size() || hour > 23 || minute > 59 || second_of_minute > 59) {
+            return false;
+        }
+    }
+
+    if (iso) {
+        char buffer[32];
+        int length = has_time
+            ? std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d %02d:%02d:%02d", year, month, day, hour, minute, second_of_minute)
+            : std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, day);
+        iso->assign(buffer, length);
+    }
+    return true;
+}
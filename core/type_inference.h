@@ -0,0 +1,74 @@
+// Type inference - column types from a reservoir sample of ingested rows
+#pragma once
+#include "statement_cache.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Type Inference - decides column types for text imports (CSV)
+ * Every row is offered; a uniform reservoir of sample_rows is kept
+ * (Algorithm R), so a column that only turns non-numeric late in a file
+ * is as likely to be caught as one that does so early, at fixed memory.
+ *
+ * A column is INTEGER when every non-empty sampled value is a 64-bit
+ * integer without a leading zero (zip codes, account numbers stay TEXT),
+ * REAL when every one is a number, DATE when every one is a date or date
+ * and time in one consistent layout, and otherwise TEXT. Dates with the
+ * year last are read month-first (3/31/2024) when every sampled one
+ * allows it and day-first otherwise; dotted ones (01.02.2024) are always
+ * day-first. TEXT columns with few distinct values are reported as
+ * categories.
+ *
+ * convert() applies the decision while the file is loaded: numbers are
+ * bound as numbers, dates as ISO 8601 text ("2024-03-31 14:05:00"),
+ * empty fields in typed columns as NULL. A value the sample did not
+ * foresee is kept verbatim as text rather than dropped.
+ */
+class TypeInference {
+public:
+    enum class Type { Integer, Real, Date, Text, Category };
+    enum class DateOrder { YMD, MDY, DMY };
+
+    struct Column {
+        std::string name;
+        Type type = Type::Text;
+        DateOrder date_order = DateOrder::YMD;
+        size_t samples = 0;   // non-empty sampled values
+        size_t empty = 0;     // empty sampled values
+        size_t distinct = 0;  // distinct non-empty sampled values
+    };
+
+    struct Options {
+        size_t sample_rows = 10000;
+        size_t category_max = 1000;  // most distinct values a category may have
+        uint64_t seed = 0x5eed;
+    };
+
+    explicit TypeInference(std::vector<std::string> columns);
+    TypeInference(std::vector<std::string> columns, const Options& options);
+
+    void offer(const std::string_view* fields, size_t count);
+    size_t rowsOffered() const { return offered_; }
+
+    std::vector<Column> infer() const;
+
+    static const char* sqlType(Type type);   // column declaration: INTEGER, REAL, DATE, TEXT
+    static const char* typeName(Type type);  // as reported: adds CATEGORY
+
+    // Converts one field of a column into the value to bind; reuses out's string storage
+    static void convert(const Column& column, std::string_view field, SqlValue& out);
+
+    // Parses a date or date-time in the given layout into ISO 8601 text
+    static bool parseDate(std::string_view text, DateOrder order, std::string* iso);
+
+private:
+    std::vector<std::string> columns_;
+    Options options_;
+    std::vector<std::vector<std::string>> sample_;
+    std::mt19937_64 random_;
+    size_t offered_ = 0;
+};
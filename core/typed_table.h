@@ -0,0 +1,278 @@
+// Typed tables - compile-time table descriptors mapping rows to structs
+#pragma once
+#include "database.h"
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+/**
+ * Typed Table - statements and row mapping generated from a descriptor
+ * A record type is described once, as a constexpr tuple of (column name,
+ * member pointer) pairs in a TableDescriptor specialisation:
+ *
+ *     template <> struct TableDescriptor<ClientRecord> {
+ *         static constexpr const char* table = "clients";
+ *         static constexpr const char* touch = "updated_at";  // or nullptr
+ *         static constexpr auto columns = std::make_tuple(
+ *             column("name", &ClientRecord::name), ...);
+ *     };
+ *
+ * TypedTable<Record> then builds its INSERT/SELECT/UPDATE text once per
+ * process and binds and reads members by position - no per-call string
+ * formatting and no name lookups. Every record has an `int64_t id` member
+ * for the INTEGER PRIMARY KEY, which is not listed among the columns.
+ *
+ * Member types: int64_t, double, std::string, or std::optional of those
+ * for nullable columns. A column may carry an SQL fallback expression that
+ * INSERT uses when the member is empty (column("hire_date", &E::hire_date,
+ * "DATE('now')")), for defaults the database has to compute.
+ *
+ * Free-form edits (field name -> text, as the modules' update calls
+ * receive them) go through assign(): only described columns are accepted
+ * and the text is parsed into the member's type, so names never reach the
+ * SQL and values are always bound. assign() also records the column in a
+ * ColumnSet, and update() given that set writes only those columns - a
+ * NULL the record cannot hold (a plain std::string or double member) is
+ * left alone rather than rewritten as "" or 0.
+ */
+template <typename Record, typename T>
+struct Column {
+    const char* name;
+    T Record::*member;
+    const char* fallback = nullptr;  // SQL used on INSERT when the value is NULL
+};
+
+template <typename Record, typename T>
+constexpr Column<Record, T> column(const char* name, T Record::*member, const char* fallback = nullptr) {
+    return {name, member, fallback};
+}
+
+template <typename Record>
+struct TableDescriptor;
+
+namespace typed_table_detail {
+
+inline bool bindField(PreparedStatement& stmt, int index, int64_t value) { return stmt.bind(index, value); }
+inline bool bindField(PreparedStatement& stmt, int index, double value) { return stmt.bind(index, value); }
+inline bool bindField(PreparedStatement& stmt, int index, const std::string& value) { return stmt.bind(index, value); }
+
+template <typename T>
+bool bindField(PreparedStatement& stmt, int index, const std::optional<T>& value) {
+    return value ? bindField(stmt, index, *value) : stmt.bindNull(index);
+}
+
+inline void readField(const RowView& row, int column, int64_t& out) { out = row.getInt64(column); }
+inline void readField(const RowView& row, int column, double& out) { out = row.getDouble(column); }
+inline void readField(const RowView& row, int column, std::string& out) { out.assign(row.getText(column)); }
+
+template <typename Number>
+bool parseNumber(std::string_view text, Number& out) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+inline bool parseField(std::string_view text, int64_t& out) { return parseNumber(text, out); }
+inline bool parseField(std::string_view text, double& out) { return parseNumber(text, out); }
+inline bool parseField(std::string_view text, std::string& out) {
+    out.assign(text);
+    return true;
+}
+
+// Empty text clears a nullable column
+template <typename T>
+bool parseField(std::string_view text, std::optional<T>& out) {
+    if (text.empty()) {
+        out.reset();
+        return true;
+    }
+    T value{};
+    if (!parseField(text, value)) {
+        return false;
+    }
+    out = std::move(value);
+    return true;
+}
+
+template <typename T>
+void readField(const RowView& row, int column, std::optional<T>& out) {
+    if (row.isNull(column)) {
+        out.reset();
+        return;
+    }
+    T value{};
+    readField(row, column, value);
+    out = std::move(value);
+}
+
+template <typename Tuple, typename Fn, size_t... I>
+void forEachColumn(const Tuple& columns, Fn&& fn, std::index_sequence<I...>) {
+    (fn(std::get<I>(columns), static_cast<int>(I)), ...);
+}
+
+template <typename Record, typename Fn>
+void forEachColumn(Fn&& fn) {
+    constexpr auto& columns = TableDescriptor<Record>::columns;
+    forEachColumn(columns, std::forward<Fn>(fn),
+                  std::make_index_sequence<std::tuple_size_v<std::decay_t<decltype(columns)>>>());
+}
+
+} // namespace typed_table_detail
+
+template <typename Record>
+class TypedTable {
+public:
+    using Descriptor = TableDescriptor<Record>;
+    using ColumnSet = uint64_t;  // bit i = the descriptor's column i
+
+    // Inserts every described column; record.id receives the new rowid
+    static bool insert(Database* db, Record& record) {
+        PreparedStatement stmt = db->prepare(insertSql());
+        if (!stmt || !bindColumns(stmt, record, 1) || !stmt.execute()) {
+            return false;
+        }
+        record.id = stmt.lastInsertRowId();
+        return true;
+    }
+
+    static std::optional<Record> find(Database* db, int64_t id) {
+        static const std::string sql = selectSql() + " WHERE id = ?1;";
+        PreparedStatement stmt = db->prepareRead(sql);
+        if (!stmt || !stmt.bind(1, id) || !stmt.step()) {
+            return std::nullopt;
+        }
+        return fromRow(RowView(&stmt));
+    }
+
+    // Writes the given columns (all by default) of the row with record.id
+    static bool update(Database* db, const Record& record, ColumnSet columns = allColumns()) {
+        columns &= allColumns();
+        PreparedStatement stmt = db->prepare(columns == allColumns() ? updateSql() : updateSql(columns));
+        int next = 1;
+        bool ok = static_cast<bool>(stmt);
+        typed_table_detail::forEachColumn<Record>([&](const auto& column, int i) {
+            if (columns & (ColumnSet{1} << i)) {
+                ok = ok && typed_table_detail::bindField(stmt, next++, record.*(column.member));
+            }
+        });
+        if (!ok || !stmt.bind(next, record.id) || !stmt.execute()) {
+            return false;
+        }
+        return stmt.changes() == 1;
+    }
+
+    static bool remove(Database* db, int64_t id) {
+        static const std::string sql = std::string("DELETE FROM ") + Descriptor::table + " WHERE id = ?1;";
+        PreparedStatement stmt = db->prepare(sql);
+        return stmt && stmt.bind(1, id) && stmt.execute() && stmt.changes() == 1;
+    }
+
+    // Sets the named column from text; false for a column the descriptor
+    // does not list or text that does not parse as the member's type
+    static bool assign(Record& record, std::string_view name, std::string_view text,
+                       ColumnSet* assigned = nullptr) {
+        bool known = false, ok = false;
+        typed_table_detail::forEachColumn<Record>([&](const auto& column, int i) {
+            if (!known && name == column.name) {
+                known = true;
+                ok = typed_table_detail::parseField(text, record.*(column.member));
+                if (ok && assigned) {
+                    *assigned |= ColumnSet{1} << i;
+                }
+            }
+        });
+        return known && ok;
+    }
+
+    // Streams the whole table in id order; the visitor returns false to stop
+    template <typename Visitor>
+    static bool forEach(Database* db, Visitor&& visitor) {
+        static const std::string sql = selectSql() + " ORDER BY id;";
+        PreparedStatement stmt = db->prepareRead(sql);
+        if (!stmt) {
+            return false;
+        }
+        return Database::forEachRow(stmt, [&visitor](const RowView& row) { return visitor(fromRow(row)); });
+    }
+
+    // Columns in SELECT order: id first, then the descriptor's columns
+    static Record fromRow(const RowView& row) {
+        Record record{};
+        record.id = row.getInt64(0);
+        typed_table_detail::forEachColumn<Record>([&](const auto& column, int i) {
+            typed_table_detail::readField(row, i + 1, record.*(column.member));
+        });
+        return record;
+    }
+
+    static const std::string& insertSql() {
+        static const std::string sql = [] {
+            std::string names, params;
+            typed_table_detail::forEachColumn<Record>([&](const auto& column, int i) {
+                std::string param = "?" + std::to_string(i + 1);
+                names += (i ? ", " : "") + std::string(column.name);
+                params += (i ? ", " : "") +
+                          (column.fallback ? "COALESCE(" + param + ", " + column.fallback + ")" : param);
+            });
+            return std::string("INSERT INTO ") + Descriptor::table + " (" + names + ") VALUES (" + params + ");";
+        }();
+        return sql;
+    }
+
+    static const std::string& selectSql() {
+        static const std::string sql = [] {
+            std::string names = "id";
+            typed_table_detail::forEachColumn<Record>([&](const auto& column, int) {
+                names += ", " + std::string(column.name);
+            });
+            return "SELECT " + names + " FROM " + Descriptor::table;
+        }();
+        return sql;
+    }
+
+    static const std::string& updateSql() {
+        static const std::string sql = updateSql(allColumns());
+        return sql;
+    }
+
+    // Parameters follow the chosen columns in order, then the id
+    static std::string updateSql(ColumnSet columns) {
+        std::string assignments;
+        int next = 1;
+        typed_table_detail::forEachColumn<Record>([&](const auto& column, int i) {
+            if (columns & (ColumnSet{1} << i)) {
+                assignments += (next > 1 ? ", " : "") + std::string(column.name) + " = ?" + std::to_string(next);
+                next++;
+            }
+        });
+        if (Descriptor::touch) {
+            assignments += std::string(assignments.empty() ? "" : ", ") + Descriptor::touch + " = CURRENT_TIMESTAMP";
+        }
+        if (assignments.empty()) {
+            assignments = "id = id";  // nothing to write; still reports whether the row exists
+        }
+        return std::string("UPDATE ") + Descriptor::table + " SET " + assignments +
+               " WHERE id = ?" + std::to_string(next) + ";";
+    }
+
+    static constexpr int columnCount() {
+        return static_cast<int>(std::tuple_size_v<std::decay_t<decltype(Descriptor::columns)>>);
+    }
+
+    static constexpr ColumnSet allColumns() {
+        static_assert(columnCount() < 64, "ColumnSet holds at most 63 columns");
+        return (ColumnSet{1} << columnCount()) - 1;
+    }
+
+private:
+    static bool bindColumns(PreparedStatement& stmt, const Record& record, int first) {
+        bool ok = true;
+        typed_table_detail::forEachColumn<Record>([&](const auto& column, int i) {
+            ok = ok && typed_table_detail::bindField(stmt, first + i, record.*(column.member));
+        });
+        return ok;
+    }
+};
@@ -0,0 +1,180 @@
+// Write queue for Riley Corpbrain - batches queued writes into one transaction
+#include "write_queue.h"
+#include "database.h"
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+WriteQueue::WriteQueue(Database* db, const Options& options)
+    : db_(db), options_(options) {
+    options_.max_batch_size = std::max<size_t>(options_.max_batch_size, 1);
+    options_.capacity = std::max(options_.capacity, options_.max_batch_size);
+    worker_ = std::thread(&WriteQueue::run, this);
+}
+
+WriteQueue::~WriteQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    not_empty_.notify_one();
+    worker_.join();
+}
+
+std::future<bool> WriteQueue::submit(std::string sql, std::vector<SqlValue> params, uint64_t* sequence) {
+    Request request;
+    request.sql = std::move(sql);
+    request.params = std::move(params);
+    std::future<bool> result = request.done.get_future();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return queue_.size() < options_.capacity; });
+
+    request.sequence = ++next_sequence_;
+    request.enqueued = std::chrono::steady_clock::now();
+    if (sequence) {
+        *sequence = request.sequence;
+    }
+    queue_.push_back(std::move(request));
+
+    // The writer only needs waking for the first write of a batch (to start
+    // the latency clock) and when a full batch is ready
+    size_t queued = queue_.size();
+    lock.unlock();
+    if (queued == 1 || queued >= options_.max_batch_size) {
+        not_empty_.notify_one();
+    }
+
+    return result;
+}
+
+void WriteQueue::waitFor(uint64_t sequence) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    settled_.wait(lock, [this, sequence] { return settled_sequence_ >= sequence; });
+}
+
+void WriteQueue::flush() {
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = next_sequence_;
+    }
+    waitFor(sequence);
+}
+
+size_t WriteQueue::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(next_sequence_ - settled_sequence_);
+}
+
+uint64_t WriteQueue::batchesCommitted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_committed_;
+}
+
+uint64_t WriteQueue::writesCommitted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writes_committed_;
+}
+
+uint64_t WriteQueue::writesFailed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return writes_failed_;
+}
+
+void WriteQueue::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        not_empty_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            break;  // stopping with nothing left to commit
+        }
+
+        // Give the batch until its oldest write hits max_latency to fill up
+        auto deadline = queue_.front().enqueued + options_.max_latency;
+        not_empty_.wait_until(lock, deadline, [this] {
+            return stopping_ || queue_.size() >= options_.max_batch_size;
+        });
+
+        size_t count = std::min(queue_.size(), options_.max_batch_size);
+        std::vector<Request> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        not_full_.notify_all();
+
+        lock.unlock();
+        commitBatch(batch);
+        lock.lock();
+
+        settled_sequence_ = batch.back().sequence;
+        settled_.notify_all();
+    }
+}
+
+void WriteQueue::commitBatch(std::vector<Request>& batch) {
+    std::vector<bool> applied(batch.size(), false);
+    bool committed = false;
+
+    if (db_->beginTransaction()) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            applied[i] = applyWrite(batch[i]);
+        }
+
+        committed = db_->commitTransaction();
+        if (!committed) {
+            db_->rollbackTransaction();
+        }
+    }
+
+    if (!committed) {
+        std::cerr << "❌ Write batch of " << batch.size() << " failed to commit" << std::endl;
+    }
+
+    uint64_t succeeded = 0;
+    for (size_t i = 0; i < batch.size(); i++) {
+        bool durable = committed && applied[i];
+        if (durable) {
+            succeeded++;
+        }
+        batch[i].done.set_value(durable);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (committed) {
+        batches_committed_++;
+    }
+    writes_committed_ += succeeded;
+    writes_failed_ += batch.size() - succeeded;
+}
+
+// Run one write inside its own savepoint so a failure only undoes itself
+bool WriteQueue::applyWrite(Request& request) {
+    if (!db_->execute("SAVEPOINT queued_write;")) {
+        return false;
+    }
+
+    bool ok;
+    {
+        PreparedStatement stmt = db_->prepare(request.sql);
+        ok = stmt.valid();
+
+        for (size_t i = 0; ok && i < request.params.size(); i++) {
+            ok = stmt.bindValue(static_cast<int>(i + 1), request.params[i]);
+        }
+        ok = ok && stmt.execute();
+
+        if (!ok && stmt) {
+            std::cerr << "❌ Queued write failed: " << stmt.errorMessage() << std::endl;
+        }
+    }
+
+    if (!ok) {
+        db_->execute("ROLLBACK TO queued_write;");
+    }
+    db_->execute("RELEASE queued_write;");
+    return ok;
+}
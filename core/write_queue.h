@@ -0,0 +1,84 @@
+// Write queue - group commit for high-rate writes
+#pragma once
+#include "statement_cache.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Database;
+
+/**
+ * Write Queue - bounded multi-producer queue drained by one writer thread
+ * Pending writes are grouped into a single transaction, so a burst of
+ * inserts pays for one WAL commit instead of one per statement. A batch is
+ * committed once it reaches max_batch_size or its oldest write has waited
+ * max_latency. Each write runs inside its own savepoint: a failing statement
+ * is rolled back alone and the rest of the batch still commits.
+ */
+class WriteQueue {
+public:
+    struct Options {
+        size_t max_batch_size = 256;
+        std::chrono::milliseconds max_latency{10};
+        size_t capacity = 8192;  // producers block while the queue is full
+    };
+
+    WriteQueue(Database* db, const Options& options);
+    ~WriteQueue();  // commits everything still queued, then stops the thread
+
+    WriteQueue(const WriteQueue&) = delete;
+    WriteQueue& operator=(const WriteQueue&) = delete;
+
+    // The future resolves once the batch holding this write has committed:
+    // true if the write is durable, false if it or its batch failed.
+    // sequence, when given, receives the write's position in the queue.
+    std::future<bool> submit(std::string sql, std::vector<SqlValue> params,
+                             uint64_t* sequence = nullptr);
+
+    // Block until every write up to and including sequence has settled
+    void waitFor(uint64_t sequence);
+    void flush();  // waits for everything submitted so far
+
+    size_t pending() const;
+    uint64_t batchesCommitted() const;
+    uint64_t writesCommitted() const;
+    uint64_t writesFailed() const;
+
+private:
+    struct Request {
+        std::string sql;
+        std::vector<SqlValue> params;
+        std::promise<bool> done;
+        uint64_t sequence = 0;
+        std::chrono::steady_clock::time_point enqueued;
+    };
+
+    void run();
+    void commitBatch(std::vector<Request>& batch);
+    bool applyWrite(Request& request);
+
+    Database* db_;
+    Options options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::condition_variable settled_;
+    std::deque<Request> queue_;
+    bool stopping_ = false;
+
+    uint64_t next_sequence_ = 0;
+    uint64_t settled_sequence_ = 0;
+    uint64_t batches_committed_ = 0;
+    uint64_t writes_committed_ = 0;
+    uint64_t writes_failed_ = 0;
+
+    std::thread worker_;
+};
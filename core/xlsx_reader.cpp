@@ -0,0 +1,768 @@
+// XLSX reader for Riley Corpbrain - SAX pass over inflated worksheet XML
+#include "xlsx_reader.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+
+namespace {
+
+struct XmlAttribute {
+    std::string_view name;   // local name, namespace prefix dropped
+    std::string_view value;  // raw, entities not yet decoded
+};
+
+/**
+ * Callbacks for one XML part; any returning false stops the pass.
+ * Text is raw; cdata is true when it came from a CDATA section.
+ */
+struct XmlCallbacks {
+    std::function<bool(std::string_view, const std::vector<XmlAttribute>&)> start;
+    std::function<bool(std::string_view)> end;
+    std::function<bool(std::string_view, bool)> text;
+};
+
+std::string_view localName(std::string_view name) {
+    size_t colon = name.find(':');
+    return colon == std::string_view::npos ? name : name.substr(colon + 1);
+}
+
+std::string_view attribute(const std::vector<XmlAttribute>& attributes, std::string_view name) {
+    for (const auto& attr : attributes) {
+        if (attr.name == name) {
+            return attr.value;
+        }
+    }
+    return {};
+}
+
+void appendUtf8(std::string& out, uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+// Appends raw XML text with the five named entities and &#...; decoded
+void appendDecoded(std::string& out, std::string_view raw) {
+    while (!raw.empty()) {
+        size_t amp = raw.find('&');
+        out.append(raw.data(), std::min(amp, raw.size()));
+        if (amp == std::string_view::npos) {
+            return;
+        }
+        raw.remove_prefix(amp);
+
+        size_t semi = raw.find(';');
+        std::string_view entity = raw.substr(1, semi == std::string_view::npos ? 0 : semi - 1);
+        uint32_t code = 0;
+        bool known = true;
+        if (entity == "amp") code = '&';
+        else if (entity == "lt") code = '<';
+        else if (entity == "gt") code = '>';
+        else if (entity == "quot") code = '"';
+        else if (entity == "apos") code = '\'';
+        else if (entity.size() > 1 && entity[0] == '#') {
+            bool hex = entity[1] == 'x' || entity[1] == 'X';
+            std::string_view digits = entity.substr(hex ? 2 : 1);
+            auto result = std::from_chars(digits.data(), digits.data() + digits.size(), code, hex ? 16 : 10);
+            known = result.ec == std::errc() && result.ptr == digits.data() + digits.size() && code <= 0x10FFFF;
+        } else {
+            known = false;
+        }
+
+        if (!known) {
+            out += '&';
+            raw.remove_prefix(1);
+            continue;
+        }
+        appendUtf8(out, code);
+        raw.remove_prefix(semi + 1);
+    }
+}
+
+// OOXML escapes characters XML cannot carry as _xHHHH_ ("_x000D_" for CR)
+void unescapeOoxml(std::string& text) {
+    size_t at = text.find("_x");
+    if (at == std::string::npos) {
+        return;
+    }
+
+    std::string out(text, 0, at);
+    while (at < text.size()) {
+        uint32_t code = 0;
+        if (text.compare(at, 2, "_x") == 0 && at + 7 <= text.size() && text[at + 6] == '_') {
+            auto result = std::from_chars(text.data() + at + 2, text.data() + at + 6, code, 16);
+            if (result.ec == std::errc() && result.ptr == text.data() + at + 6) {
+                appendUtf8(out, code);
+                at += 7;
+                continue;
+            }
+        }
+        out += text[at++];
+    }
+    text.swap(out);
+}
+
+/**
+ * Incremental XML tokenizer
+ * Input arrives in arbitrary pieces; whatever construct is cut off at the
+ * end of a piece is kept and completed by the next one. Enough XML for
+ * OOXML parts: elements, attributes, text, CDATA; comments, processing
+ * instructions and DOCTYPE are skipped. No validation.
+ */
+class XmlStream {
+public:
+    explicit XmlStream(const XmlCallbacks& callbacks) : callbacks_(callbacks) {}
+
+    bool feed(const char* data, size_t size) {
+        pending_.append(data, size);
+        const char* begin = pending_.data();
+        const char* end = begin + pending_.size();
+        const char* p = begin;
+
+        while (p < end) {
+            const char* next = step(p, end);
+            if (!next) {
+                return false;
+            }
+            if (next == p) {
+                break;  // incomplete - wait for more input
+            }
+            p = next;
+        }
+
+        pending_.erase(0, p - begin);
+        return true;
+    }
+
+    bool finish() const {
+        return pending_.find_first_not_of(" \t\r\n") == std::string::npos;
+    }
+
+private:
+    // Handles one construct at p; returns p when it is incomplete, null to stop
+    const char* step(const char* p, const char* end) {
+        if (*p != '<') {
+            const char* lt = static_cast<const char*>(std::memchr(p, '<', end - p));
+            if (!lt) {
+                return p;
+            }
+            if (callbacks_.text && !callbacks_.text(std::string_view(p, lt - p), false)) {
+                return nullptr;
+            }
+            return lt;
+        }
+
+        std::string_view rest(p, end - p);
+        if (rest.size() < 2) {
+            return p;
+        }
+        if (rest[1] == '?') {
+            return skipPast(p, end, "?>");
+        }
+        if (rest[1] == '!') {
+            if (rest.compare(0, 9, "<![CDATA[") == 0) {
+                size_t close = rest.find("]]>", 9);
+                if (close == std::string_view::npos) {
+                    return p;
+                }
+                if (callbacks_.text && !callbacks_.text(rest.substr(9, close - 9), true)) {
+                    return nullptr;
+                }
+                return p + close + 3;
+            }
+            if (rest.size() < 9) {
+                return p;  // cannot tell a CDATA section yet
+            }
+            return rest.compare(0, 4, "<!--") == 0 ? skipPast(p, end, "-->") : skipPast(p, end, ">");
+        }
+
+        // Element tag; '>' inside a quoted attribute value does not close it
+        const char* q = p + 1;
+        char quote = 0;
+        for (; q < end; q++) {
+            if (quote) {
+                if (*q == quote) {
+                    quote = 0;
+                }
+            } else if (*q == '"' || *q == '\'') {
+                quote = *q;
+            } else if (*q == '>') {
+                break;
+            }
+        }
+        if (q == end) {
+            return p;
+        }
+        return tag(std::string_view(p + 1, q - p - 1)) ? q + 1 : nullptr;
+    }
+
+    static const char* skipPast(const char* p, const char* end, std::string_view marker) {
+        std::string_view rest(p, end - p);
+        size_t at = rest.find(marker, 2);
+        return at == std::string_view::npos ? p : p + at + marker.size();
+    }
+
+    bool tag(std::string_view body) {
+        if (!body.empty() && body[0] == '/') {
+            body.remove_prefix(1);
+            size_t stop = body.find_first_of(" \t\r\n");
+            return !callbacks_.end || callbacks_.end(localName(body.substr(0, stop)));
+        }
+
+        bool self_closing = !body.empty() && body.back() == '/';
+        if (self_closing) {
+            body.remove_suffix(1);
+        }
+
+        size_t stop = std::min(body.find_first_of(" \t\r\n"), body.size());
+        std::string_view name = localName(body.substr(0, stop));
+
+        attributes_.clear();
+        size_t i = stop;
+        while (i < body.size()) {
+            size_t name_start = body.find_first_not_of(" \t\r\n", i);
+            if (name_start == std::string_view::npos) {
+                break;
+            }
+            size_t eq = body.find('=', name_start);
+            if (eq == std::string_view::npos) {
+                break;
+            }
+            size_t open = body.find_first_of("\"'", eq);
+            if (open == std::string_view::npos) {
+                break;
+            }
+            size_t close = body.find(body[open], open + 1);
+            if (close == std::string_view::npos) {
+                break;
+            }
+
+            std::string_view attr_name = body.substr(name_start, eq - name_start);
+            attr_name = attr_name.substr(0, attr_name.find_last_not_of(" \t\r\n") + 1);
+            attributes_.push_back({localName(attr_name), body.substr(open + 1, close - open - 1)});
+            i = close + 1;
+        }
+
+        if (callbacks_.start && !callbacks_.start(name, attributes_)) {
+            return false;
+        }
+        return !self_closing || !callbacks_.end || callbacks_.end(name);
+    }
+
+    const XmlCallbacks& callbacks_;
+    std::string pending_;
+    std::vector<XmlAttribute> attributes_;
+};
+
+// "AB12" -> 27 (zero-based column); -1 when there are no letters
+int columnIndex(std::string_view reference) {
+    int column = 0;
+    size_t i = 0;
+    for (; i < reference.size() && std::isalpha(static_cast<unsigned char>(reference[i])); i++) {
+        column = column * 26 + (std::toupper(static_cast<unsigned char>(reference[i])) - 'A' + 1);
+        if (column > 16384) {
+            return -1;
+        }
+    }
+    return i ? column - 1 : -1;
+}
+
+bool isDateFormat(int id, const std::string& code) {
+    if ((id >= 14 && id <= 22) || (id >= 27 && id <= 36) || (id >= 45 && id <= 47) || (id >= 50 && id <= 58)) {
+        return true;
+    }
+
+    // Custom format: date/time letters outside quoted literals, [colour] tags and escapes
+    bool quoted = false;
+    for (size_t i = 0; i < code.size(); i++) {
+        char c = code[i];
+        if (quoted) {
+            quoted = c != '"';
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == '\\' || c == '_' || c == '*') {
+            i++;
+        } else if (c == '[') {
+            i = std::min(code.find(']', i), code.size());
+        } else if (std::strchr("dmyhsDMYHS", c)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Excel serial day number -> ISO text; days count from 1899-12-30 (or 1904-01-01).
+// Empty outside Excel's own range, 0 to 9999-12-31, so the caller keeps the number
+std::string formatSerialDate(double serial, bool date1904) {
+    if (!(serial >= 0 && serial < 2958466)) {
+        return std::string();
+    }
+    double days = std::floor(serial);
+    long long seconds = std::llround((serial - days) * 86400.0);
+    if (seconds >= 86400) {
+        days += 1;
+        seconds -= 86400;
+    }
+
+    long long day_number = static_cast<long long>(days);
+    if (!date1904 && day_number < 61) {
+        day_number++;  // Excel counts a 29 February 1900 that never was
+    }
+    // Days since 1970-01-01, then Hinnant's civil-from-days
+    long long z = day_number + (date1904 ? -24107 : -25569) + 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    long long day = doy - (153 * mp + 2) / 5 + 1;
+    long long month = mp < 10 ? mp + 3 : mp - 9;
+    int year = static_cast<int>(yoe + era * 400 + (month <= 2));
+
+    int hours = static_cast<int>(seconds / 3600);
+    int minutes = static_cast<int>(seconds / 60 % 60);
+    int secs = static_cast<int>(seconds % 60);
+    char text[32];
+    if (serial < 1) {
+        std::snprintf(text, sizeof(text), "%02d:%02d:%02d", hours, minutes, secs);
+    } else if (seconds == 0) {
+        std::snprintf(text, sizeof(text), "%04d-%02d-%02d", year, static_cast<int>(month), static_cast<int>(day));
+    } else {
+        std::snprintf(text, sizeof(text), "%04d-%02d-%02d %02d:%02d:%02d", year, static_cast<int>(month),
+                      static_cast<int>(day), hours, minutes, secs);
+    }
+    return text;
+}
+
+std::string directoryOf(const std::string& part) {
+    size_t slash = part.rfind('/');
+    return slash == std::string::npos ? std::string() : part.substr(0, slash + 1);
+}
+
+// Relationship targets are relative to the source part's folder, or absolute from the root
+std::string resolveTarget(const std::string& base, std::string_view target) {
+    std::string path = target.size() && target[0] == '/' ? std::string(target.substr(1)) : base + std::string(target);
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t slash = std::min(path.find('/', start), path.size());
+        std::string part = path.substr(start, slash - start);
+        if (part == "..") {
+            if (!parts.empty()) {
+                parts.pop_back();
+            }
+        } else if (!part.empty() && part != ".") {
+            parts.push_back(part);
+        }
+        start = slash + 1;
+    }
+
+    std::string resolved;
+    for (const auto& part : parts) {
+        resolved += (resolved.empty() ? "" : "/") + part;
+    }
+    return resolved;
+}
+
+bool parsePart(ZipArchive& archive, const std::string& part, const XmlCallbacks& callbacks, std::string& error) {
+    XmlStream stream(callbacks);
+    bool ok = archive.extract(part, [&stream](const char* data, size_t size) { return stream.feed(data, size); });
+    if (!ok) {
+        error = archive.error();
+        return false;
+    }
+    if (!stream.finish()) {
+        error = "truncated XML in " + part;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+XlsxReader::XlsxReader() : XlsxReader(Options()) {}
+
+XlsxReader::XlsxReader(const Options& options) : options_(options) {}
+
+bool XlsxReader::fail(const std::string& message) {
+    error_ = message;
+    return false;
+}
+
+bool XlsxReader::open(const std::string& path) {
+    sheet_names_.clear();
+    header_.clear();
+    strings_.clear();
+    string_offsets_.clear();
+    date_styles_.clear();
+    date1904_ = false;
+    error_.clear();
+
+    if (!archive_.open(path)) {
+        return fail(archive_.error());
+    }
+    if (!loadWorkbook()) {
+        return false;
+    }
+
+    // The header is the first non-empty row; stop the pass right there
+    std::vector<SqlValue> first;
+    if (!streamSheet([&first](std::vector<SqlValue>& row) {
+            first.swap(row);
+            return false;
+        }) && !error_.empty()) {
+        return false;
+    }
+    if (first.empty()) {
+        return fail("no header row in sheet " + sheet_part_);
+    }
+
+    std::set<std::string> seen;
+    for (size_t i = 0; i < first.size(); i++) {
+        std::string name;
+        if (auto* text = std::get_if<std::string>(&first[i])) {
+            name = *text;
+        } else if (auto* integer = std::get_if<int64_t>(&first[i])) {
+            name = std::to_string(*integer);
+        } else if (auto* real = std::get_if<double>(&first[i])) {
+            char buffer[32];
+            name.assign(buffer, std::to_chars(buffer, buffer + sizeof(buffer), *real).ptr);
+        }
+        name.erase(0, name.find_first_not_of(" \t\r\n"));
+        name.erase(name.find_last_not_of(" \t\r\n") + 1);
+        if (name.empty()) {
+            name = "column_" + std::to_string(i + 1);
+        }
+
+        std::string unique = name;
+        for (int n = 2; seen.count(unique); n++) {
+            unique = name + "_" + std::to_string(n);
+        }
+        seen.insert(unique);
+        header_.push_back(unique);
+    }
+    return true;
+}
+
+bool XlsxReader::loadWorkbook() {
+    // Package relationships name the workbook part; Excel always uses xl/workbook.xml
+    std::string workbook = "xl/workbook.xml";
+    if (archive_.find("_rels/.rels")) {
+        XmlCallbacks rels;
+        rels.start = [&workbook](std::string_view name, const std::vector<XmlAttribute>& attrs) {
+            std::string_view type = attribute(attrs, "Type");
+            if (name == "Relationship" && type.size() >= 15 && type.substr(type.size() - 15) == "/officeDocument") {
+                workbook = resolveTarget("", attribute(attrs, "Target"));
+            }
+            return true;
+        };
+        if (!parsePart(archive_, "_rels/.rels", rels, error_)) {
+            return false;
+        }
+    }
+    if (!archive_.find(workbook)) {
+        return fail("not an XLSX workbook (no " + workbook + ")");
+    }
+
+    std::vector<std::pair<std::string, std::string>> sheets;  // name, relationship id
+    XmlCallbacks book;
+    book.start = [&](std::string_view name, const std::vector<XmlAttribute>& attrs) {
+        if (name == "sheet") {
+            std::string sheet_name;
+            appendDecoded(sheet_name, attribute(attrs, "name"));
+            sheets.emplace_back(sheet_name, std::string(attribute(attrs, "id")));
+            sheet_names_.push_back(sheet_name);
+        } else if (name == "workbookPr") {
+            std::string_view date1904 = attribute(attrs, "date1904");
+            date1904_ = date1904 == "1" || date1904 == "true";
+        }
+        return true;
+    };
+    if (!parsePart(archive_, workbook, book, error_)) {
+        return false;
+    }
+    if (sheets.empty()) {
+        return fail("workbook has no sheets");
+    }
+
+    std::string relationship = sheets.front().second;
+    if (!options_.sheet.empty()) {
+        auto it = std::find_if(sheets.begin(), sheets.end(), [this](const auto& sheet) { return sheet.first == options_.sheet; });
+        if (it == sheets.end()) {
+            return fail("no sheet named " + options_.sheet);
+        }
+        relationship = it->second;
+    }
+
+    std::string base = directoryOf(workbook);
+    std::string rels_part = base + "_rels/" + workbook.substr(base.size()) + ".rels";
+    std::string styles, shared_strings;
+    XmlCallbacks rels;
+    rels.start = [&](std::string_view name, const std::vector<XmlAttribute>& attrs) {
+        if (name != "Relationship") {
+            return true;
+        }
+        std::string_view type = attribute(attrs, "Type");
+        std::string target = resolveTarget(base, attribute(attrs, "Target"));
+        if (attribute(attrs, "Id") == relationship) {
+            sheet_part_ = target;
+        } else if (type.size() >= 7 && type.substr(type.size() - 7) == "/styles") {
+            styles = target;
+        } else if (type.size() >= 14 && type.substr(type.size() - 14) == "/sharedStrings") {
+            shared_strings = target;
+        }
+        return true;
+    };
+    if (!parsePart(archive_, rels_part, rels, error_)) {
+        return false;
+    }
+    if (sheet_part_.empty()) {
+        return fail("sheet relationship " + relationship + " not found");
+    }
+
+    return (styles.empty() || loadStyles(styles)) && (shared_strings.empty() || loadSharedStrings(shared_strings));
+}
+
+bool XlsxReader::loadStyles(const std::string& part) {
+    std::map<int, std::string> formats;
+    std::vector<int> cell_formats;
+    bool in_cell_xfs = false;
+
+    XmlCallbacks callbacks;
+    callbacks.start = [&](std::string_view name, const std::vector<XmlAttribute>& attrs) {
+        if (name == "numFmt") {
+            std::string code;
+            appendDecoded(code, attribute(attrs, "formatCode"));
+            formats[std::atoi(std::string(attribute(attrs, "numFmtId")).c_str())] = code;
+        } else if (name == "cellXfs") {
+            in_cell_xfs = true;
+        } else if (name == "xf" && in_cell_xfs) {
+            cell_formats.push_back(std::atoi(std::string(attribute(attrs, "numFmtId")).c_str()));
+        }
+        return true;
+    };
+    callbacks.end = [&](std::string_view name) {
+        if (name == "cellXfs") {
+            in_cell_xfs = false;
+        }
+        return true;
+    };
+    if (!parsePart(archive_, part, callbacks, error_)) {
+        return false;
+    }
+
+    for (int id : cell_formats) {
+        auto it = formats.find(id);
+        date_styles_.push_back(isDateFormat(id, it == formats.end() ? std::string() : it->second));
+    }
+    return true;
+}
+
+bool XlsxReader::loadSharedStrings(const std::string& part) {
+    // <si> holds one <t>, or rich-text runs <r><t/></r>; phonetic <rPh> hints are skipped
+    std::string current;
+    bool in_item = false, in_text = false;
+    int phonetic = 0;
+    string_offsets_.push_back(0);
+
+    XmlCallbacks callbacks;
+    callbacks.start = [&](std::string_view name, const std::vector<XmlAttribute>& attrs) {
+        if (name == "sst") {
+            size_t count = std::strtoul(std::string(attribute(attrs, "uniqueCount")).c_str(), nullptr, 10);
+            string_offsets_.reserve(std::min<size_t>(count, 1 << 24) + 1);
+        } else if (name == "si") {
+            in_item = true;
+            current.clear();
+        } else if (name == "rPh") {
+            phonetic++;
+        } else if (name == "t") {
+            in_text = in_item && !phonetic;
+        }
+        return true;
+    };
+    callbacks.end = [&](std::string_view name) {
+        if (name == "si") {
+            unescapeOoxml(current);
+            strings_ += current;
+            string_offsets_.push_back(strings_.size());
+            in_item = false;
+        } else if (name == "rPh") {
+            phonetic--;
+        } else if (name == "t") {
+            in_text = false;
+        }
+        return true;
+    };
+    callbacks.text = [&](std::string_view text, bool cdata) {
+        if (in_text) {
+            if (cdata) {
+                current.append(text.data(), text.size());
+            } else {
+                appendDecoded(current, text);
+            }
+        }
+        return true;
+    };
+    return parsePart(archive_, part, callbacks, error_);
+}
+
+bool XlsxReader::streamSheet(const std::function<bool(std::vector<SqlValue>&)>& on_row) {
+    std::vector<SqlValue> row;
+    bool row_has_value = false;
+    int next_column = 0;
+
+    // Current cell
+    int column = -1;
+    std::string type;
+    size_t style = 0;
+    std::string value;
+    bool in_value = false;  // <v>, or <t> inside an inline <is>
+    bool in_inline = false;
+    bool have_value = false;
+    bool stopped = false;
+
+    auto cellValue = [&]() -> SqlValue {
+        if (type == "s") {
+            size_t index = std::strtoul(value.c_str(), nullptr, 10);
+            if (index + 1 >= string_offsets_.size()) {
+                return nullptr;
+            }
+            return strings_.substr(string_offsets_[index], string_offsets_[index + 1] - string_offsets_[index]);
+        }
+        if (type == "inlineStr" || type == "str" || type == "e" || type == "d") {
+            unescapeOoxml(value);
+            return value;
+        }
+        if (type == "b") {
+            return int64_t{value == "1" || value == "true"};
+        }
+
+        size_t digits = value.find_first_not_of(" \t");
+        if (digits == std::string::npos) {
+            return nullptr;
+        }
+        double number;
+        auto result = std::from_chars(value.data() + digits, value.data() + value.size(), number);
+        if (result.ec != std::errc()) {
+            return value;
+        }
+        if (style < date_styles_.size() && date_styles_[style]) {
+            std::string date = formatSerialDate(number, date1904_);
+            if (!date.empty()) {
+                return date;
+            }
+        }
+        if (number == std::floor(number) && std::fabs(number) < 9007199254740992.0) {
+            return static_cast<int64_t>(number);
+        }
+        return number;
+    };
+
+    XmlCallbacks callbacks;
+    callbacks.start = [&](std::string_view name, const std::vector<XmlAttribute>& attrs) {
+        if (name == "c") {
+            std::string_view reference = attribute(attrs, "r");
+            column = reference.empty() ? next_column : columnIndex(reference);
+            next_column = column + 1;
+            type.assign(attribute(attrs, "t"));
+            style = std::strtoul(std::string(attribute(attrs, "s")).c_str(), nullptr, 10);
+            value.clear();
+            have_value = false;
+        } else if (name == "v") {
+            in_value = true;
+            have_value = true;
+        } else if (name == "is") {
+            in_inline = true;
+            have_value = true;
+        } else if (name == "t" && in_inline) {
+            in_value = true;
+        } else if (name == "rPh") {
+            in_value = false;
+            in_inline = false;
+        } else if (name == "row") {
+            row.clear();
+            row_has_value = false;
+            next_column = 0;
+        }
+        return true;
+    };
+    callbacks.end = [&](std::string_view name) {
+        if (name == "v" || name == "t") {
+            in_value = false;
+        } else if (name == "is") {
+            in_inline = false;
+        } else if (name == "c") {
+            if (have_value && column >= 0) {
+                if (row.size() <= static_cast<size_t>(column)) {
+                    row.resize(column + 1, nullptr);
+                }
+                row[column] = cellValue();
+                row_has_value = true;
+            }
+        } else if (name == "row" && row_has_value) {
+            if (!on_row(row)) {
+                stopped = true;
+                return false;
+            }
+        }
+        return true;
+    };
+    callbacks.text = [&](std::string_view text, bool cdata) {
+        if (in_value) {
+            if (cdata) {
+                value.append(text.data(), text.size());
+            } else {
+                appendDecoded(value, text);
+            }
+        }
+        return true;
+    };
+
+    XmlStream stream(callbacks);
+    bool ok = archive_.extract(sheet_part_, [&stream](const char* data, size_t size) { return stream.feed(data, size); });
+    if (stopped) {
+        return false;
+    }
+    if (!ok) {
+        return fail(archive_.error().empty() ? "malformed XML in " + sheet_part_ : archive_.error());
+    }
+    if (!stream.finish()) {
+        return fail("truncated XML in " + sheet_part_);
+    }
+    return true;
+}
+
+bool XlsxReader::read(const std::function<bool(const std::vector<SqlValue>&)>& consumer) {
+    if (header_.empty()) {
+        error_ = "no XLSX sheet open";
+        return false;
+    }
+    error_.clear();
+
+    bool header_seen = false;
+    return streamSheet([&](std::vector<SqlValue>& row) {
+        if (!header_seen) {
+            header_seen = true;
+            return true;
+        }
+        return consumer(row);
+    });
+}
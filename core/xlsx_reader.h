@@ -0,0 +1,62 @@
+// XLSX reader - streaming worksheet rows out of an Excel workbook
+#pragma once
+#include "statement_cache.h"
+#include "zip_archive.h"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * XLSX Reader - rows of one worksheet without building a workbook DOM
+ * The sheet XML is inflated piece by piece and fed through a SAX pass;
+ * each <row> becomes a vector of values the moment it closes. Only the
+ * shared string table is held in memory (one arena plus offsets), since
+ * any cell may refer to any entry.
+ *
+ * Values keep their cell type: numbers as INTEGER or REAL, booleans as
+ * 0/1, strings and error codes (#N/A) as TEXT. Numbers in a date or time
+ * format come out as ISO text ("2024-03-31", "2024-03-31 14:05:00").
+ * The first non-empty row is the header; names are trimmed, blanks
+ * numbered and duplicates suffixed as for CSV.
+ */
+class XlsxReader {
+public:
+    struct Options {
+        std::string sheet;  // worksheet name, first sheet when empty
+    };
+
+    XlsxReader();
+    explicit XlsxReader(const Options& options);
+
+    bool open(const std::string& path);
+
+    const std::vector<std::string>& sheetNames() const { return sheet_names_; }
+    const std::vector<std::string>& header() const { return header_; }
+    size_t sharedStringCount() const { return string_offsets_.empty() ? 0 : string_offsets_.size() - 1; }
+
+    // Data rows below the header in sheet order; consumer returns false to stop
+    bool read(const std::function<bool(const std::vector<SqlValue>&)>& consumer);
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool loadWorkbook();
+    bool loadStyles(const std::string& part);
+    bool loadSharedStrings(const std::string& part);
+    bool streamSheet(const std::function<bool(std::vector<SqlValue>&)>& on_row);
+    bool fail(const std::string& message);
+
+    Options options_;
+    ZipArchive archive_;
+    std::string sheet_part_;
+    std::vector<std::string> sheet_names_;
+    std::vector<std::string> header_;
+
+    std::string strings_;                // shared strings, back to back
+    std::vector<size_t> string_offsets_;  // start of each string, plus an end marker
+    std::vector<bool> date_styles_;      // per cell format (s="n"): number is a date
+    bool date1904_ = false;
+
+    std::string error_;
+};
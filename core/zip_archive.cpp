@@ -0,0 +1,579 @@
+// Zip archive for Riley Corpbrain - central directory parsing and streaming inflate
+#include "zip_archive.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+uint16_t read16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read32(const uint8_t* p) {
+    return static_cast<uint32_t>(read16(p)) | (static_cast<uint32_t>(read16(p + 2)) << 16);
+}
+
+uint64_t read64(const uint8_t* p) {
+    return static_cast<uint64_t>(read32(p)) | (static_cast<uint64_t>(read32(p + 4)) << 32);
+}
+
+uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t size) {
+    static const auto table = [] {
+        std::array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+        return entries;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * Canonical Huffman code for one deflate alphabet
+ * Codes up to kFastBits long resolve with a single table lookup; longer
+ * ones are found by comparing against the first code of each length.
+ */
+struct Huffman {
+    static constexpr int kFastBits = 10;
+
+    uint16_t fast[1 << kFastBits];  // (length << 9) | symbol, 0 when the code is longer
+    uint16_t first_code[17];
+    uint16_t first_symbol[17];
+    uint32_t max_code[18];  // per length, left-aligned to 16 bits
+    uint8_t size[288];
+    uint16_t value[288];
+
+    bool build(const uint8_t* lengths, int count) {
+        int sizes[17] = {};
+        std::memset(fast, 0, sizeof(fast));
+        std::memset(size, 0, sizeof(size));
+        for (int i = 0; i < count; i++) {
+            sizes[lengths[i]]++;
+        }
+        sizes[0] = 0;
+        for (int i = 1; i < 16; i++) {
+            if (sizes[i] > (1 << i)) {
+                return false;
+            }
+        }
+
+        int next_code[16];
+        int code = 0, symbols = 0;
+        for (int i = 1; i < 16; i++) {
+            next_code[i] = code;
+            first_code[i] = static_cast<uint16_t>(code);
+            first_symbol[i] = static_cast<uint16_t>(symbols);
+            code += sizes[i];
+            if (sizes[i] && code - 1 >= (1 << i)) {
+                return false;  // over-subscribed
+            }
+            max_code[i] = static_cast<uint32_t>(code) << (16 - i);
+            code <<= 1;
+            symbols += sizes[i];
+        }
+        max_code[16] = 0x10000;
+
+        for (int i = 0; i < count; i++) {
+            int length = lengths[i];
+            if (!length) {
+                continue;
+            }
+            int slot = next_code[length] - first_code[length] + first_symbol[length];
+            size[slot] = static_cast<uint8_t>(length);
+            value[slot] = static_cast<uint16_t>(i);
+            if (length <= kFastBits) {
+                for (int j = reverse(next_code[length], length); j < (1 << kFastBits); j += 1 << length) {
+                    fast[j] = static_cast<uint16_t>((length << 9) | i);
+                }
+            }
+            next_code[length]++;
+        }
+        return true;
+    }
+
+    static int reverse(int code, int bits) {
+        int reversed = 0;
+        for (int i = 0; i < bits; i++) {
+            reversed = (reversed << 1) | ((code >> i) & 1);
+        }
+        return reversed;
+    }
+};
+
+const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385,
+                                    513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+/**
+ * Raw deflate (RFC 1951) decoder over an in-memory input
+ * Output goes through a buffer holding the 32 KB back-reference window
+ * plus one block; each time it fills, the new bytes are handed to the
+ * consumer and the window slides to the front.
+ */
+class Inflater {
+public:
+    Inflater(const uint8_t* data, size_t size, const std::function<bool(const char*, size_t)>& consumer)
+        : in_(data), end_(data + size), consumer_(consumer), out_(kWindow + kBlock + 258) {}
+
+    bool run() {
+        bool last;
+        do {
+            last = take(1) != 0;
+            uint32_t type = take(2);
+            bool ok = type == 0 ? storedBlock()
+                    : type == 1 ? fixedBlock()
+                    : type == 2 ? dynamicBlock()
+                                : fail("invalid block type");
+            if (!ok) {
+                return false;
+            }
+            if (overrun_ > 8) {
+                return fail("truncated deflate stream");
+            }
+        } while (!last);
+        return deliver();
+    }
+
+    bool stopped() const { return stopped_; }
+    const char* error() const { return error_; }
+    uint32_t crc() const { return crc_; }
+    uint64_t size() const { return total_; }
+
+private:
+    static constexpr size_t kWindow = 32768;
+    static constexpr size_t kBlock = 256 * 1024;
+
+    void fill() {
+        while (count_ <= 56) {
+            uint64_t byte = 0;
+            if (in_ < end_) {
+                byte = *in_++;
+            } else {
+                overrun_++;
+            }
+            bits_ |= byte << count_;
+            count_ += 8;
+        }
+    }
+
+    uint32_t take(int n) {
+        if (count_ < n) {
+            fill();
+        }
+        uint32_t value = static_cast<uint32_t>(bits_ & ((uint64_t{1} << n) - 1));
+        bits_ >>= n;
+        count_ -= n;
+        return value;
+    }
+
+    int decode(const Huffman& h) {
+        if (count_ < 16) {
+            fill();
+        }
+        uint16_t fast = h.fast[bits_ & ((1 << Huffman::kFastBits) - 1)];
+        if (fast) {
+            int length = fast >> 9;
+            bits_ >>= length;
+            count_ -= length;
+            return fast & 511;
+        }
+
+        uint32_t code = static_cast<uint32_t>(Huffman::reverse(static_cast<int>(bits_ & 0xFFFF), 16));
+        int length = Huffman::kFastBits + 1;
+        while (length < 16 && code >= h.max_code[length]) {
+            length++;
+        }
+        if (length >= 16) {
+            return -1;
+        }
+        int slot = static_cast<int>(code >> (16 - length)) - h.first_code[length] + h.first_symbol[length];
+        if (slot < 0 || slot >= 288 || h.size[slot] != length) {
+            return -1;
+        }
+        bits_ >>= length;
+        count_ -= length;
+        return h.value[slot];
+    }
+
+    bool fail(const char* message) {
+        error_ = message;
+        return false;
+    }
+
+    // Hands the pending output to the consumer and keeps the last window
+    bool slide() {
+        if (!deliver()) {
+            return false;
+        }
+        std::memmove(out_.data(), out_.data() + pos_ - kWindow, kWindow);
+        pos_ = flushed_ = kWindow;
+        return true;
+    }
+
+    bool deliver() {
+        if (pos_ > flushed_) {
+            crc_ = crc32Update(crc_, out_.data() + flushed_, pos_ - flushed_);
+            total_ += pos_ - flushed_;
+            if (!consumer_(reinterpret_cast<const char*>(out_.data() + flushed_), pos_ - flushed_)) {
+                stopped_ = true;
+                return false;
+            }
+            flushed_ = pos_;
+        }
+        return true;
+    }
+
+    bool storedBlock() {
+        take(count_ % 8);
+        uint32_t length = take(16);
+        if ((take(16) ^ 0xFFFF) != length) {
+            return fail("corrupt stored block");
+        }
+
+        // Bytes already pulled into the bit buffer come first
+        while (length && count_ >= 8) {
+            if (pos_ >= out_.size() && !slide()) {
+                return false;
+            }
+            out_[pos_++] = static_cast<uint8_t>(take(8));
+            length--;
+        }
+        if (static_cast<size_t>(end_ - in_) < length) {
+            return fail("truncated stored block");
+        }
+        while (length) {
+            if (pos_ >= out_.size() && !slide()) {
+                return false;
+            }
+            size_t piece = std::min<size_t>(length, out_.size() - pos_);
+            std::memcpy(out_.data() + pos_, in_, piece);
+            pos_ += piece;
+            in_ += piece;
+            length -= static_cast<uint32_t>(piece);
+        }
+        return true;
+    }
+
+    bool fixedBlock() {
+        uint8_t lengths[288 + 32];
+        std::memset(lengths, 8, 144);
+        std::memset(lengths + 144, 9, 112);
+        std::memset(lengths + 256, 7, 24);
+        std::memset(lengths + 280, 8, 8);
+        std::memset(lengths + 288, 5, 32);
+        literals_.build(lengths, 288);
+        distances_.build(lengths + 288, 32);
+        return codes();
+    }
+
+    bool dynamicBlock() {
+        static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+        int literal_count = static_cast<int>(take(5)) + 257;
+        int distance_count = static_cast<int>(take(5)) + 1;
+        int code_count = static_cast<int>(take(4)) + 4;
+        if (literal_count > 286 || distance_count > 30) {
+            return fail("corrupt dynamic block header");
+        }
+
+        uint8_t code_lengths[19] = {};
+        for (int i = 0; i < code_count; i++) {
+            code_lengths[order[i]] = static_cast<uint8_t>(take(3));
+        }
+        Huffman lengths_code;
+        if (!lengths_code.build(code_lengths, 19)) {
+            return fail("corrupt code length table");
+        }
+
+        uint8_t lengths[286 + 30];
+        int total = literal_count + distance_count;
+        for (int n = 0; n < total;) {
+            int symbol = decode(lengths_code);
+            if (symbol < 0) {
+                return fail("corrupt code lengths");
+            }
+            if (symbol < 16) {
+                lengths[n++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+
+            uint8_t fill_with = 0;
+            int repeat;
+            if (symbol == 16) {
+                if (n == 0) {
+                    return fail("corrupt code lengths");
+                }
+                fill_with = lengths[n - 1];
+                repeat = static_cast<int>(take(2)) + 3;
+            } else if (symbol == 17) {
+                repeat = static_cast<int>(take(3)) + 3;
+            } else {
+                repeat = static_cast<int>(take(7)) + 11;
+            }
+            if (n + repeat > total) {
+                return fail("corrupt code lengths");
+            }
+            std::memset(lengths + n, fill_with, repeat);
+            n += repeat;
+        }
+
+        if (lengths[256] == 0 || !literals_.build(lengths, literal_count) ||
+            !distances_.build(lengths + literal_count, distance_count)) {
+            return fail("corrupt huffman tables");
+        }
+        return codes();
+    }
+
+    bool codes() {
+        const size_t limit = out_.size() - 258;
+        while (true) {
+            if (overrun_ > 8) {
+                return fail("truncated deflate stream");
+            }
+            if (pos_ > limit && !slide()) {
+                return false;
+            }
+
+            int symbol = decode(literals_);
+            if (symbol < 256) {
+                if (symbol < 0) {
+                    return fail("corrupt literal/length code");
+                }
+                out_[pos_++] = static_cast<uint8_t>(symbol);
+                continue;
+            }
+            if (symbol == 256) {
+                return true;
+            }
+
+            symbol -= 257;
+            if (symbol >= 29) {
+                return fail("corrupt length code");
+            }
+            size_t length = kLengthBase[symbol] + take(kLengthExtra[symbol]);
+
+            int distance_symbol = decode(distances_);
+            if (distance_symbol < 0 || distance_symbol >= 30) {
+                return fail("corrupt distance code");
+            }
+            size_t distance = kDistanceBase[distance_symbol] + take(kDistanceExtra[distance_symbol]);
+            if (distance > pos_) {
+                return fail("distance beyond start of output");
+            }
+
+            uint8_t* to = out_.data() + pos_;
+            const uint8_t* from = to - distance;
+            if (distance >= length) {
+                std::memcpy(to, from, length);
+            } else {
+                for (size_t i = 0; i < length; i++) {
+                    to[i] = from[i];  // overlapping run
+                }
+            }
+            pos_ += length;
+        }
+    }
+
+    const uint8_t* in_;
+    const uint8_t* end_;
+    uint64_t bits_ = 0;
+    int count_ = 0;
+    size_t overrun_ = 0;  // zero bytes fed past the end of the input
+
+    const std::function<bool(const char*, size_t)>& consumer_;
+    std::vector<uint8_t> out_;
+    size_t pos_ = 0;
+    size_t flushed_ = 0;
+    uint64_t total_ = 0;
+    uint32_t crc_ = 0;
+    bool stopped_ = false;
+    const char* error_ = "";
+
+    Huffman literals_;
+    Huffman distances_;
+};
+
+} // namespace
+
+bool ZipArchive::open(const std::string& path) {
+    close();
+    if (!file_.open(path)) {
+        return fail(file_.error());
+    }
+    if (!readCentralDirectory()) {
+        file_.close();
+        entries_.clear();
+        return false;
+    }
+    return true;
+}
+
+void ZipArchive::close() {
+    file_.close();
+    entries_.clear();
+    error_.clear();
+}
+
+const ZipArchive::Entry* ZipArchive::find(const std::string& name) const {
+    for (const auto& entry : entries_) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool ZipArchive::fail(const std::string& message) {
+    error_ = message;
+    return false;
+}
+
+bool ZipArchive::readCentralDirectory() {
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file_.data());
+    size_t size = file_.size();
+
+    // End of central directory record: last 22 bytes plus up to 64 KB of comment
+    if (size < 22) {
+        return fail("not a zip archive");
+    }
+    size_t eocd = size - 22;
+    size_t lowest = size > 22 + 65535 ? size - 22 - 65535 : 0;
+    while (read32(data + eocd) != 0x06054b50) {
+        if (eocd == lowest) {
+            return fail("not a zip archive");
+        }
+        eocd--;
+    }
+
+    uint64_t count = read16(data + eocd + 10);
+    uint64_t directory_size = read32(data + eocd + 12);
+    uint64_t directory_offset = read32(data + eocd + 16);
+
+    if (eocd >= 20 && read32(data + eocd - 20) == 0x07064b50) {
+        uint64_t zip64 = read64(data + eocd - 20 + 8);
+        if (zip64 + 56 > size || read32(data + zip64) != 0x06064b50) {
+            return fail("corrupt ZIP64 directory");
+        }
+        count = read64(data + zip64 + 32);
+        directory_size = read64(data + zip64 + 40);
+        directory_offset = read64(data + zip64 + 48);
+    }
+    if (directory_offset + directory_size > size) {
+        return fail("corrupt central directory");
+    }
+
+    const uint8_t* p = data + directory_offset;
+    const uint8_t* end = p + directory_size;
+    entries_.reserve(static_cast<size_t>(std::min<uint64_t>(count, directory_size / 46)));
+    for (uint64_t i = 0; i < count; i++) {
+        if (end - p < 46 || read32(p) != 0x02014b50) {
+            return fail("corrupt central directory");
+        }
+        uint16_t name_length = read16(p + 28);
+        uint16_t extra_length = read16(p + 30);
+        uint16_t comment_length = read16(p + 32);
+        if (static_cast<size_t>(end - p) < 46u + name_length + extra_length + comment_length) {
+            return fail("corrupt central directory");
+        }
+
+        Entry entry;
+        entry.flags = read16(p + 8);
+        entry.method = read16(p + 10);
+        entry.crc32 = read32(p + 16);
+        entry.compressed_size = read32(p + 20);
+        entry.size = read32(p + 24);
+        entry.local_offset = read32(p + 42);
+        entry.name.assign(reinterpret_cast<const char*>(p + 46), name_length);
+
+        // ZIP64 extra field carries whichever sizes overflowed 32 bits, in order
+        const uint8_t* extra = p + 46 + name_length;
+        const uint8_t* extra_end = extra + extra_length;
+        while (extra_end - extra >= 4) {
+            uint16_t id = read16(extra);
+            uint16_t length = read16(extra + 2);
+            const uint8_t* field = extra + 4;
+            const uint8_t* field_end = std::min(field + length, extra_end);
+            if (id == 0x0001) {
+                for (uint64_t* value : {&entry.size, &entry.compressed_size, &entry.local_offset}) {
+                    if (*value == 0xFFFFFFFF && field_end - field >= 8) {
+                        *value = read64(field);
+                        field += 8;
+                    }
+                }
+            }
+            extra = field_end;
+        }
+
+        entries_.push_back(std::move(entry));
+        p += 46 + name_length + extra_length + comment_length;
+    }
+    return true;
+}
+
+bool ZipArchive::extract(const std::string& name, const std::function<bool(const char*, size_t)>& consumer) {
+    const Entry* entry = find(name);
+    if (!entry) {
+        return fail("no entry " + name + " in archive");
+    }
+    return extract(*entry, consumer);
+}
+
+bool ZipArchive::extract(const Entry& entry, const std::function<bool(const char*, size_t)>& consumer) {
+    error_.clear();
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(file_.data());
+    size_t size = file_.size();
+
+    if (entry.flags & 1) {
+        return fail(entry.name + " is encrypted");
+    }
+    if (entry.local_offset + 30 > size || read32(data + entry.local_offset) != 0x04034b50) {
+        return fail("corrupt local header for " + entry.name);
+    }
+    uint64_t start = entry.local_offset + 30 + read16(data + entry.local_offset + 26) + read16(data + entry.local_offset + 28);
+    if (start + entry.compressed_size > size) {
+        return fail("truncated entry " + entry.name);
+    }
+    const uint8_t* compressed = data + start;
+
+    if (entry.method == 0) {
+        if (entry.compressed_size != entry.size) {
+            return fail("corrupt stored entry " + entry.name);
+        }
+        if (crc32Update(0, compressed, static_cast<size_t>(entry.size)) != entry.crc32) {
+            return fail("CRC mismatch in " + entry.name);
+        }
+        for (uint64_t offset = 0; offset < entry.size;) {
+            size_t piece = static_cast<size_t>(std::min<uint64_t>(entry.size - offset, 256 * 1024));
+            if (!consumer(reinterpret_cast<const char*>(compressed + offset), piece)) {
+                return false;
+            }
+            offset += piece;
+        }
+        return true;
+    }
+
+    if (entry.method != 8) {
+        return fail(entry.name + " uses unsupported compression method " + std::to_string(entry.method));
+    }
+
+    Inflater inflater(compressed, static_cast<size_t>(entry.compressed_size), consumer);
+    if (!inflater.run()) {
+        return inflater.stopped() ? false : fail(std::string(inflater.error()) + " in " + entry.name);
+    }
+    if (inflater.size() != entry.size || inflater.crc() != entry.crc32) {
+        return fail("CRC mismatch in " + entry.name);
+    }
+    return true;
+}
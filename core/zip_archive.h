@@ -0,0 +1,50 @@
+// Zip archive - read-only access to stored and deflated zip entries
+#pragma once
+#include "mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Zip Archive - reads entries out of a mapped zip (XLSX, DOCX, ...)
+ * Only the central directory is parsed up front. extract() inflates an
+ * entry in fixed-size pieces and hands each to the consumer, keeping no
+ * more than the 32 KB deflate window plus one output block, so a sheet
+ * that expands to gigabytes of XML never exists in memory at once.
+ * CRC-32 is checked once the entry ends. ZIP64 archives are supported;
+ * encrypted entries and methods other than stored/deflate are not.
+ */
+class ZipArchive {
+public:
+    struct Entry {
+        std::string name;
+        uint16_t method = 0;
+        uint16_t flags = 0;
+        uint32_t crc32 = 0;
+        uint64_t compressed_size = 0;
+        uint64_t size = 0;
+        uint64_t local_offset = 0;
+    };
+
+    bool open(const std::string& path);
+    void close();
+
+    const std::vector<Entry>& entries() const { return entries_; }
+    const Entry* find(const std::string& name) const;
+
+    // Consumer returns false to stop early; extract() then returns false with no error
+    bool extract(const Entry& entry, const std::function<bool(const char*, size_t)>& consumer);
+    bool extract(const std::string& name, const std::function<bool(const char*, size_t)>& consumer);
+
+    const std::string& error() const { return error_; }
+
+private:
+    bool readCentralDirectory();
+    bool fail(const std::string& message);
+
+    MappedFile file_;
+    std::vector<Entry> entries_;
+    std::string error_;
+};
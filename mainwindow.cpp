@@ -1,4 +1,5 @@
 #include "mainwindow.h"
+#include "core/database.h"
 #include <QApplication>
 #include <QStackedWidget>
 #include <QPushButton>
@@ -13,6 +14,7 @@
 #include <QTextStream>
 #include <QMessageBox>
 #include <iostream>
+#include <sstream>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -188,6 +190,10 @@ void MainWindow::setupStatusBar()
     statusBar()->addWidget(statusLabel);
     
     // Add permanent widgets to status bar
+    dbStatsLabel = new QLabel("🗄️ 0 queries");
+    dbStatsLabel->setObjectName("dbStatsLabel");
+    statusBar()->addPermanentWidget(dbStatsLabel);
+
     QLabel *versionLabel = new QLabel("Riley Corpbrain v1.0");
     versionLabel->setObjectName("versionLabel");
     statusBar()->addPermanentWidget(versionLabel);
@@ -342,6 +348,17 @@ void MainWindow::updateStatusDisplay() {
     // Update AI status and system metrics
     if (corpBrain) {
         aiStatusLabel->setText("🤖 AI: Active");
+
+        // Database load at a glance, full per-statement breakdown on hover
+        const QueryStats& stats = corpBrain->getDatabase()->queryStats();
+        std::ostringstream details;
+        stats.dump(details, 10);
+
+        const RowCache& rows = corpBrain->getDatabase()->rowCache();
+        details << "Row cache: " << rows.hits() << " hits, " << rows.misses() << " misses, "
+                << rows.size() << " rows";
+        dbStatsLabel->setText(QString::fromStdString(stats.summary()));
+        dbStatsLabel->setToolTip(QString::fromStdString(details.str()));
     }
 }
 
@@ -83,6 +83,7 @@ private:
     // Status and info
     QLabel *statusLabel;
     QLabel *aiStatusLabel;
+    QLabel *dbStatsLabel;
     QTimer *statusTimer;
 
     // Current active section
@@ -0,0 +1,135 @@
+#include "core/csv_reader.h"
+#include "core/csv_scanner.h"
+#include "core/mapped_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Riley CSV Tokenizer Benchmark
+ * Times field splitting alone - no database - for the line-based splitter
+ * ingestCSV used to have, and for CsvReader::parse at every scanner level
+ * this CPU supports. Single-threaded, best of several runs.
+ *
+ *     RileyCsvBenchmark [file.csv] [runs]
+ *
+ * Without a file, a synthetic CRM export (~64 MB) is generated in memory.
+ */
+
+namespace {
+
+// The splitter DatabaseIntelligence::ingestCSV used before the mapped
+// reader: getline per line, getline(',') per field, quotes trimmed
+std::vector<std::string> legacyParseCSVLine(const std::string& line) {
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+
+    while (std::getline(ss, field, ',')) {
+        field.erase(0, field.find_first_not_of(" \t\""));
+        field.erase(field.find_last_not_of(" \t\"") + 1);
+        fields.push_back(field);
+    }
+
+    return fields;
+}
+
+std::string syntheticExport(size_t target_bytes) {
+    static const char* industries[] = {"Technology", "Healthcare", "Finance", "Retail", "Manufacturing"};
+    std::string csv = "id,name,email,phone,company,industry,notes,value_score,created_at\n";
+    char row[512];
+
+    for (size_t i = 0; csv.size() < target_bytes; i++) {
+        const char* notes = i % 50 == 0   ? "\"Renewal call, asked about \"\"enterprise\"\" tier\""
+                            : i % 7 == 0 ? "\"Prefers email, not phone\""
+                                         : "Quarterly check-in completed without issues";
+        std::snprintf(row, sizeof(row), "%zu,Client %zu,contact%zu@example.com,+1-555-%04zu,\"Company %zu, Inc.\",%s,%s,%zu.%zu,2024-%02zu-%02zu\n",
+                      i, i, i, i % 10000, i % 977, industries[i % 5], notes, i % 10, i % 100, i % 12 + 1, i % 28 + 1);
+        csv += row;
+    }
+    return csv;
+}
+
+template <typename Fn>
+double bestSeconds(int runs, Fn&& fn) {
+    double best = 1e30;
+    for (int run = 0; run < runs; run++) {
+        auto started = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+    }
+    return best;
+}
+
+void report(const char* name, size_t bytes, size_t fields, double seconds, double baseline) {
+    std::printf("  %-22s %9.1f MB/s  %10zu fields  %6.3fs", name, bytes / seconds / 1e6, fields, seconds);
+    if (baseline > 0) {
+        std::printf("  %5.1fx", baseline / seconds);
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int runs = argc > 2 ? std::max(1, std::atoi(argv[2])) : 3;
+
+    MappedFile file;
+    std::string generated;
+    std::string_view input;
+
+    if (argc > 1) {
+        if (!file.open(argv[1])) {
+            std::cerr << "❌ " << file.error() << std::endl;
+            return 1;
+        }
+        input = file.view();
+    } else {
+        generated = syntheticExport(64 << 20);
+        input = generated;
+    }
+
+    std::cout << "📊 CSV tokenizer benchmark - " << input.size() / 1e6 << " MB, best of " << runs << " runs" << std::endl;
+    std::cout << "   Detected scanner level: " << CsvScanner::levelName(CsvScanner::detectedLevel()) << std::endl;
+
+    // Legacy: line-based, so it also splits quoted newlines and commas wrongly
+    size_t legacy_fields = 0;
+    double legacy = bestSeconds(runs, [&] {
+        legacy_fields = 0;
+        std::istringstream lines{std::string(input)};
+        std::string line;
+        while (std::getline(lines, line)) {
+            legacy_fields += legacyParseCSVLine(line).size();
+        }
+    });
+    report("legacy parseCSVLine", input.size(), legacy_fields, legacy, 0);
+
+    const CsvScanner::Level levels[] = {CsvScanner::Level::Scalar, CsvScanner::Level::SSE42, CsvScanner::Level::AVX2};
+    for (CsvScanner::Level level : levels) {
+        if (level > CsvScanner::detectedLevel()) {
+            continue;
+        }
+        CsvScanner::setLevel(level);
+
+        size_t fields = 0;
+        double seconds = bestSeconds(runs, [&] {
+            CsvChunk chunk;
+            CsvReader::parse(input.data(), input.data() + input.size(), ',', chunk);
+            fields = 0;
+            for (size_t row = 0; row < chunk.rowCount(); row++) {
+                fields += chunk.fieldCount(row);
+            }
+        });
+
+        std::string name = std::string("CsvReader (") + CsvScanner::levelName(level) + ")";
+        report(name.c_str(), input.size(), fields, seconds, legacy);
+    }
+
+    CsvScanner::setLevel(CsvScanner::detectedLevel());
+    return 0;
+}
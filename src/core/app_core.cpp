@@ -1,5 +1,6 @@
 #include "app_core.h"
 #include "../../core/riley_corpbrain.h"
+#include "../../core/database.h"
 #include <iostream>
 #include <memory>
 
@@ -21,6 +22,9 @@ void AppCore::run() {
         std::cout << "📊 Enterprise management system is ready." << std::endl;
         std::cout << "🎯 All business modules are operational." << std::endl;
 
+        // Where startup spent its database time
+        corpBrain->getDatabase()->queryStats().dump(std::cout);
+
         // Keep the console open
         std::cout << "\nPress Enter to exit..." << std::endl;
         std::cin.get();
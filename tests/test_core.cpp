@@ -0,0 +1,923 @@
+// Core data layer tests
+#include "bulk_loader.h"
+#include "column_profiler.h"
+#include "csv_reader.h"
+#include "database.h"
+#include "database_intelligence.h"
+#include "csv_scanner.h"
+#include "json_reader.h"
+#include "records.h"
+#include "schema_model.h"
+#include "type_inference.h"
+#include "xlsx_reader.h"
+#include "zip_archive.h"
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef TEST_DATA_DIR
+#define TEST_DATA_DIR "tests/data"
+#endif
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                                          \
+    do {                                                                          \
+        if (!(condition)) {                                                       \
+            std::cerr << "❌ " << __FILE__ << ":" << __LINE__ << ": " #condition "\n"; \
+            failures++;                                                           \
+        }                                                                         \
+    } while (0)
+
+using Rows = std::vector<std::vector<std::string>>;
+
+std::string writeTemp(const std::string& name, const std::string& contents) {
+    std::string path = "test_core_" + name;
+    std::ofstream out(path, std::ios::binary);
+    out << contents;
+    return path;
+}
+
+Rows parseText(const std::string& text, char delimiter = ',') {
+    CsvChunk chunk;
+    CsvReader::parse(text.data(), text.data() + text.size(), delimiter, chunk);
+
+    Rows rows;
+    for (size_t r = 0; r < chunk.rowCount(); r++) {
+        std::vector<std::string> row;
+        for (size_t f = 0; f < chunk.fieldCount(r); f++) {
+            row.emplace_back(chunk.fields(r)[f]);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+Rows readFile(CsvReader& reader) {
+    Rows rows;
+    reader.read([&](const CsvChunk& chunk) {
+        for (size_t r = 0; r < chunk.rowCount(); r++) {
+            std::vector<std::string> row;
+            for (size_t f = 0; f < chunk.fieldCount(r); f++) {
+                row.emplace_back(chunk.fields(r)[f]);
+            }
+            rows.push_back(row);
+        }
+        return true;
+    });
+    return rows;
+}
+
+void removeDatabase(const std::string& path) {
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((path + suffix).c_str());
+    }
+}
+
+bool ready(std::future<bool>& result, std::chrono::milliseconds within = std::chrono::seconds(2)) {
+    return result.wait_for(within) == std::future_status::ready;
+}
+
+void testWriteQueueBatches() {
+    // A full batch commits at once, long before its latency is up
+    {
+        Database db(":memory:", 0);
+        CHECK(db.execute("CREATE TABLE queued (n INTEGER);"));
+        WriteQueue::Options options;
+        options.max_batch_size = 4;
+        options.max_latency = std::chrono::seconds(30);
+        db.setWriteQueueOptions(options);
+
+        std::vector<std::future<bool>> results;
+        for (int i = 0; i < 8; i++) {
+            results.push_back(db.writeQueue()->submit("INSERT INTO queued (n) VALUES (?1);", {int64_t{i}}));
+        }
+        for (auto& result : results) {
+            CHECK(ready(result) && result.get());
+        }
+        db.flushWrites();  // counters settle after the futures
+        CHECK(db.writeQueue()->batchesCommitted() == 2 && db.writeQueue()->writesCommitted() == 8);
+    }
+
+    // A lone write waits out the latency, then commits
+    {
+        Database db(":memory:", 0);
+        CHECK(db.execute("CREATE TABLE queued (n INTEGER);"));
+        WriteQueue::Options options;
+        options.max_latency = std::chrono::milliseconds(50);
+        db.setWriteQueueOptions(options);
+
+        auto started = std::chrono::steady_clock::now();
+        auto result = db.writeQueue()->submit("INSERT INTO queued (n) VALUES (1);", {});
+        CHECK(ready(result) && result.get());
+        CHECK(std::chrono::steady_clock::now() - started >= std::chrono::milliseconds(40));
+        db.flushWrites();
+        CHECK(db.writeQueue()->batchesCommitted() == 1);
+    }
+
+    // A failing statement is rolled back alone; its future reports false
+    {
+        Database db(":memory:", 0);
+        CHECK(db.execute("CREATE TABLE queued (n INTEGER NOT NULL);"));
+        WriteQueue::Options options;
+        options.max_batch_size = 3;
+        options.max_latency = std::chrono::seconds(30);
+        db.setWriteQueueOptions(options);
+
+        auto first = db.writeQueue()->submit("INSERT INTO queued (n) VALUES (1);", {});
+        auto failing = db.writeQueue()->submit("INSERT INTO queued (n) VALUES (NULL);", {});
+        auto last = db.writeQueue()->submit("INSERT INTO queued (n) VALUES (3);", {});
+        CHECK(ready(first) && first.get());
+        CHECK(ready(failing) && !failing.get());
+        CHECK(ready(last) && last.get());
+        db.flushWrites();
+        CHECK(db.writeQueue()->batchesCommitted() == 1 && db.writeQueue()->writesFailed() == 1);
+        CHECK(db.query("SELECT group_concat(n) AS n FROM queued;")[0].at("n") == "1,3");
+    }
+}
+
+void testWriteQueueReadYourWrites() {
+    removeDatabase("test_core_queue.db");
+    {
+        Database db("test_core_queue.db", 2);
+        CHECK(db.execute("CREATE TABLE queued (n INTEGER);"));
+        WriteQueue::Options options;
+        options.max_latency = std::chrono::milliseconds(300);
+        db.setWriteQueueOptions(options);
+
+        // The enqueuing thread's next read waits for its own write
+        auto mine = db.enqueueWrite("INSERT INTO queued (n) VALUES (1);");
+        CHECK(db.query("SELECT COUNT(*) AS n FROM queued;")[0].at("n") == "1");
+        CHECK(ready(mine, std::chrono::milliseconds(0)) && mine.get());
+
+        // A fire-and-forget write does not hold the thread's reads back
+        auto detached = db.enqueueWrite("INSERT INTO queued (n) VALUES (2);", {}, false);
+        auto started = std::chrono::steady_clock::now();
+        CHECK(db.query("SELECT COUNT(*) AS n FROM queued;")[0].at("n") == "1");
+        CHECK(std::chrono::steady_clock::now() - started < std::chrono::milliseconds(200));
+        db.flushWrites();
+        CHECK(ready(detached, std::chrono::milliseconds(0)) && detached.get());
+        CHECK(db.query("SELECT COUNT(*) AS n FROM queued;")[0].at("n") == "2");
+    }
+    removeDatabase("test_core_queue.db");
+}
+
+void testQuotedFields() {
+    Rows rows = parseText("a,\"b,c\",d\n\"line\nbreak\",\"say \"\"hi\"\"\",\"\"\n");
+    CHECK(rows.size() == 2);
+    CHECK((rows[0] == std::vector<std::string>{"a", "b,c", "d"}));
+    CHECK((rows[1] == std::vector<std::string>{"line\nbreak", "say \"hi\"", ""}));
+}
+
+void testLineEnds() {
+    Rows rows = parseText("a,b\r\n1,\"x\r\ny\"\r\n\r\n2,3");
+    CHECK(rows.size() == 3);
+    CHECK((rows[0] == std::vector<std::string>{"a", "b"}));
+    CHECK((rows[1] == std::vector<std::string>{"1", "x\r\ny"}));
+    CHECK((rows[2] == std::vector<std::string>{"2", "3"}));
+}
+
+void testStrayQuote() {
+    // A quote inside an unquoted field is data, and must not open a
+    // quoted run that swallows the following records
+    Rows rows = parseText("12\",inch\nnext,row\n");
+    CHECK(rows.size() == 2);
+    CHECK((rows[0] == std::vector<std::string>{"12\"", "inch"}));
+    CHECK((rows[1] == std::vector<std::string>{"next", "row"}));
+
+    rows = parseText("\"ab\"cd,e\n");
+    CHECK(rows.size() == 1);
+    CHECK((rows[0] == std::vector<std::string>{"abcd", "e"}));
+}
+
+void testHeaderAndBom() {
+    std::string path = writeTemp("bom.csv", "\xEF\xBB\xBFid, name ,,id\r\n1,Ann,x,2\r\n");
+    CsvReader reader;
+    CHECK(reader.open(path));
+    CHECK((reader.header() == std::vector<std::string>{"id", "name", "column_3", "id_2"}));
+
+    Rows rows = readFile(reader);
+    CHECK(rows.size() == 1);
+    CHECK((rows[0] == std::vector<std::string>{"1", "Ann", "x", "2"}));
+    std::remove(path.c_str());
+}
+
+void testChunkBoundaryInsideQuotes() {
+    // Each record carries a quoted field longer than a chunk, full of
+    // delimiters and line ends, so every split target lands inside quotes
+    std::string quoted;
+    while (quoted.size() < 6000) {
+        quoted += "x,\"\"y\n";
+    }
+    std::string expected;
+    for (size_t i = 0; i < quoted.size(); i++) {
+        expected += quoted[i];
+        if (quoted[i] == '"') {
+            i++;
+        }
+    }
+
+    std::string text = "id,body,tail\n";
+    const int records = 12;
+    for (int i = 0; i < records; i++) {
+        text += std::to_string(i) + ",\"" + quoted + "\",end\n";
+    }
+    std::string path = writeTemp("chunks.csv", text);
+
+    CsvReader::Options options;
+    options.chunk_bytes = 4096;
+    options.threads = 3;
+    CsvReader reader(options);
+    CHECK(reader.open(path));
+
+    size_t boundary = reader.nextBoundary(reader.dataStart(), reader.dataStart() + 100);
+    CHECK(boundary < text.size());
+    CHECK(text[boundary - 1] == '\n');
+    CHECK(text.compare(boundary, 2, "1,") == 0);
+
+    Rows rows = readFile(reader);
+    CHECK(rows.size() == records);
+    for (int i = 0; i < records && i < static_cast<int>(rows.size()); i++) {
+        CHECK((rows[i] == std::vector<std::string>{std::to_string(i), expected, "end"}));
+    }
+    std::remove(path.c_str());
+}
+
+void testUnfinishedRecord() {
+    std::string path = writeTemp("tail.csv", "a,b\n1,2\n3,\"open\nstill");
+    CsvReader reader;
+    CHECK(reader.open(path));
+    CHECK(reader.lastBoundary(reader.dataStart()) == 8);
+    std::remove(path.c_str());
+}
+
+const CsvScanner::Level kLevels[] = {CsvScanner::Level::Scalar, CsvScanner::Level::SSE42, CsvScanner::Level::AVX2};
+
+void testScannerLevelsAgree() {
+    // Every level the CPU supports must classify random blocks, and parse
+    // random CSV, exactly like the scalar loop
+    std::mt19937 random(42);
+    const char alphabet[] = {',', ';', '"', '\r', '\n', 'a', 'b', ' ', '\0', '\xC3', '\x80'};
+    std::uniform_int_distribution<size_t> pick(0, sizeof(alphabet) - 1);
+
+    for (int round = 0; round < 200; round++) {
+        std::string text(1 + random() % 700, ' ');
+        for (char& c : text) {
+            c = alphabet[pick(random)];
+        }
+        char delimiter = round % 2 ? ';' : ',';
+
+        CsvScanner::setLevel(CsvScanner::Level::Scalar);
+        Rows expected = parseText(text, delimiter);
+        std::vector<uint64_t> masks;
+        for (size_t at = 0; at + 64 <= text.size(); at += 64) {
+            masks.push_back(CsvScanner::classify(text.data() + at, delimiter));
+        }
+
+        for (CsvScanner::Level level : kLevels) {
+            if (level > CsvScanner::detectedLevel()) {
+                continue;
+            }
+            CsvScanner::setLevel(level);
+            for (size_t i = 0; i < masks.size(); i++) {
+                CHECK(CsvScanner::classify(text.data() + i * 64, delimiter) == masks[i]);
+            }
+            CHECK(parseText(text, delimiter) == expected);
+        }
+    }
+    CsvScanner::setLevel(CsvScanner::detectedLevel());
+}
+
+std::vector<JsonRecord> readJson(const std::string& text, const JsonRecordReader::Options& options = {}) {
+    std::vector<JsonRecord> records;
+    JsonRecordReader reader(options);
+    bool ok = reader.readText(text, [&](JsonRecord& record) {
+        records.push_back(record);
+        return true;
+    });
+    CHECK(ok);
+    return records;
+}
+
+void testJsonFlattening() {
+    auto records = readJson(R"([{"id":1,"name":"Ann \u00e9","address":{"city":"Oslo","geo":{"lat":59.9}},)"
+                            R"("tags":["a",{"b":null}],"active":true,"note":null}])");
+    CHECK(records.size() == 1);
+    JsonRecord expected = {{"id", int64_t{1}}, {"name", std::string("Ann \xC3\xA9")}, {"address_city", std::string("Oslo")},
+                           {"address_geo_lat", 59.9}, {"tags", std::string(R"(["a",{"b":null}])")},
+                           {"active", int64_t{1}}, {"note", nullptr}};
+    CHECK(records[0] == expected);
+
+    // NDJSON, a nested records path, and bare scalars
+    CHECK(readJson("{\"a\":1}\n{\"a\":2}\n").size() == 2);
+    JsonRecordReader::Options options;
+    options.records_path = "result.items";
+    records = readJson(R"({"meta":{"n":2},"result":{"items":[{"x":1},{"x":2}]}})", options);
+    CHECK(records.size() == 2 && records[1][0].first == "x");
+    records = readJson("[1, \"two\"]");
+    CHECK(records.size() == 2 && records[1][0] == JsonRecord::value_type("value", std::string("two")));
+}
+
+void testJsonNameCollisions() {
+    auto records = readJson(R"({"b":{"c":1},"b_c":2,"B_C":3,"b_c_2":4})");
+    CHECK(records.size() == 1);
+    JsonRecord expected = {{"b_c", int64_t{1}}, {"b_c_2", int64_t{2}}, {"B_C_3", int64_t{3}}, {"b_c_2_2", int64_t{4}}};
+    CHECK(records[0] == expected);
+}
+
+void testJsonErrors() {
+    JsonRecordReader reader;
+    auto keep = [](JsonRecord&) { return true; };
+    CHECK(!reader.readText("[{\"a\":1},", keep));
+    CHECK(!reader.error().empty());
+    CHECK(!reader.readText("{\"a\":1.2.3}", keep));
+    CHECK(!reader.readText("{\"a\":\"\\ud800\"}", keep));
+}
+
+void testZipInflate() {
+    ZipArchive archive;
+    CHECK(archive.open(TEST_DATA_DIR "/sample.xlsx"));
+    const ZipArchive::Entry* entry = archive.find("big.txt");
+    CHECK(entry && entry->method == 8 && entry->size == 100000);
+
+    // 100 KB from a few hundred bytes: runs of maximum-length matches
+    std::string text;
+    CHECK(archive.extract("big.txt", [&](const char* data, size_t size) {
+        text.append(data, size);
+        return true;
+    }));
+    bool pattern = text.size() == 100000;
+    for (size_t i = 0; pattern && i < text.size(); i++) {
+        pattern = text[i] == "abcdefghij"[i % 10];
+    }
+    CHECK(pattern);
+
+    size_t pieces = 0;
+    CHECK(!archive.extract("big.txt", [&](const char*, size_t) { return ++pieces > 1; }));
+    CHECK(pieces == 1);
+    CHECK(archive.error().empty());
+    CHECK(!archive.extract("missing.txt", [](const char*, size_t) { return true; }));
+}
+
+void testZipCorruption() {
+    // A flipped byte in the compressed stream must surface as an error,
+    // never as silently wrong data
+    std::ifstream in(TEST_DATA_DIR "/sample.xlsx", std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t at = bytes.find("big.txt");
+    CHECK(at != std::string::npos);
+    bytes[at + 7 + 20] ^= 0x55;
+    std::string path = writeTemp("corrupt.zip", bytes);
+
+    ZipArchive archive;
+    CHECK(archive.open(path));
+    CHECK(!archive.extract("big.txt", [](const char*, size_t) { return true; }));
+    CHECK(!archive.error().empty());
+    std::remove(path.c_str());
+}
+
+void testXlsxCells() {
+    XlsxReader reader;
+    CHECK(reader.open(TEST_DATA_DIR "/sample.xlsx"));
+    CHECK((reader.sheetNames() == std::vector<std::string>{"Data"}));
+    CHECK((reader.header() == std::vector<std::string>{"id", "when", "note"}));
+
+    std::vector<std::vector<SqlValue>> rows;
+    CHECK(reader.read([&](const std::vector<SqlValue>& row) {
+        rows.push_back(row);
+        return true;
+    }));
+    CHECK(rows.size() == 3);
+    if (rows.size() == 3) {
+        CHECK((rows[0] == std::vector<SqlValue>{int64_t{1}, std::string("2023-03-15 12:00:00"), std::string("a & b")}));
+        // Beyond 9999-12-31 a date-styled cell keeps its number
+        CHECK((rows[1] == std::vector<SqlValue>{int64_t{2}, int64_t{30000000}}));
+        CHECK((rows[2] == std::vector<SqlValue>{int64_t{3}, std::string("06:00:00"), 2.5}));
+    }
+}
+
+std::vector<TypeInference::Column> inferColumns(const std::vector<std::vector<std::string_view>>& rows) {
+    TypeInference inference({"value"});
+    for (const auto& row : rows) {
+        inference.offer(row.data(), row.size());
+    }
+    return inference.infer();
+}
+
+void testTypeInference() {
+    auto columns = inferColumns({{"12"}, {"-3"}, {""}});
+    CHECK(columns[0].type == TypeInference::Type::Integer && columns[0].empty == 1);
+    CHECK(inferColumns({{"12"}, {"0.5"}})[0].type == TypeInference::Type::Real);
+    CHECK(inferColumns({{"12"}, {"007"}})[0].type == TypeInference::Type::Text);
+
+    columns = inferColumns({{"2024-03-31"}, {"2024-04-01 08:30"}});
+    CHECK(columns[0].type == TypeInference::Type::Date && columns[0].date_order == TypeInference::DateOrder::YMD);
+    columns = inferColumns({{"01/02/2024"}, {"3/31/2024"}});
+    CHECK(columns[0].type == TypeInference::Type::Date && columns[0].date_order == TypeInference::DateOrder::MDY);
+    columns = inferColumns({{"01/02/2024"}, {"31/03/2024"}});
+    CHECK(columns[0].type == TypeInference::Type::Date && columns[0].date_order == TypeInference::DateOrder::DMY);
+
+    // A dotted date is day-first even when month-first would also parse
+    columns = inferColumns({{"01.02.2024"}, {"05.06.2024"}});
+    CHECK(columns[0].type == TypeInference::Type::Date && columns[0].date_order == TypeInference::DateOrder::DMY);
+    SqlValue value;
+    TypeInference::convert(columns[0], "01.02.2024", value);
+    CHECK(value == SqlValue(std::string("2024-02-01")));
+
+    CHECK(!TypeInference::parseDate("2023-02-29", TypeInference::DateOrder::YMD, nullptr));
+    CHECK(!TypeInference::parseDate("2024-01-01 24:00", TypeInference::DateOrder::YMD, nullptr));
+}
+
+void testSampledCsvInference() {
+    // Past 16 MB only evenly spread slices are sampled; a column that
+    // turns to text at the very end of the file must still be caught
+    std::string padding(200, 'p');
+    std::string text = "id,amount,note\n";
+    for (int i = 0; text.size() < (40u << 20); i++) {
+        text += std::to_string(i) + "," + std::to_string(i % 1000) + "," + padding + "\n";
+    }
+    for (int i = 0; i < 1000; i++) {
+        text += "9,n/a," + padding + "\n";
+    }
+    std::string path = writeTemp("sampled.csv", text);
+    std::remove("test_core_sampled.db");
+
+    {
+        Database db("test_core_sampled.db", 0);
+        SchemaModel schema(&db);
+        DatabaseIntelligence intelligence(&schema);
+        CHECK(intelligence.ingestCSV(path, "sampled"));
+
+        std::map<std::string, std::string> types;
+        for (const auto& column : db.query("PRAGMA table_info(sampled);")) {
+            types[column.at("name")] = column.at("type");
+        }
+        CHECK(types["id"] == "INTEGER");
+        CHECK(types["amount"] == "TEXT");
+        CHECK(db.query("SELECT COUNT(*) AS n FROM sampled WHERE amount = 'n/a';")[0].at("n") == "1000");
+    }
+    std::remove(path.c_str());
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((std::string("test_core_sampled.db") + suffix).c_str());
+    }
+}
+
+void testConvertOnWorkers() {
+    // The converter runs on the parse workers; the consumer sees typed values
+    CsvReader::Options options;
+    options.threads = 3;
+    options.chunk_bytes = 4096;
+    CsvReader reader(options);
+    std::string text = "id,amount\n";
+    for (int i = 0; i < 2000; i++) {
+        text += std::to_string(i) + (i % 7 ? "," + std::to_string(i) + ".5" : "") + "\n";
+    }
+    CHECK(reader.openText(text));
+
+    TypeInference inference({"id", "amount"});
+    std::string_view sample[] = {"1", "2.5"};
+    inference.offer(sample, 2);
+    auto columns = inference.infer();
+    CHECK(columns.size() == 2 && columns[0].type == TypeInference::Type::Integer);
+    int64_t sum = 0;
+    size_t rows = 0, missing = 0;
+    bool completed = reader.read([&](const CsvChunk& chunk) {
+        CHECK(chunk.width() == 2);
+        for (size_t row = 0; row < chunk.rowCount(); ++row, ++rows) {
+            const SqlValue* values = chunk.values(row);
+            sum += std::get<int64_t>(values[0]);
+            missing += std::holds_alternative<std::nullptr_t>(values[1]) ? 1 : 0;
+        }
+        return true;
+    }, reader.dataStart(), reader.bytes(), [&columns](CsvChunk& chunk) {
+        std::vector<SqlValue> values(chunk.rowCount() * 2);
+        for (size_t row = 0; row < chunk.rowCount(); ++row) {
+            for (size_t i = 0; i < std::min<size_t>(chunk.fieldCount(row), 2); ++i) {
+                TypeInference::convert(columns[i], chunk.fields(row)[i], values[row * 2 + i]);
+            }
+        }
+        chunk.setValues(std::move(values), 2);
+    });
+    CHECK(completed && rows == 2000 && sum == 1999 * 2000 / 2 && missing == 286);
+}
+
+void testUpsertAcrossTypes() {
+    // A refresh that infers other column types must not mark every row updated
+    Database db(":memory:", 0);
+    CHECK(db.execute("CREATE TABLE refresh (id TEXT, qty, price, note);"));
+    std::string error;
+    CHECK(BulkLoader::prepareUpsert(&db, "refresh", {"id"}, &error));
+
+    BulkLoader::Options options;
+    options.upsert_keys = {"id"};
+    std::vector<std::string> columns = {"id", "qty", "price", "note"};
+    {
+        BulkLoader loader(&db, "refresh", columns, options);
+        CHECK(loader.add(std::vector<SqlValue>{std::string("a"), int64_t{42}, 2.5, nullptr}));
+        CHECK(loader.add(std::vector<SqlValue>{std::string("b"), int64_t{-7}, 3.0, std::string("x")}));
+        CHECK(loader.finish() && loader.rowsInserted() == 2);
+    }
+    {
+        BulkLoader loader(&db, "refresh", columns, options);
+        CHECK(loader.add(std::vector<std::string>{"a", "42", "2.5"}));
+        CHECK(loader.add(std::vector<std::string>{"b", "-7", "3", "x"}));
+        CHECK(loader.finish());
+        CHECK(loader.rowsUnchanged() == 2 && loader.rowsLoaded() == 0);
+    }
+    {
+        BulkLoader loader(&db, "refresh", columns, options);
+        CHECK(loader.add(std::vector<SqlValue>{std::string("a"), 42.0, 2.5, std::string("")}));
+        CHECK(loader.add(std::vector<SqlValue>{std::string("b"), int64_t{-7}, 3.0, std::string("y")}));
+        CHECK(loader.finish());
+        CHECK(loader.rowsUpdated() == 2 && loader.rowsUnchanged() == 0);  // NULL -> '' and x -> y
+    }
+}
+
+void appendFile(const std::string& path, const std::string& text, bool truncate = false) {
+    std::ofstream out(path, std::ios::binary | (truncate ? std::ios::trunc : std::ios::app));
+    out << text;
+}
+
+std::string countRows(Database& db, const std::string& table) {
+    auto rows = db.query("SELECT COUNT(*) AS n FROM " + table + ";");
+    return rows.empty() ? "missing" : rows[0].at("n");
+}
+
+void testLiveSyncTailing() {
+    Database db(":memory:", 0);
+    SchemaModel schema(&db);
+    DatabaseIntelligence intelligence(&schema);
+    auto source = [&](const std::string& name, const std::string& type, const std::string& path) {
+        DatabaseIntelligence::DataSource data_source;
+        data_source.name = name;
+        data_source.type = type;
+        data_source.connection_string = path;
+        data_source.schema_mapping["table"] = "live_" + name;
+        data_source.is_active = true;
+        CHECK(intelligence.addDataSource(data_source));
+    };
+
+    // CSV: appends load, a record still being written waits, a rewrite reloads
+    std::string csv = writeTemp("live.csv", "id,name\n1,a\n2,b\n");
+    source("orders", "csv", csv);
+    CHECK(intelligence.updateFromSource("orders") && countRows(db, "live_orders") == "2");
+    appendFile(csv, "3,c\n4,\"multi\nline\"\n5,e");
+    CHECK(intelligence.updateFromSource("orders") && countRows(db, "live_orders") == "4");
+    appendFile(csv, "e\n");
+    CHECK(intelligence.updateFromSource("orders") && countRows(db, "live_orders") == "5");
+    CHECK(db.query("SELECT name FROM live_orders WHERE id = 5;")[0].at("name") == "ee");
+    appendFile(csv, "id,name\n9,z\n", true);
+    CHECK(intelligence.updateFromSource("orders") && countRows(db, "live_orders") == "1");
+
+    // NDJSON is tailed by whole lines
+    std::string ndjson = writeTemp("live.ndjson", "{\"a\":1}\n{\"a\":2}\n");
+    source("events", "json", ndjson);
+    CHECK(intelligence.updateFromSource("events") && countRows(db, "live_events") == "2");
+    appendFile(ndjson, "{\"a\":3}\n{\"a\":");
+    CHECK(intelligence.updateFromSource("events") && countRows(db, "live_events") == "3");
+
+    // A JSON document is reloaded whole when it changes, and left alone otherwise
+    std::string document = writeTemp("live.json", "[\n  {\"a\": 1},\n  {\"a\": 2}\n]\n");
+    source("accounts", "json", document);
+    CHECK(intelligence.updateFromSource("accounts") && countRows(db, "live_accounts") == "2");
+    CHECK(intelligence.updateFromSource("accounts") && countRows(db, "live_accounts") == "2");
+    appendFile(document, "[\n  {\"a\": 1},\n  {\"a\": 2},\n  {\"a\": 3}\n]\n", true);
+    CHECK(intelligence.updateFromSource("accounts") && countRows(db, "live_accounts") == "3");
+
+    for (const auto& path : {csv, ndjson, document}) {
+        std::remove(path.c_str());
+    }
+}
+
+// Polls until the background sync has caught up
+bool eventually(const std::function<bool()>& condition, std::chrono::milliseconds within = std::chrono::seconds(5)) {
+    auto deadline = std::chrono::steady_clock::now() + within;
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return true;
+}
+
+void testLiveSyncRestart() {
+    std::string csv = writeTemp("restart.csv", "id,name\n1,a\n2,b\n3,c\n");
+    removeDatabase("test_core_restart.db");
+
+    // The background thread takes the first pass right after start
+    {
+        Database db("test_core_restart.db", 0);
+        SchemaModel schema(&db);
+        DatabaseIntelligence intelligence(&schema);
+        DatabaseIntelligence::DataSource source;
+        source.name = "orders";
+        source.type = "csv";
+        source.connection_string = csv;
+        source.schema_mapping["table"] = "restart_orders";
+        source.is_active = true;
+        CHECK(intelligence.addDataSource(source));
+        CHECK(intelligence.startLiveSync("orders", 60));
+        CHECK(eventually([&db] {
+            return !db.query("SELECT name FROM sqlite_master WHERE name = 'restart_orders';").empty() &&
+                   countRows(db, "restart_orders") == "3";
+        }));
+
+        // A reload from scratch would bring this row back
+        CHECK(db.execute("DELETE FROM restart_orders WHERE id = 1;"));
+    }
+
+    // Both objects are gone; the file grows while nothing runs
+    appendFile(csv, "4,d\n5,e\n");
+    {
+        Database db("test_core_restart.db", 0);
+        SchemaModel schema(&db);
+        DatabaseIntelligence intelligence(&schema);
+        CHECK(intelligence.getActiveSyncSources().size() == 1);
+        CHECK(eventually([&db] { return countRows(db, "restart_orders") == "4"; }));
+        CHECK(db.query("SELECT COUNT(*) AS n FROM restart_orders WHERE id = 1;")[0].at("n") == "0");
+        CHECK(db.query("SELECT group_concat(name, '') AS names FROM restart_orders;")[0].at("names") == "bcde");
+
+        CHECK(intelligence.stopLiveSync("orders"));
+        CHECK(intelligence.getActiveSyncSources().empty());
+    }
+
+    // A stopped source is not resumed
+    appendFile(csv, "6,f\n");
+    {
+        Database db("test_core_restart.db", 0);
+        SchemaModel schema(&db);
+        DatabaseIntelligence intelligence(&schema);
+        CHECK(intelligence.getActiveSyncSources().empty());
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        CHECK(countRows(db, "restart_orders") == "4");
+    }
+
+    std::remove(csv.c_str());
+    removeDatabase("test_core_restart.db");
+}
+
+uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+void testSketches() {
+    // HyperLogLog: 200k distinct values, counted twice and split across two
+    // sketches, land within a few standard errors
+    HyperLogLog all, left, right;
+    for (uint64_t i = 0; i < 200000; i++) {
+        all.add(mix64(i));
+        all.add(mix64(i));
+        (i % 2 ? left : right).add(mix64(i));
+    }
+    left.merge(right);
+    CHECK(std::fabs(all.estimate() / 200000 - 1) < 0.03);
+    CHECK(left.estimate() == all.estimate());
+    CHECK(HyperLogLog().estimate() == 0);
+
+    // T-digest: tails near exact, the median close, merges as accurate
+    TDigest digest, first, second;
+    std::mt19937 random(7);
+    std::vector<double> values;
+    for (int i = 1; i <= 100000; i++) {
+        values.push_back(i);
+    }
+    std::shuffle(values.begin(), values.end(), random);
+    for (size_t i = 0; i < values.size(); i++) {
+        digest.add(values[i]);
+        (i < 30000 ? first : second).add(values[i]);
+    }
+    first.merge(second);
+    for (const TDigest* d : {&digest, &first}) {
+        CHECK(d->count() == 100000);
+        CHECK(std::fabs(d->quantile(0.01) - 1000) < 100);
+        CHECK(std::fabs(d->quantile(0.5) - 50000) < 1000);
+        CHECK(std::fabs(d->quantile(0.99) - 99000) < 100);
+        CHECK(d->quantile(0) == 1 && d->quantile(1) == 100000);
+    }
+    CHECK(std::isnan(TDigest().quantile(0.5)));
+
+    // Top-K: a value seen more than rows / capacity times is always kept
+    TopK top(16);
+    for (int i = 0; i < 50000; i++) {
+        int64_t value = i % 5 == 0 ? 7 : (i % 11 == 0 ? 42 : 1000 + i);
+        top.add(mix64(static_cast<uint64_t>(value)), [value](SqlValue& slot) { slot = value; });
+    }
+    auto items = top.top(2);
+    CHECK(items.size() == 2);
+    if (items.size() == 2) {
+        CHECK(items[0].value == SqlValue(int64_t{7}) && items[0].guaranteed() <= 10000 && items[0].count >= 10000);
+        CHECK(items[1].value == SqlValue(int64_t{42}) && items[1].text() == "42");
+    }
+}
+
+void testColumnProfiler() {
+    std::remove("test_core_profile.db");
+    {
+        Database db("test_core_profile.db", 2);
+        CHECK(db.execute("CREATE TABLE profiled (id INTEGER PRIMARY KEY, amount REAL, region TEXT, note TEXT);"));
+        CHECK(db.beginTransaction());
+        PreparedStatement insert = db.prepare("INSERT INTO profiled (amount, region, note) VALUES (?1, ?2, ?3);");
+        for (int i = 0; i < 20000; i++) {
+            insert.bind(1, static_cast<double>(i % 1000));
+            insert.bind(2, std::string(i % 4 == 0 ? "north" : "south"));
+            if (i % 10 == 0) {
+                insert.bindNull(3);
+            } else {
+                insert.bind(3, std::string(i % 10 == 1 ? "  " : "n" + std::to_string(i)));
+            }
+            CHECK(insert.execute());
+            insert.reset();
+        }
+        CHECK(db.commitTransaction());
+
+        ColumnProfiler profiler(&db);
+        CHECK(profiler.profile("profiled"));
+        CHECK(profiler.rows() == 20000 && profiler.columns().size() == 4);
+        if (profiler.columns().size() == 4) {
+            const ColumnProfile& amount = profiler.columns()[1];
+            CHECK(amount.reals == 20000 && amount.min == 0 && amount.max == 999);
+            CHECK(std::fabs(amount.distinctCount() - 1000) < 30);
+            const ColumnProfile& region = profiler.columns()[2];
+            CHECK(std::fabs(region.distinctCount() - 2) < 0.01 && region.min_text == "north" && region.max_text == "south");
+            auto top = region.frequent.top(1);
+            CHECK(!top.empty() && top[0].text() == "south" && top[0].guaranteed() == 15000);
+            const ColumnProfile& note = profiler.columns()[3];
+            CHECK(note.nulls == 2000 && note.blanks == 2000);
+        }
+    }
+    for (const char* suffix : {"", "-wal", "-shm"}) {
+        std::remove((std::string("test_core_profile.db") + suffix).c_str());
+    }
+}
+
+}  // namespace
+
+void testSnapshotReplica() {
+    removeDatabase("test_core_replica.db");
+    {
+        Database db("test_core_replica.db", 2);
+        CHECK(db.execute("CREATE TABLE facts (n INTEGER);"));
+        CHECK(db.execute("INSERT INTO facts (n) VALUES (1), (2), (3);"));
+        SnapshotReplica::Options options;
+        options.background_refresh = false;
+        options.max_staleness = std::chrono::seconds(600);
+        CHECK(db.enableSnapshotReplica(options));
+
+        // A thread may nest statements on the copy it already reads
+        PreparedStatement outer = db.prepareAnalytics("SELECT n FROM facts ORDER BY n;");
+        CHECK(outer && outer.step() && outer.getInt64(0) == 1);
+        PreparedStatement inner = db.prepareAnalytics("SELECT SUM(n) FROM facts;");
+        CHECK(inner && inner.step() && inner.getInt64(0) == 6);
+
+        // Another thread gets its own reader while this one holds the copy
+        auto other = std::async(std::launch::async, [&db]() {
+            PreparedStatement stmt = db.prepareAnalytics("SELECT COUNT(*) FROM facts;");
+            return stmt && stmt.step() && stmt.getInt64(0) == 3;
+        });
+        CHECK(other.wait_for(std::chrono::seconds(2)) == std::future_status::ready && other.get());
+        inner.reset();
+        outer.reset();
+
+        // A table the copy predates is read from the live file
+        CHECK(db.execute("CREATE TABLE late (n INTEGER);"));
+        CHECK(db.execute("INSERT INTO late (n) VALUES (7);"));
+        PreparedStatement late = db.prepareAnalytics("SELECT n FROM late;");
+        CHECK(late && late.step() && late.getInt64(0) == 7);
+        late.reset();
+
+        // Applying DDL refreshes the copy
+        uint64_t refreshes = db.snapshotReplica()->refreshCount();
+        CHECK(db.ensureSchema("replica_test", "CREATE TABLE IF NOT EXISTS added (n INTEGER);"));
+        CHECK(db.snapshotReplica()->refreshCount() == refreshes + 1);
+        CHECK(db.ensureSchema("replica_test", "CREATE TABLE IF NOT EXISTS added (n INTEGER);"));
+        CHECK(db.snapshotReplica()->refreshCount() == refreshes + 1);
+    }
+    removeDatabase("test_core_replica.db");
+}
+
+void testRowCache() {
+    removeDatabase("test_core_cache.db");
+    {
+        Database db("test_core_cache.db", 2);
+        CHECK(db.execute("CREATE TABLE people (name TEXT);"));
+        CHECK(db.execute("INSERT INTO people (rowid, name) VALUES (1, 'ada'), (2, 'bob');"));
+        db.cacheTable("people");
+        RowCache& cache = db.rowCache();
+
+        // First read misses and fills, the second is served from memory
+        CHECK(db.getRow("people", 1).at("name") == "ada");
+        CHECK(cache.misses() == 1 && cache.hits() == 0 && cache.size() == 1);
+        CHECK(db.getRow("people", 1).at("name") == "ada");
+        CHECK(cache.misses() == 1 && cache.hits() == 1);
+
+        // A committed UPDATE through the writer evicts the row
+        CHECK(db.execute("UPDATE people SET name = 'ada2' WHERE rowid = 1;"));
+        CHECK(cache.size() == 0 && cache.invalidations() >= 1);
+        CHECK(db.getRow("people", 1).at("name") == "ada2");
+        CHECK(cache.misses() == 2);
+
+        // Inside its own transaction a thread reads its pending change from
+        // disk; the cache keeps the committed row for everyone else
+        CHECK(db.getRow("people", 2).at("name") == "bob");
+        uint64_t invalidations = cache.invalidations();
+        CHECK(db.beginTransaction());
+        CHECK(db.execute("UPDATE people SET name = 'bob2' WHERE rowid = 2;"));
+        uint64_t hits = cache.hits();
+        CHECK(db.getRow("people", 2).at("name") == "bob2");
+        CHECK(cache.hits() == hits);
+        auto other = std::async(std::launch::async, [&db]() { return db.getRow("people", 2).at("name"); });
+        CHECK(other.get() == "bob");
+        CHECK(cache.hits() == hits + 1);
+
+        // Rolling back evicts nothing
+        CHECK(db.rollbackTransaction());
+        CHECK(cache.invalidations() == invalidations);
+        CHECK(db.getRow("people", 2).at("name") == "bob");
+        CHECK(cache.hits() == hits + 2);
+
+        // A committed DELETE evicts too
+        CHECK(db.execute("DELETE FROM people WHERE rowid = 2;"));
+        CHECK(cache.invalidations() > invalidations);
+        CHECK(db.getRow("people", 2).empty());
+    }
+    removeDatabase("test_core_cache.db");
+}
+
+void testTypedPartialUpdate() {
+    Database db(":memory:", 0);
+    CHECK(db.execute("DROP TABLE IF EXISTS sales_deals;"));
+    CHECK(db.execute("CREATE TABLE sales_deals (id INTEGER PRIMARY KEY, client_id INTEGER, deal_name TEXT, "
+                     "amount REAL, stage TEXT, probability REAL, expected_close_date TEXT, "
+                     "actual_close_date TEXT, sales_rep TEXT, updated_at TEXT);"));
+    CHECK(db.execute("INSERT INTO sales_deals (id, deal_name, probability) VALUES (1, NULL, 0.5);"));
+
+    // Only the assigned column is written; NULLs the record reads as "" or 0 stay NULL
+    std::optional<DealRecord> deal = TypedTable<DealRecord>::find(&db, 1);
+    CHECK(deal.has_value());
+    TypedTable<DealRecord>::ColumnSet changed = 0;
+    CHECK(TypedTable<DealRecord>::assign(*deal, "probability", "0.9", &changed));
+    CHECK(!TypedTable<DealRecord>::assign(*deal, "nonsense", "1", &changed));
+    CHECK(TypedTable<DealRecord>::update(&db, *deal, changed));
+    auto row = db.query("SELECT probability, deal_name IS NULL AS a, amount IS NULL AS b, stage IS NULL AS c, "
+                        "updated_at IS NOT NULL AS touched FROM sales_deals WHERE id = 1;");
+    CHECK(row.size() == 1 && row[0].at("probability") == "0.9");
+    CHECK(row[0].at("a") == "1" && row[0].at("b") == "1" && row[0].at("c") == "1" && row[0].at("touched") == "1");
+
+    // Nothing assigned still reports whether the row exists
+    CHECK(TypedTable<DealRecord>::update(&db, *deal, 0));
+    deal->id = 99;
+    CHECK(!TypedTable<DealRecord>::update(&db, *deal, changed));
+}
+
+int main() {
+    testWriteQueueBatches();
+    testWriteQueueReadYourWrites();
+    testSnapshotReplica();
+    testRowCache();
+    testTypedPartialUpdate();
+    testQuotedFields();
+    testLineEnds();
+    testStrayQuote();
+    testHeaderAndBom();
+    testChunkBoundaryInsideQuotes();
+    testUnfinishedRecord();
+    testScannerLevelsAgree();
+    testJsonFlattening();
+    testJsonNameCollisions();
+    testJsonErrors();
+    testZipInflate();
+    testZipCorruption();
+    testXlsxCells();
+    testTypeInference();
+    testSampledCsvInference();
+    testConvertOnWorkers();
+    testUpsertAcrossTypes();
+    testLiveSyncTailing();
+    testLiveSyncRestart();
+    testSketches();
+    testColumnProfiler();
+
+    if (failures) {
+        std::cerr << "❌ " << failures << " core check(s) failed\n";
+        return 1;
+    }
+    std::cout << "✅ Core tests passed\n";
+    return 0;
+}